@@ -0,0 +1,176 @@
+/*!
+ * @file bench_mpmc_queue.c
+ * @author Paulo Arruda
+ * @copyright GPL v3 or later.
+ * @brief Contention benchmark of the MPMC queue against a mutex protected ring.
+ * @note Usage: `bench_mpmc_queue.out [max threads per side] [messages]`. For
+ * 1, 2, 4, ... producers (and as many consumers) every producer pushes its
+ * share of the messages, in batches of `BATCH` for the batched runs, and the
+ * throughput in messages per second is printed.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "../include/mpmc_queue.h"
+
+#define CAPACITY 1024
+#define BATCH 32
+
+/**
+ * Baseline: a ring of `cds_size` guarded by a mutex and two condition
+ * variables.
+*/
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t not_full;
+    pthread_cond_t not_empty;
+    cds_size head;
+    cds_size tail;
+    cds_size data[CAPACITY];
+} LockedRing;
+
+static void lockedPush(LockedRing* ring, const cds_size value){
+    (void) pthread_mutex_lock(&ring->lock);
+    while (ring->tail - ring->head == CAPACITY){
+        (void) pthread_cond_wait(&ring->not_full, &ring->lock);
+    }
+    ring->data[ring->tail++ % CAPACITY] = value;
+    (void) pthread_cond_signal(&ring->not_empty);
+    (void) pthread_mutex_unlock(&ring->lock);
+}
+
+static cds_size lockedPop(LockedRing* ring){
+    (void) pthread_mutex_lock(&ring->lock);
+    while (ring->tail == ring->head){
+        (void) pthread_cond_wait(&ring->not_empty, &ring->lock);
+    }
+    cds_size value = ring->data[ring->head++ % CAPACITY];
+    (void) pthread_cond_signal(&ring->not_full);
+    (void) pthread_mutex_unlock(&ring->lock);
+    return value;
+}
+
+enum Mode{
+    LOCKED,
+    MPMC,
+    MPMC_BATCHED,
+};
+
+typedef struct {
+    enum Mode mode;
+    LockedRing* ring;
+    MPMCQueue* queue;
+    cds_size messages;      // per thread
+    atomic_size_t* checksum;
+} Job;
+
+static void* producer(void* arg){
+    Job* job = (Job*) arg;
+    cds_size batch[BATCH];
+    for (cds_size i=0; i<job->messages;){
+        switch (job->mode){
+            case LOCKED:
+                lockedPush(job->ring, ++i);
+                break;
+            case MPMC:
+                (void) mpmcqPush(job->queue, &(cds_size){++i});
+                break;
+            case MPMC_BATCHED:{
+                cds_size n = job->messages - i < BATCH ? job->messages - i : BATCH;
+                for (cds_size j=0; j<n; j++){
+                    batch[j] = ++i;
+                }
+                (void) mpmcqPushN(job->queue, batch, n);
+                break;
+            }
+        }
+    }
+    return NULL;
+}
+
+static void* consumer(void* arg){
+    Job* job = (Job*) arg;
+    cds_size batch[BATCH];
+    cds_size sum = 0;
+    for (cds_size i=0; i<job->messages;){
+        switch (job->mode){
+            case LOCKED:
+                sum += lockedPop(job->ring);
+                i++;
+                break;
+            case MPMC:
+                (void) mpmcqPop(job->queue, batch);
+                sum += batch[0];
+                i++;
+                break;
+            case MPMC_BATCHED:{
+                cds_size max = job->messages - i < BATCH ? job->messages - i : BATCH;
+                cds_size n = mpmcqPopN(job->queue, batch, max);
+                for (cds_size j=0; j<n; j++){
+                    sum += batch[j];
+                }
+                i += n;
+                break;
+            }
+        }
+    }
+    (void) atomic_fetch_add(job->checksum, sum);
+    return NULL;
+}
+
+static double seconds(void){
+    struct timespec now;
+    (void) clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double) now.tv_sec + 1e-9 * (double) now.tv_nsec;
+}
+
+static double run(const enum Mode mode, const cds_size threads, const cds_size messages){
+    LockedRing ring;
+    (void) pthread_mutex_init(&ring.lock, NULL);
+    (void) pthread_cond_init(&ring.not_full, NULL);
+    (void) pthread_cond_init(&ring.not_empty, NULL);
+    ring.head = ring.tail = 0;
+    atomic_size_t checksum;
+    atomic_init(&checksum, 0);
+    Job job = {mode, &ring, mpmcqCreate(CAPACITY, sizeof(cds_size)), messages / threads, &checksum};
+    pthread_t* workers = (pthread_t*) malloc(2*threads*sizeof(pthread_t));
+    if (!job.queue || !workers){
+        fprintf(stderr, "allocation failed\n");
+        exit(EXIT_FAILURE);
+    }
+    double start = seconds();
+    for (cds_size i=0; i<2*threads; i++){
+        (void) pthread_create(&workers[i], NULL, i % 2 ? consumer : producer, &job);
+    }
+    for (cds_size i=0; i<2*threads; i++){
+        (void) pthread_join(workers[i], NULL);
+    }
+    double elapsed = seconds() - start;
+    if (atomic_load(&checksum) != threads * job.messages * (job.messages + 1) / 2){
+        fprintf(stderr, "checksum mismatch\n");
+        exit(EXIT_FAILURE);
+    }
+    free(workers);
+    mpmcqDelete(job.queue);
+    (void) pthread_cond_destroy(&ring.not_empty);
+    (void) pthread_cond_destroy(&ring.not_full);
+    (void) pthread_mutex_destroy(&ring.lock);
+    return (double) (threads * job.messages) / elapsed;
+}
+
+int main(int argc, char** argv){
+    cds_size max_threads = argc > 1 ? strtoul(argv[1], NULL, 10) : 8;
+    cds_size messages = argc > 2 ? strtoul(argv[2], NULL, 10) : 4000000;
+    printf("%-10s %16s %16s %16s\n", "threads", "mutex (msg/s)", "mpmc (msg/s)", "mpmc batched");
+    for (cds_size threads=1; threads<=max_threads; threads*=2){
+        double locked = run(LOCKED, threads, messages);
+        double mpmc = run(MPMC, threads, messages);
+        double batched = run(MPMC_BATCHED, threads, messages);
+        printf("%zu+%-8zu %16.0f %16.0f %16.0f\n", threads, threads, locked, mpmc, batched);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,146 @@
+/*!
+ * @file bench_spsc_ring.c
+ * @author Paulo Arruda
+ * @copyright GPL v3 or later.
+ * @brief Throughput benchmark of the SPSC ring between two threads.
+ * @note Usage: `bench_spsc_ring.out [messages]`. Pin the process to two cores
+ * (e.g. with `taskset -c 0,2`) for stable numbers.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+#include "../include/spsc_ring.h"
+
+#define CAPACITY 4096
+#define BATCH 256
+
+enum Mode{
+    SINGLE,     // spscTryPush/spscTryPop
+    COPY,       // spscPushN/spscPopN
+    IN_PLACE,   // spscReserve/spscCommit and spscPeek/spscRelease
+};
+
+typedef struct {
+    enum Mode mode;
+    SPSCRing* ring;
+    cds_size messages;
+} Job;
+
+/**
+ * A side that finds the ring full (empty) yields, which matters only when both
+ * threads share a core.
+*/
+static void idle(const cds_size transferred){
+    if (!transferred){
+        (void) sched_yield();
+    }
+}
+
+static void* producer(void* arg){
+    Job* job = (Job*) arg;
+    cds_uint64 batch[BATCH];
+    for (cds_size i=0; i<job->messages;){
+        cds_size n = job->messages - i < BATCH ? job->messages - i : BATCH;
+        switch (job->mode){
+            case SINGLE:{
+                cds_bool pushed = spscTryPush(job->ring, &(cds_uint64){i});
+                i += pushed;
+                idle(pushed);
+                break;
+            }
+            case COPY:
+                for (cds_size j=0; j<n; j++){
+                    batch[j] = i + j;
+                }
+                n = spscPushN(job->ring, batch, n);
+                i += n;
+                idle(n);
+                break;
+            case IN_PLACE:{
+                cds_size granted;
+                cds_uint64* slots = (cds_uint64*) spscReserve(job->ring, n, &granted);
+                for (cds_size j=0; j<granted; j++){
+                    slots[j] = i + j;
+                }
+                spscCommit(job->ring, granted);
+                i += granted;
+                idle(granted);
+                break;
+            }
+        }
+    }
+    return NULL;
+}
+
+static cds_uint64 consume(Job* job){
+    cds_uint64 batch[BATCH];
+    cds_uint64 sum = 0;
+    for (cds_size i=0; i<job->messages;){
+        switch (job->mode){
+            case SINGLE:
+                if (spscTryPop(job->ring, batch)){
+                    sum += batch[0];
+                    i++;
+                }
+                else{
+                    idle(0);
+                }
+                break;
+            case COPY:{
+                cds_size n = spscPopN(job->ring, batch, BATCH);
+                for (cds_size j=0; j<n; j++){
+                    sum += batch[j];
+                }
+                i += n;
+                idle(n);
+                break;
+            }
+            case IN_PLACE:{
+                cds_size available;
+                const cds_uint64* elements = (const cds_uint64*) spscPeek(job->ring, BATCH, &available);
+                for (cds_size j=0; j<available; j++){
+                    sum += elements[j];
+                }
+                spscRelease(job->ring, available);
+                i += available;
+                idle(available);
+                break;
+            }
+        }
+    }
+    return sum;
+}
+
+static double seconds(void){
+    struct timespec now;
+    (void) clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double) now.tv_sec + 1e-9 * (double) now.tv_nsec;
+}
+
+int main(int argc, char** argv){
+    cds_size messages = argc > 1 ? strtoul(argv[1], NULL, 10) : 100000000;
+    const char* names[3] = {"single", "batched copy", "in place"};
+    for (enum Mode mode=SINGLE; mode<=IN_PLACE; mode++){
+        Job job = {mode, spscCreate(CAPACITY, sizeof(cds_uint64)), messages};
+        if (!job.ring){
+            fprintf(stderr, "allocation failed\n");
+            return EXIT_FAILURE;
+        }
+        pthread_t thread;
+        double start = seconds();
+        (void) pthread_create(&thread, NULL, producer, &job);
+        cds_uint64 sum = consume(&job);
+        (void) pthread_join(thread, NULL);
+        double elapsed = seconds() - start;
+        if (sum != (cds_uint64) messages * (messages - 1) / 2){
+            fprintf(stderr, "checksum mismatch\n");
+            return EXIT_FAILURE;
+        }
+        printf("%-14s %8.1f M msg/s\n", names[mode], 1e-6 * (double) messages / elapsed);
+        spscDelete(job.ring);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,31 @@
+/**
+ * @file vector_sort.c
+ * @author Paulo Arruda
+ * @copyright
+ * @brief Example of sorting a vector with a comparison function and with
+ * the numeric radix sort.
+*/
+#include <stdio.h>
+#include "../include/sort.h"
+
+int main(void){
+    Vector* v = vectorCreate(10, sizeof(cds_int));
+    for (cds_int i=0; i<10; i++){
+        (void) vectorPrepend(v, &(cds_int){(i*7) % 10 - 5});
+    }
+    (void) vectorSort(v, intOrderComp);
+    for (Iter* iter=iterCreate(v, VECTOR); iter; iter=iterNext(iter)){
+        printf("%d ", *(const cds_int*) iterGetData(iter));
+    }
+    printf("\n");
+    Vector* d = vectorFromValues(sizeof(cds_double), 4, &(cds_double){2.5}, &(cds_double){-1.0},
+                                 &(cds_double){0.5}, &(cds_double){-3.25});
+    (void) vectorSortNumeric(d, NUM_DOUBLE);
+    for (Iter* iter=iterCreate(d, VECTOR); iter; iter=iterNext(iter)){
+        printf("%.2f ", *(const cds_double*) iterGetData(iter));
+    }
+    printf("\n");
+    vectorDelete(d);
+    vectorDelete(v);
+    return 0;
+}
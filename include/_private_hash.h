@@ -31,6 +31,7 @@ struct HashTable{
     KeyType key_type;
     HashFunction hash_fun;
     HTEntry* container;
+    AllocOptions options;
 };
 /* Definition of the set entries **/
 typedef struct {
@@ -46,6 +47,7 @@ struct Set{
     size_t length;
     HashFunction hash_fun;
     SetEntry* container;
+    AllocOptions options;
 };
 
 #endif // _PRIVITE_HASH_H
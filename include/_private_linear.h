@@ -0,0 +1,118 @@
+/*!
+ * @file _private_linear.h
+ * @copyright GNU General Public Licence 3 or Later (GPLv3).
+ * @author Paulo Arruda
+ * @brief Explicit declaration of the structures used by the linear API.
+*/
+
+#include <stddef.h>
+#include "linear.h"
+#include "unrolled_list.h"
+
+#ifndef _PRIVATE_LINEAR_H
+#define _PRIVATE_LINEAR_H
+
+/**
+ * Where the buffer of a vector comes from, which determines how it grows and
+ * how it is released.
+*/
+enum VectorStorage{
+    VECTOR_STORAGE_HEAP,    // _cdsAlloc/_cdsRealloc/_cdsFree with the vector options
+    VECTOR_STORAGE_MMAP,    // anonymous mapping grown with mremap
+    VECTOR_STORAGE_FILE,    // shared file mapping grown with ftruncate + mremap
+};
+
+/**
+ * Definition of the vector structure.
+*/
+struct Vector{
+    cds_size length;
+    cds_size capacity;
+    cds_size data_size;
+    void* container;
+    enum VectorStorage storage;
+    AllocOptions options;
+    cds_bool read_only;
+    cds_int fd;             // file of VECTOR_STORAGE_FILE vectors
+};
+
+/**
+ * Whether the elements of the vector may be written: read only file vectors
+ * are mapped `PROT_READ`, so every function modifying a vector checks it.
+*/
+#define VECTOR_WRITABLE(vec) ((vec) && !(vec)->read_only)
+
+/**
+ * Where the buffer of a tuple comes from.
+*/
+enum TupleStorage{
+    TUPLE_STORAGE_INLINE,   // elements stored after the header, one allocation
+    TUPLE_STORAGE_ARENA,    // header and elements allocated from an arena
+    TUPLE_STORAGE_HEAP,     // owned buffer allocated with the tuple options
+    TUPLE_STORAGE_MMAP,     // anonymous mapping taken over from a large vector
+    TUPLE_STORAGE_FILE,     // read only file mapping
+    TUPLE_STORAGE_VIEW,     // buffer borrowed from a vector, never released
+};
+
+/**
+ * Definition of the tuple structure. `container` points to `data` for inline
+ * and arena tuples, so the getters do not depend on the storage. The storage
+ * and the allocation options of the buffer take a byte each, which keeps the
+ * header of inline tuples at 48 bytes instead of a whole cache line.
+*/
+struct Tuple{
+    cds_size length;
+    cds_size data_size;
+    const void* container;
+    cds_size buffer_size;   // bytes of the buffer, which may exceed the elements
+    cds_uchar storage;      // an `enum TupleStorage`
+    cds_uchar huge_pages;   // an `enum HugePageHint`
+    cds_uchar alignment;    // 1 + log2 of the alignment, 0 for no alignment
+    _Alignas(max_align_t) cds_uchar data[];
+};
+
+/**
+ * Definition of the nodes of the singly linked list. The data is stored inline
+ * after the link, which comes first so that a chain of nodes is also a chain of
+ * free pool objects (see `poolFreeChain`).
+*/
+typedef struct SLLNode{
+    struct SLLNode* next;
+    _Alignas(max_align_t) cds_uchar data[];
+}SLLNode;
+
+/**
+ * Definition of the singly linked list structure.
+*/
+struct SLList{
+    cds_size data_size;
+    cds_size length;
+    SLLNode* head;
+    SLLNode* tail;
+    Pool* pool;         // where the nodes are allocated
+    cds_bool owns_pool; // whether the pool is deleted with the list
+};
+
+/**
+ * Definition of the nodes of the unrolled list, which hold `count` elements
+ * packed at the beginning of `data`.
+*/
+typedef struct ULLNode{
+    struct ULLNode* next;
+    cds_size count;
+    _Alignas(max_align_t) cds_uchar data[];
+}ULLNode;
+
+/**
+ * Definition of the unrolled list structure.
+*/
+struct UnrolledList{
+    cds_size data_size;
+    cds_size length;
+    cds_size node_capacity; // elements per node
+    ULLNode* head;
+    ULLNode* tail;
+    Pool* pool;             // where the nodes are allocated
+};
+
+#endif // _PRIVATE_LINEAR_H
@@ -0,0 +1,91 @@
+/*!
+ * @file _private_memory.h
+ * @copyright GNU General Public Licence 3 or Later (GPLv3).
+ * @author Paulo Arruda
+ * @brief Memory mapping helpers used by the container buffers.
+*/
+
+#ifndef _PRIVATE_MEMORY_H
+#define _PRIVATE_MEMORY_H
+
+#include "common.h"
+
+/**
+ * @brief Rounds a number of bytes up to a multiple of the page size.
+*/
+cds_size _pageRound(const cds_size bytes);
+
+/**
+ * @brief Maps `bytes` bytes of anonymous memory.
+ * @note When `huge_pages` is set, transparent huge pages are requested with
+ * `madvise` (where available).
+ * @return A pointer to the mapping, or a `NULL` pointer if it failed.
+*/
+void* _mapAlloc(const cds_size bytes, const cds_bool huge_pages);
+
+/**
+ * @brief Resizes a mapping created by `_mapAlloc`.
+ * @note On Linux the pages are remapped with `mremap`, hence no data is copied.
+ * Elsewhere a new mapping is created and the data is copied.
+ * @return A pointer to the resized mapping, or a `NULL` pointer if it failed (in
+ * which case the old mapping is untouched).
+*/
+void* _mapRealloc(void* const ptr, const cds_size old_bytes, const cds_size new_bytes);
+
+/**
+ * @brief Unmaps a mapping created by `_mapAlloc`.
+*/
+void _mapFree(void* const ptr, const cds_size bytes);
+
+/**
+ * @brief Maps the first `bytes` bytes of the file `fd` as a shared mapping.
+ * @return A pointer to the mapping, or a `NULL` pointer if it failed.
+*/
+void* _mapFile(const cds_int fd, const cds_size bytes, const cds_bool writable);
+
+/**
+ * @brief Resizes the file `fd` to `new_bytes` and resizes its mapping.
+ * @note On Linux the mapping is resized with `mremap`; elsewhere the file is
+ * mapped again. In both cases nothing is copied since the pages belong to the
+ * file.
+ * @return A pointer to the resized mapping, or a `NULL` pointer if it failed.
+*/
+void* _mapFileResize(void* const ptr, const cds_int fd, const cds_size old_bytes,
+                     const cds_size new_bytes);
+
+/**
+ * @brief Flushes the changes of a file mapping to the file.
+*/
+cds_bool _mapSync(void* const ptr, const cds_size bytes);
+
+/**
+ * @brief Whether the allocation options are valid.
+*/
+cds_bool _allocOptionsValid(const AllocOptions* const options);
+
+/**
+ * @brief Allocates a buffer of `bytes` bytes according to the options.
+ * @note A `NULL` pointer for the options stands for a plain `malloc`.
+ * @return A pointer to the buffer, or a `NULL` pointer if it failed.
+*/
+void* _cdsAlloc(const cds_size bytes, const AllocOptions* const options);
+
+/**
+ * @brief Allocates a zeroed buffer of `bytes` bytes according to the options.
+*/
+void* _cdsCalloc(const cds_size bytes, const AllocOptions* const options);
+
+/**
+ * @brief Resizes a buffer allocated by `_cdsAlloc` with the same options.
+ * @return A pointer to the resized buffer, or a `NULL` pointer if it failed (in
+ * which case the old buffer is untouched).
+*/
+void* _cdsRealloc(void* const ptr, const cds_size old_bytes, const cds_size new_bytes,
+                  const AllocOptions* const options);
+
+/**
+ * @brief Releases a buffer allocated by `_cdsAlloc` with the same options.
+*/
+void _cdsFree(void* const ptr, const cds_size bytes, const AllocOptions* const options);
+
+#endif // _PRIVATE_MEMORY_H
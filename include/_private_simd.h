@@ -0,0 +1,75 @@
+/*!
+ * @file _private_simd.h
+ * @copyright GNU General Public Licence 3 or Later (GPLv3).
+ * @author Paulo Arruda
+ * @brief Preprocessor helpers for the SIMD kernels and their runtime dispatch.
+*/
+
+#ifndef _PRIVATE_SIMD_H
+#define _PRIVATE_SIMD_H
+
+#include "common.h"
+
+/**
+ * SSE2 is part of the x86-64 baseline, hence it is always available there.
+ * AVX2 kernels are compiled with the `target` attribute and selected at
+ * runtime.
+*/
+#if defined(__GNUC__) && defined(__x86_64__)
+    #include <immintrin.h>
+    #define __CDS_X86_SIMD__
+    #define CDS_TARGET_AVX2 __attribute__((target("avx2,popcnt,bmi")))
+    #define CDS_HAS_AVX2() (__builtin_cpu_supports("avx2"))
+#else
+    #define CDS_TARGET_AVX2
+    #define CDS_HAS_AVX2() (false)
+#endif // __GNUC__ && __x86_64__
+
+/**
+ * Plain loops that the compiler vectorizes on its own are cloned for AVX2
+ * and dispatched through an ifunc when the toolchain supports it.
+*/
+#if defined(__CDS_X86_SIMD__) && defined(__linux__) && !defined(__clang__)
+    #define CDS_TARGET_CLONES __attribute__((target_clones("avx2", "default")))
+#else
+    #define CDS_TARGET_CLONES
+#endif
+
+#ifdef __GNUC__
+    #define CDS_CTZ32(x) ((cds_size) __builtin_ctz(x))
+    #define CDS_CTZ64(x) ((cds_size) __builtin_ctzll(x))
+    #define CDS_CLZ64(x) ((cds_size) __builtin_clzll(x))
+    #define CDS_POPCOUNT32(x) ((cds_size) __builtin_popcount(x))
+    #define CDS_POPCOUNT64(x) ((cds_size) __builtin_popcountll(x))
+#else
+    static inline cds_size _cdsCtz64(uint64_t x){
+        cds_size n = 0;
+        while (!(x & 1)){
+            x >>= 1;
+            n++;
+        }
+        return n;
+    }
+    static inline cds_size _cdsClz64(uint64_t x){
+        cds_size n = 0;
+        while (!(x & ((uint64_t) 1 << 63))){
+            x <<= 1;
+            n++;
+        }
+        return n;
+    }
+    static inline cds_size _cdsPopcount64(uint64_t x){
+        cds_size n = 0;
+        for (; x; x &= x - 1){
+            n++;
+        }
+        return n;
+    }
+    #define CDS_CTZ32(x) _cdsCtz64(x)
+    #define CDS_CTZ64(x) _cdsCtz64(x)
+    #define CDS_CLZ64(x) _cdsClz64(x)
+    #define CDS_POPCOUNT32(x) _cdsPopcount64(x)
+    #define CDS_POPCOUNT64(x) _cdsPopcount64(x)
+#endif // __GNUC__
+
+#endif // _PRIVATE_SIMD_H
@@ -0,0 +1,50 @@
+/*!
+ * @file _private_sync.h
+ * @copyright GNU General Public Licence 3 or Later (GPLv3).
+ * @author Paulo Arruda
+ * @brief Helpers shared by the concurrent containers.
+*/
+
+#ifndef _PRIVATE_SYNC_H
+#define _PRIVATE_SYNC_H
+
+#include <sched.h>
+#include "common.h"
+
+/**
+ * Hint for the processor that the thread is spinning (`pause` on x86), which
+ * frees resources for the sibling hyperthread and avoids a memory order
+ * mis-speculation when the loop exits.
+*/
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #define CDS_CPU_RELAX() __builtin_ia32_pause()
+#elif defined(__GNUC__) && defined(__aarch64__)
+    #define CDS_CPU_RELAX() __asm__ __volatile__("yield")
+#else
+    #define CDS_CPU_RELAX() ((void) 0)
+#endif
+
+/**
+ * Number of failed attempts a blocking operation spins for before it yields
+ * the processor, and before it sleeps.
+*/
+#define CDS_SPIN_LIMIT 64
+#define CDS_YIELD_LIMIT 128
+
+/**
+ * Exponential backoff for contended retries: spins `1 << *round` times (up to
+ * `CDS_SPIN_LIMIT`), then yields the processor.
+*/
+static inline void _cdsBackoff(cds_size* const round){
+    if (*round < CDS_SPIN_LIMIT){
+        for (cds_size i=0; i<((cds_size) 1 << (*round < 6 ? *round : 6)); i++){
+            CDS_CPU_RELAX();
+        }
+    }
+    else{
+        (void) sched_yield();
+    }
+    (*round)++;
+}
+
+#endif // _PRIVATE_SYNC_H
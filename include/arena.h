@@ -0,0 +1,71 @@
+/*!
+ * @file arena.h
+ * @copyright GNU General Public Licence 3 or Later (GPLv3).
+ * @author Paulo Arruda
+ * @brief Header file containing the API for the arena (bump) allocator.
+ * @defgroup arena
+ * @{
+*/
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include "common.h"
+
+/*!
+ * @brief Opaque data type definition for the arena structure.
+ * @note An arena hands out memory from large blocks by bumping a pointer, and
+ * releases everything at once. It suits many short-lived objects of the same
+ * lifetime, which are then neither freed one by one nor fragment the heap.
+*/
+typedef struct Arena Arena;
+
+/*!
+ * @brief Constructor function for the arena structure.
+ * @param block_size The size in bytes of the blocks the memory is taken from.
+ * Requests larger than it get a block of their own.
+ * @return A pointer to a new arena if all memory allocations were successeful,
+ * or a `NULL` pointer otherwise.
+*/
+Arena* arenaCreate(const cds_size block_size);
+
+/*!
+ * @brief Destructor function for the arena structure, which releases every
+ * allocation made from it.
+ * @param arena A pointer to the arena.
+*/
+void arenaDelete(Arena* arena);
+
+/*!
+ * @brief Allocates memory from the arena.
+ * @note The memory is suitably aligned for any type and stays valid until the
+ * arena is reset or deleted.
+ * @param arena A pointer to the arena.
+ * @param bytes The number of bytes.
+ * @return A pointer to the memory, or a `NULL` pointer if the pointer to the
+ * arena is `NULL` or a new block could not be allocated.
+*/
+void* arenaAlloc(Arena* const arena, const cds_size bytes);
+
+/*!
+ * @brief Releases every allocation made from the arena at once.
+ * @note The first block is kept for the following allocations.
+ * @param arena A pointer to the arena.
+*/
+void arenaReset(Arena* const arena);
+
+/*!
+ * @brief Retrieves the number of bytes handed out by the arena.
+*/
+cds_size arenaUsed(const Arena* const arena);
+
+#endif // ARENA_H
+
+/*! @} */ // end of arena group.
+
+#ifdef __cplusplus
+};
+#endif // __cplusplus
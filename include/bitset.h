@@ -0,0 +1,217 @@
+/*!
+ * @file bitset.h
+ * @copyright GNU General Public Licence 3 or Later (GPLv3).
+ * @author Paulo Arruda
+ * @brief Header file containing the API for the dense bitset structure.
+ * @note Bits are packed in 64 bits words aligned to the cache line, which takes
+ * an eighth of the memory of a vector of `cds_bool`. Counting and the bulk
+ * operations between bitsets process whole words (four at a time with AVX2,
+ * selected at runtime on x86-64).
+ * @defgroup bitset
+ * @{
+*/
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#ifndef BITSET_H
+#define BITSET_H
+
+#include "common.h"
+#include "linear.h"
+
+/*!
+ * @brief Opaque data type definition for the bitset structure.
+*/
+typedef struct Bitset Bitset;
+
+/*!
+ * @brief Constructor function for the bitset structure.
+ * @param length The number of bits, all of them cleared.
+ * @return A pointer to a new bitset if all memory allocations were successeful,
+ * or a `NULL` pointer otherwise.
+*/
+Bitset* bitsetCreate(const cds_size length);
+
+/*!
+ * @brief Creates a bitset out of a vector of `cds_bool`.
+ * @param vec A pointer to the vector.
+ * @return A pointer to a new bitset whose bit `i` is set if the element `i` of
+ * the vector is `true`, or a `NULL` pointer if the data size of the vector is
+ * not `sizeof(cds_bool)` or the memory allocations failed.
+*/
+Bitset* bitsetFromVector(const Vector* const vec);
+
+/*!
+ * @brief Creates a copy of the bitset.
+ * @return A pointer to the copy, or a `NULL` pointer otherwise.
+*/
+Bitset* bitsetCopy(const Bitset* const bs);
+
+/*!
+ * @brief Destructor function for the bitset structure.
+ * @param bs A pointer to the bitset.
+*/
+void bitsetDelete(Bitset* bs);
+
+/*!
+ * @brief Retrieves the number of bits of the bitset.
+*/
+cds_size bitsetLength(const Bitset* const bs);
+
+/*!
+ * @brief Retrieves the number of bits the bitset can hold without expanding.
+*/
+cds_size bitsetCapacity(const Bitset* const bs);
+
+/*!
+ * @brief Expands the bitset so that it can hold at least `min_capacity` bits.
+ * @see `vectorReserve`.
+*/
+cds_bool bitsetReserve(Bitset* const bs, const cds_size min_capacity);
+
+/*!
+ * @brief Changes the number of bits of the bitset. New bits are cleared.
+ * @param bs A pointer to the bitset.
+ * @param length The new number of bits.
+ * @return `true` if the length was changed, or `false` if the pointer is `NULL`
+ * or the bitset could not be expanded.
+*/
+cds_bool bitsetResize(Bitset* const bs, const cds_size length);
+
+/*!
+ * @brief Appends a bit to the end of the bitset.
+ * @return `true` if the bit was appended, or `false` if the pointer is `NULL`
+ * or the bitset could not be expanded.
+*/
+cds_bool bitsetAppend(Bitset* const bs, const cds_bool bit);
+
+/*!
+ * @brief Sets the bit at `index`.
+ * @return `true` if the index is in range, or `false` otherwise.
+*/
+cds_bool bitsetSet(Bitset* const bs, const cds_size index);
+
+/*!
+ * @brief Clears the bit at `index`.
+ * @return `true` if the index is in range, or `false` otherwise.
+*/
+cds_bool bitsetClear(Bitset* const bs, const cds_size index);
+
+/*!
+ * @brief Flips the bit at `index`.
+ * @return `true` if the index is in range, or `false` otherwise.
+*/
+cds_bool bitsetFlip(Bitset* const bs, const cds_size index);
+
+/*!
+ * @brief Retrieves the bit at `index`.
+ * @return `true` if the bit is set, or `false` if it is cleared or the index is
+ * out of range.
+*/
+cds_bool bitsetTest(const Bitset* const bs, const cds_size index);
+
+/*!
+ * @brief Sets every bit of the bitset.
+*/
+void bitsetSetAll(Bitset* const bs);
+
+/*!
+ * @brief Clears every bit of the bitset.
+*/
+void bitsetClearAll(Bitset* const bs);
+
+/*!
+ * @brief Counts the set bits of the bitset.
+*/
+cds_size bitsetCount(const Bitset* const bs);
+
+/*!
+ * @brief Counts the set bits before `index`.
+ * @param bs A pointer to the bitset.
+ * @param index The index ending the range (not included); larger indices count
+ * the whole bitset.
+ * @return The number of set bits in [0, `index`).
+*/
+cds_size bitsetRank(const Bitset* const bs, const cds_size index);
+
+/*!
+ * @brief Retrieves the index of the set bit of a given rank.
+ * @param bs A pointer to the bitset.
+ * @param rank The number of set bits before the one searched (0 for the first).
+ * @return The index of the bit, or `CDS_NOT_FOUND` if there are not `rank + 1`
+ * set bits.
+*/
+cds_size bitsetSelect(const Bitset* const bs, const cds_size rank);
+
+/*!
+ * @brief Retrieves the index of the first set bit at or after `from`.
+ * @note Loops over the set bits read `for (i = bitsetNextSet(bs, 0); i != CDS_NOT_FOUND;
+ * i = bitsetNextSet(bs, i + 1))`.
+ * @return The index of the bit, or `CDS_NOT_FOUND` if there is none.
+*/
+cds_size bitsetNextSet(const Bitset* const bs, const cds_size from);
+
+/*!
+ * @brief Retrieves the index of the first cleared bit at or after `from`.
+ * @return The index of the bit, or `CDS_NOT_FOUND` if there is none.
+*/
+cds_size bitsetNextClear(const Bitset* const bs, const cds_size from);
+
+/*!
+ * @brief Computes `dst &= src`.
+ * @param dst A pointer to the destination bitset.
+ * @param src A pointer to the source bitset, of the length of `dst`.
+ * @return `true` if the operation was done, or `false` if a pointer is `NULL` or
+ * the lengths differ.
+*/
+cds_bool bitsetAnd(Bitset* const dst, const Bitset* const src);
+
+/*!
+ * @brief Computes `dst |= src`.
+ * @see `bitsetAnd`.
+*/
+cds_bool bitsetOr(Bitset* const dst, const Bitset* const src);
+
+/*!
+ * @brief Computes `dst ^= src`.
+ * @see `bitsetAnd`.
+*/
+cds_bool bitsetXor(Bitset* const dst, const Bitset* const src);
+
+/*!
+ * @brief Computes `dst &= ~src`, i.e. clears in `dst` the bits set in `src`.
+ * @see `bitsetAnd`.
+*/
+cds_bool bitsetAndNot(Bitset* const dst, const Bitset* const src);
+
+/*!
+ * @brief Flips every bit of the bitset.
+*/
+void bitsetNot(Bitset* const bs);
+
+/*!
+ * @brief Appends to a vector the indices of the set bits, in increasing order.
+ * @note The indices can be passed to `columnsGather` to select the rows of a
+ * mask.
+ * @param bs A pointer to the bitset.
+ * @param indices A pointer to a vector of `cds_size`.
+ * @return The number of indices appended, or `CDS_NOT_FOUND` if a pointer is
+ * `NULL`, the data size of the vector is not `sizeof(cds_size)` or it could not
+ * be expanded.
+*/
+cds_size bitsetToIndices(const Bitset* const bs, Vector* const indices);
+
+/*!
+ * @brief Retrieves the words of the bitset; bit `i` is bit `i % 64` of word `i / 64`.
+ * @note The bits after the length in the last word are always cleared.
+*/
+const uint64_t* bitsetWords(const Bitset* const bs);
+
+#endif // BITSET_H
+
+/*! @} */ // end of bitset group.
+
+#ifdef __cplusplus
+};
+#endif // __cplusplus
@@ -0,0 +1,141 @@
+/*!
+ * @file blocking_queue.h
+ * @copyright GNU General Public Licence 3 or Later (GPLv3).
+ * @author Paulo Arruda
+ * @brief Header file containing the API for the blocking producer/consumer
+ * queue.
+ * @note The queue is a ring of fixed-size elements guarded by a mutex, bounded
+ * or growing on demand. A thread finding the queue empty (or full) spins for a
+ * moment, then sleeps on a futex (a condition variable outside of Linux)
+ * until another thread changes the queue. Wakers skip the system call when no
+ * thread sleeps, and `bqueuePopBatch` moves every available element under a
+ * single acquisition of the lock, so a busy consumer pays one lock and at most
+ * one wake-up per batch instead of per element.
+ * @defgroup blocking_queue
+ * @{
+*/
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#ifndef BLOCKING_QUEUE_H
+#define BLOCKING_QUEUE_H
+
+#include "common.h"
+
+/*!
+ * @brief Timeout of the blocking operations that wait without limit.
+*/
+#define BQUEUE_FOREVER ((cds_long) -1)
+
+/*!
+ * @brief Initial number of elements of the unbounded queues.
+*/
+#define BQUEUE_DEFAULT_CAPACITY 64
+
+/*!
+ * @brief Opaque data type definition for the blocking queue structure.
+*/
+typedef struct BlockingQueue BlockingQueue;
+
+/*!
+ * @brief Constructor function for the blocking queue structure.
+ * @param capacity The maximum number of elements in the queue, or 0 for an
+ * unbounded queue, whose buffer doubles whenever it fills up.
+ * @param data_size The size of the elements.
+ * @return A pointer to a new empty queue if all memory allocations were
+ * successeful and `data_size` is positive, or a `NULL` pointer otherwise.
+*/
+BlockingQueue* bqueueCreate(const cds_size capacity, const cds_size data_size);
+
+/*!
+ * @brief Destructor function for the blocking queue structure.
+ * @note No thread may be using the queue; see `bqueueClose`.
+ * @param queue A pointer to the queue.
+*/
+void bqueueDelete(BlockingQueue* queue);
+
+/*!
+ * @brief Retrieves the maximum number of elements in the queue, 0 if it is
+ * unbounded.
+*/
+cds_size bqueueCapacity(const BlockingQueue* const queue);
+
+/*!
+ * @brief Retrieves the number of elements in the queue.
+ * @note The value is a snapshot, which may be stale when other threads use the
+ * queue.
+*/
+cds_size bqueueLength(const BlockingQueue* const queue);
+
+/*!
+ * @brief Closes the queue: pushes fail from then on, pops drain the elements
+ * left and then fail instead of waiting, and every waiting thread wakes up.
+ * @param queue A pointer to the queue.
+*/
+void bqueueClose(BlockingQueue* const queue);
+
+/*!
+ * @brief Whether the queue was closed.
+*/
+cds_bool bqueueIsClosed(const BlockingQueue* const queue);
+
+/*!
+ * @brief Adds a copy of `data` to the queue, waiting while it is full.
+ * @param queue A pointer to the queue.
+ * @param data A pointer to the data.
+ * @param timeout The maximum time to wait in milliseconds: 0 does not wait and
+ * `BQUEUE_FOREVER` waits without limit.
+ * @return `true` if the element was added, or `false` if the time ran out, the
+ * queue is closed, the buffer of an unbounded queue could not grow or a pointer
+ * is `NULL`.
+*/
+cds_bool bqueuePush(BlockingQueue* const queue, const void* const data, const cds_long timeout);
+
+/*!
+ * @brief Adds copies of the `count` elements of the array `data` to the queue,
+ * in order, waiting for free space while the queue is full.
+ * @note Each time the lock is acquired as many elements as fit are added.
+ * @param queue A pointer to the queue.
+ * @param data A pointer to an array of `count` elements.
+ * @param count The number of elements.
+ * @param timeout The maximum time to wait in milliseconds for the whole array.
+ * @return The number of (leading) elements of `data` added.
+ * @see `bqueuePush`.
+*/
+cds_size bqueuePushN(BlockingQueue* const queue, const void* const data, const cds_size count,
+                     const cds_long timeout);
+
+/*!
+ * @brief Removes the oldest element of the queue, waiting while it is empty.
+ * @param queue A pointer to the queue.
+ * @param[out] out A pointer to where the element is copied.
+ * @param timeout The maximum time to wait in milliseconds: 0 does not wait and
+ * `BQUEUE_FOREVER` waits without limit.
+ * @return `true` if an element was removed, or `false` if the time ran out, the
+ * queue is closed and empty or a pointer is `NULL`.
+*/
+cds_bool bqueuePop(BlockingQueue* const queue, void* const out, const cds_long timeout);
+
+/*!
+ * @brief Removes every element available, up to `max`, with a single
+ * acquisition of the lock, waiting only while the queue is empty.
+ * @param queue A pointer to the queue.
+ * @param[out] out A pointer to an array of at least `max` elements, where the
+ * elements are copied from the oldest to the newest.
+ * @param max The maximum number of elements to remove.
+ * @param timeout The maximum time to wait in milliseconds: 0 does not wait and
+ * `BQUEUE_FOREVER` waits without limit.
+ * @return The number of elements removed, 0 if the time ran out, the queue is
+ * closed and empty or a pointer is `NULL`.
+*/
+cds_size bqueuePopBatch(BlockingQueue* const queue, void* const out, const cds_size max,
+                        const cds_long timeout);
+
+#endif // BLOCKING_QUEUE_H
+
+/*! @} */ // end of blocking_queue group.
+
+#ifdef __cplusplus
+};
+#endif // __cplusplus
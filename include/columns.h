@@ -0,0 +1,152 @@
+/*!
+ * @file columns.h
+ * @copyright GNU General Public Licence 3 or Later (GPLv3).
+ * @author Paulo Arruda
+ * @brief Header file containing the API for the columnar (struct of arrays)
+ * container.
+ * @note A columns container stores every field of its rows in a vector of its
+ * own, aligned to the cache line, so a scan over a few fields reads only the
+ * memory of those fields. The columns are plain vectors, hence the kernels of
+ * `kernels.h` and the parallel operations of `parallel.h` run on them directly.
+ * @defgroup columns
+ * @{
+*/
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#ifndef COLUMNS_H
+#define COLUMNS_H
+
+#include "common.h"
+#include "linear.h"
+
+/*!
+ * @brief Opaque data type definition for the columns structure.
+*/
+typedef struct Columns Columns;
+
+/*!
+ * @brief Constructor function for the columns structure.
+ * @param min_capacity The minimal number of rows the columns can hold.
+ * @param num_columns The number of columns.
+ * @param column_sizes The data size of every column.
+ * @return A pointer to a new empty columns container if all memory allocations
+ * were successeful and every size is positive, or a `NULL` pointer otherwise.
+*/
+Columns* columnsCreate(const cds_size min_capacity, const cds_size num_columns,
+                       const cds_size* const column_sizes);
+
+/*!
+ * @brief Destructor function for the columns structure.
+ * @param cols A pointer to the columns container.
+*/
+void columnsDelete(Columns* cols);
+
+/*!
+ * @brief Expands every column so that it can hold at least `min_capacity` rows.
+ * @see `vectorReserve`.
+*/
+cds_bool columnsReserve(Columns* const cols, const cds_size min_capacity);
+
+/*!
+ * @brief Appends a row to the columns.
+ * @param cols A pointer to the columns container.
+ * @param fields An array with a pointer to the value of every column.
+ * @return `true` if the row was appended, or `false` if a pointer is `NULL` or
+ * a column could not be expanded (in which case no column is modified).
+*/
+cds_bool columnsAppendRow(Columns* const cols, const void* const* const fields);
+
+/*!
+ * @brief Appends an array of records (array of structures) to the columns,
+ * splitting every record into its fields.
+ * @note Every column is filled in one pass over the records.
+ * @param cols A pointer to the columns container.
+ * @param records A pointer to the first record.
+ * @param num_records The number of records.
+ * @param record_size The size of each record (e.g. `sizeof(struct Row)`).
+ * @param offsets The offset of every column inside the records (e.g.
+ * `offsetof(struct Row, field)`).
+ * @return `true` if the records were appended, or `false` if a pointer is `NULL`,
+ * a field exceeds the record or a column could not be expanded.
+*/
+cds_bool columnsAppendRecords(Columns* const cols, const void* const records,
+                              const cds_size num_records, const cds_size record_size,
+                              const cds_size* const offsets);
+
+/*!
+ * @brief Copies the fields of a row.
+ * @param cols A pointer to the columns container.
+ * @param row The index of the row.
+ * @param[out] fields An array with a pointer to where every field is written
+ * (`NULL` entries are skipped).
+ * @return `true` if the row was copied, or `false` if the index is out of range
+ * or a pointer is `NULL`.
+*/
+cds_bool columnsGetRow(const Columns* const cols, const cds_size row, void* const* const fields);
+
+/*!
+ * @brief Retrieves the number of rows.
+*/
+cds_size columnsLength(const Columns* const cols);
+
+/*!
+ * @brief Retrieves the number of columns.
+*/
+cds_size columnsNumColumns(const Columns* const cols);
+
+/*!
+ * @brief Retrieves a column as a vector.
+ * @note The vector belongs to the columns container: its elements may be
+ * modified, but its length must not be changed.
+ * @param cols A pointer to the columns container.
+ * @param column The index of the column.
+ * @return A pointer to the vector, or a `NULL` pointer if the index is out of
+ * range.
+*/
+Vector* columnsColumn(const Columns* const cols, const cds_size column);
+
+/*!
+ * @brief Retrieves the contiguous buffer of a column, aligned to
+ * `CDS_CACHE_LINE` bytes.
+ * @note The pointer is invalidated whenever the columns expand.
+ * @return A pointer to the first element of the column, or a `NULL` pointer if
+ * the index is out of range.
+*/
+void* columnsData(const Columns* const cols, const cds_size column);
+
+/*!
+ * @brief Retrieves a slice over the rows [`start`, `start + length`) of a
+ * column.
+ * @see `vectorSlice`.
+*/
+VectorSlice columnsSlice(const Columns* const cols, const cds_size column, const cds_size start,
+                         const cds_size length);
+
+/*!
+ * @brief Creates a columns container with the rows of `cols` at the given
+ * indices, in the order of the indices.
+ * @note Every column is gathered in one pass over the indices.
+ * @param cols A pointer to the columns container.
+ * @param indices A pointer to a vector of `cds_size` row indices, which may
+ * repeat.
+ * @return A pointer to a new columns container, or a `NULL` pointer if an index
+ * is out of range, the data size of `indices` is not `sizeof(cds_size)` or the
+ * memory allocations failed.
+*/
+Columns* columnsGather(const Columns* const cols, const Vector* const indices);
+
+/*!
+ * @brief Typed access to the buffer of a column: `COLUMN_DATA(cols, cds_float, 2)[i]`.
+ * @note `type` must have the data size of the column.
+*/
+#define COLUMN_DATA(cols, type, column) ((type*) columnsData(cols, column))
+
+#endif // COLUMNS_H
+
+/*! @} */ // end of columns group.
+
+#ifdef __cplusplus
+};
+#endif // __cplusplus
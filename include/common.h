@@ -75,6 +75,60 @@ typedef float           cds_float;
 typedef double          cds_double;
 typedef long double     cds_ldouble;
 
+/**
+ * @brief Numeric element types understood by the type specialised algorithms
+ * (radix sorting, reductions, etc.).
+ *
+ * The size of the type must match the `data_size` of the container it is
+ * used with.
+*/
+enum NumericType{
+    NUM_INT8,
+    NUM_UINT8,
+    NUM_INT16,
+    NUM_UINT16,
+    NUM_INT32,
+    NUM_UINT32,
+    NUM_INT64,
+    NUM_UINT64,
+    NUM_FLOAT,
+    NUM_DOUBLE,
+};
+
+cds_size _numericSize(const enum NumericType type);
+
+/**
+ * @brief Huge page hints for the buffers of the containers.
+*/
+enum HugePageHint{
+    HUGE_PAGES_NONE,
+    HUGE_PAGES_TRANSPARENT,     // anonymous mapping advised with MADV_HUGEPAGE
+    HUGE_PAGES_EXPLICIT,        // 2 MiB MAP_HUGETLB pages, falling back to transparent huge pages
+};
+
+/**
+ * @brief Allocation options for the buffers of the containers.
+ * @note `alignment` must be 0 (the `malloc` alignment) or a power of 2. Buffers
+ * using huge pages are page aligned, hence their alignment cannot exceed the
+ * page size.
+*/
+typedef struct AllocOptions{
+    cds_size alignment;
+    enum HugePageHint huge_pages;
+}AllocOptions;
+
+/**
+ * @brief Index returned by the searching functions when no element is found.
+*/
+#define CDS_NOT_FOUND ((cds_size) -1)
+
+/**
+ * @brief Size in bytes of the cache lines, used to keep the data of different
+ * threads apart.
+*/
+#ifndef CDS_CACHE_LINE
+#define CDS_CACHE_LINE 64
+#endif // CDS_CACHE_LINE
 
 #define CDS_BYTE_OFFSET(ptr, nbytes) ((void*) (((cds_byte*) ptr) + nbytes))
 
@@ -133,6 +187,8 @@ const void* _dataDup(const void* const data, const cds_size data_size);
 
 const char* _strDup(const cds_char* string);
 
+cds_size _numThreads(void);
+
 
 #endif //COMMON_H
 
@@ -0,0 +1,91 @@
+/*!
+ * @file concurrent_stack.h
+ * @copyright GNU General Public Licence 3 or Later (GPLv3).
+ * @author Paulo Arruda
+ * @brief Header file containing the API for the lock-free (Treiber) stack.
+ * @note The stack stores copies of its elements in nodes taken from a pool
+ * allocated up front, which is itself a lock-free stack of free nodes. Nodes
+ * are referenced by index, and both tops pair the index with a counter bumped
+ * by every update, so a compare-and-swap fails if the top was popped and pushed
+ * back in between (the ABA problem) without hazard pointers or garbage
+ * collection.
+ *
+ * Under contention a failed push (pop) visits an elimination array, where it
+ * can meet a concurrent pop (push) and hand its node over without touching the
+ * top of the stack.
+ * @defgroup concurrent_stack
+ * @{
+*/
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#ifndef CONCURRENT_STACK_H
+#define CONCURRENT_STACK_H
+
+#include "common.h"
+
+/*!
+ * @brief Number of slots of the elimination array.
+*/
+#define CSTACK_ELIMINATION_SLOTS 8
+
+/*!
+ * @brief Opaque data type definition for the concurrent stack structure.
+*/
+typedef struct ConcurrentStack ConcurrentStack;
+
+/*!
+ * @brief Constructor function for the concurrent stack structure.
+ * @param capacity The number of elements the stack holds (less than
+ * `UINT32_MAX`).
+ * @param data_size The size of the elements.
+ * @return A pointer to a new empty stack if all memory allocations were
+ * successeful and the parameters are valid, or a `NULL` pointer otherwise.
+*/
+ConcurrentStack* cstackCreate(const cds_size capacity, const cds_size data_size);
+
+/*!
+ * @brief Destructor function for the concurrent stack structure.
+ * @note No thread may be using the stack.
+ * @param stack A pointer to the stack.
+*/
+void cstackDelete(ConcurrentStack* stack);
+
+/*!
+ * @brief Retrieves the number of elements the stack holds.
+*/
+cds_size cstackCapacity(const ConcurrentStack* const stack);
+
+/*!
+ * @brief Whether the stack is empty.
+ * @note The value is a snapshot, which may be stale when other threads use the
+ * stack.
+*/
+cds_bool cstackIsEmpty(const ConcurrentStack* const stack);
+
+/*!
+ * @brief Pushes a copy of `data` onto the stack.
+ * @param stack A pointer to the stack.
+ * @param data A pointer to the data.
+ * @return `true` if the element was pushed, or `false` if the stack is full or
+ * a pointer is `NULL`.
+*/
+cds_bool cstackPush(ConcurrentStack* const stack, const void* const data);
+
+/*!
+ * @brief Pops the element on top of the stack.
+ * @param stack A pointer to the stack.
+ * @param[out] out A pointer to where the element is copied.
+ * @return `true` if an element was popped, or `false` if the stack is empty or
+ * a pointer is `NULL`.
+*/
+cds_bool cstackPop(ConcurrentStack* const stack, void* const out);
+
+#endif // CONCURRENT_STACK_H
+
+/*! @} */ // end of concurrent_stack group.
+
+#ifdef __cplusplus
+};
+#endif // __cplusplus
@@ -0,0 +1,226 @@
+/*!
+ * @file flat_map.h
+ * @copyright GNU General Public Licence 3 or Later (GPLv3).
+ * @author Paulo Arruda
+ * @brief Header file containing the API for the sorted flat map and set.
+ * @note Flat maps keep their keys sorted in one vector and their values, at
+ * the same indices, in another one. Lookups are binary searches over the
+ * contiguous keys, and the only memory besides the keys and the values is the
+ * spare capacity of the vectors, which `flatmapShrinkToFit` releases (maps
+ * built in bulk are created without it). Insertions and removals shift the
+ * elements after them, so flat maps suit read-mostly data.
+ * @defgroup flat_map
+ * @{
+*/
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#ifndef FLAT_MAP_H
+#define FLAT_MAP_H
+
+#include "common.h"
+#include "comparison_functions.h"
+#include "linear.h"
+
+/*!
+ * @brief Opaque data type definition for the flat map structure.
+*/
+typedef struct FlatMap FlatMap;
+
+/*!
+ * @brief Opaque data type definition for the flat set structure, a flat map
+ * without values.
+*/
+typedef struct FlatSet FlatSet;
+
+/*!
+ * @brief Constructor function for the flat map structure.
+ * @param key_size The size of the keys.
+ * @param value_size The size of the values.
+ * @param compare The trichotomous comparison function of the keys.
+ * @return A pointer to a new empty flat map if all memory allocations were
+ * successeful, or a `NULL` pointer otherwise.
+*/
+FlatMap* flatmapCreate(const cds_size key_size, const cds_size value_size,
+                       const TComparisonFun compare);
+
+/*!
+ * @brief Builds a flat map out of unsorted keys and their values.
+ * @note The keys are sorted together with their values and duplicated keys are
+ * merged, keeping the value that comes last in `values` (as if the pairs were
+ * inserted one after the other).
+ * @param keys A pointer to the vector of keys.
+ * @param values A pointer to the vector of values, with the length of `keys`.
+ * @param compare The trichotomous comparison function of the keys.
+ * @return A pointer to a new flat map if all memory allocations were
+ * successeful and the vectors have the same length, or a `NULL` pointer
+ * otherwise.
+*/
+FlatMap* flatmapFromVectors(const Vector* const keys, const Vector* const values,
+                            const TComparisonFun compare);
+
+/*!
+ * @brief Destructor function for the flat map structure.
+ * @param map A pointer to the flat map.
+*/
+void flatmapDelete(FlatMap* map);
+
+/*!
+ * @brief Inserts a key and its value, or updates the value of a key already
+ * stored.
+ * @param map A pointer to the flat map.
+ * @param key A pointer to the key.
+ * @param value A pointer to the value.
+ * @return `true` if the pair was stored, or `false` if a pointer is `NULL` or
+ * the flat map could not be expanded.
+*/
+cds_bool flatmapInsert(FlatMap* const map, const void* const key, const void* const value);
+
+/*!
+ * @brief Retrieves the value of a key.
+ * @param map A pointer to the flat map.
+ * @param key A pointer to the key.
+ * @return A pointer to the value, which stays valid until the next insertion or
+ * removal, or a `NULL` pointer if the key is not stored.
+*/
+void* flatmapGet(const FlatMap* const map, const void* const key);
+
+/*!
+ * @brief Checks whether a key is stored in the flat map.
+*/
+cds_bool flatmapContains(const FlatMap* const map, const void* const key);
+
+/*!
+ * @brief Removes a key and its value.
+ * @param map A pointer to the flat map.
+ * @param key A pointer to the key.
+ * @return `true` if the key was removed, or `false` if it was not stored.
+*/
+cds_bool flatmapRemove(FlatMap* const map, const void* const key);
+
+/*!
+ * @brief Retrieves the number of keys of the flat map.
+*/
+cds_size flatmapLength(const FlatMap* const map);
+
+/*!
+ * @brief Retrieves the index of the first key that is not less than `key`.
+ * @return The index, which is the length of the flat map if every key is less
+ * than `key`.
+*/
+cds_size flatmapLowerBound(const FlatMap* const map, const void* const key);
+
+/*!
+ * @brief Retrieves the index of the first key that is greater than `key`.
+ * @return The index, which is the length of the flat map if no key is greater
+ * than `key`.
+*/
+cds_size flatmapUpperBound(const FlatMap* const map, const void* const key);
+
+/*!
+ * @brief Retrieves the key stored at an index, in increasing order of keys.
+ * @return A pointer to the key, or a `NULL` pointer if the index is out of range.
+*/
+const void* flatmapKeyAt(const FlatMap* const map, const cds_size index);
+
+/*!
+ * @brief Retrieves the value stored at an index, in increasing order of keys.
+ * @return A pointer to the value, or a `NULL` pointer if the index is out of
+ * range.
+*/
+void* flatmapValueAt(const FlatMap* const map, const cds_size index);
+
+/*!
+ * @brief Retrieves the keys in the range [`low`, `high`) and their values.
+ * @note The slices point into the flat map, so they are invalidated by the next
+ * insertion or removal.
+ * @param map A pointer to the flat map.
+ * @param low A pointer to the lowest key of the range, or `NULL` for no lower
+ * bound.
+ * @param high A pointer to the key ending the range (not included), or `NULL`
+ * for no upper bound.
+ * @param[out] keys A pointer to where the slice of the keys is written, or `NULL`.
+ * @param[out] values A pointer to where the slice of the values is written, or
+ * `NULL`.
+ * @return The number of keys in the range.
+*/
+cds_size flatmapRange(const FlatMap* const map, const void* const low, const void* const high,
+                      VectorSlice* const keys, VectorSlice* const values);
+
+/*!
+ * @brief Releases the spare capacity of the flat map.
+ * @return `true` if the flat map holds no spare capacity, or `false` otherwise.
+*/
+cds_bool flatmapShrinkToFit(FlatMap* const map);
+
+/*!
+ * @brief Constructor function for the flat set structure.
+ * @see `flatmapCreate`.
+*/
+FlatSet* flatsetCreate(const cds_size key_size, const TComparisonFun compare);
+
+/*!
+ * @brief Builds a flat set out of unsorted, possibly repeated, keys.
+ * @see `flatmapFromVectors`.
+*/
+FlatSet* flatsetFromVector(const Vector* const keys, const TComparisonFun compare);
+
+/*!
+ * @brief Destructor function for the flat set structure.
+*/
+void flatsetDelete(FlatSet* set);
+
+/*!
+ * @brief Inserts a key in the flat set.
+ * @return `true` if the key is stored, or `false` if a pointer is `NULL` or the
+ * flat set could not be expanded.
+*/
+cds_bool flatsetInsert(FlatSet* const set, const void* const key);
+
+/*!
+ * @brief Checks whether a key is stored in the flat set.
+*/
+cds_bool flatsetContains(const FlatSet* const set, const void* const key);
+
+/*!
+ * @brief Removes a key from the flat set.
+ * @return `true` if the key was removed, or `false` if it was not stored.
+*/
+cds_bool flatsetRemove(FlatSet* const set, const void* const key);
+
+/*!
+ * @brief Retrieves the number of keys of the flat set.
+*/
+cds_size flatsetLength(const FlatSet* const set);
+
+/*!
+ * @brief Retrieves the index of the first key that is not less than `key`.
+ * @see `flatmapLowerBound`.
+*/
+cds_size flatsetLowerBound(const FlatSet* const set, const void* const key);
+
+/*!
+ * @brief Retrieves the key stored at an index, in increasing order.
+*/
+const void* flatsetKeyAt(const FlatSet* const set, const cds_size index);
+
+/*!
+ * @brief Retrieves the keys in the range [`low`, `high`).
+ * @see `flatmapRange`.
+*/
+cds_size flatsetRange(const FlatSet* const set, const void* const low, const void* const high,
+                      VectorSlice* const keys);
+
+/*!
+ * @brief Releases the spare capacity of the flat set.
+*/
+cds_bool flatsetShrinkToFit(FlatSet* const set);
+
+#endif // FLAT_MAP_H
+
+/*! @} */ // end of flat_map group.
+
+#ifdef __cplusplus
+};
+#endif // __cplusplus
@@ -102,6 +102,20 @@ typedef struct Set Set;
 */
 Set* setCreate(const cds_size min_capacity, const HashFunction hash_fun, const KeyType key_type);
 
+/**
+ * @brief Creator function for the set structure with allocation options.
+ * @note The options apply to the entries of the set, also when it expands.
+ * @param min_capacity
+ * @param hash_fun
+ * @param key_type
+ * @param options A pointer to the allocation options (`NULL` for the defaults).
+ * @return A pointer to new empty set, if memory allocations were successeful and
+ * the options are valid, or a NULL pointer otherwise.
+ * @see `setCreate`
+*/
+Set* setCreateWithOptions(const cds_size min_capacity, const HashFunction hash_fun,
+                          const KeyType key_type, const AllocOptions* const options);
+
 /**
  * @brief deleting function for the set structure.
  *
@@ -160,6 +174,22 @@ typedef struct HashTable HashTable;
 HashTable* htCreate(const HashFunction hash_fun, const cds_size min_capacity, 
                     const KeyType key_type);
 
+/*!
+ * @brief Constructor function for the hash table structure with allocation
+ * options.
+ * @note The options apply to the entries of the table, also when it expands.
+ * Huge pages reduce the TLB misses of the random accesses to large tables.
+ * @param hash_fun A function pointer to the hashing function.
+ * @param min_capacity The minimum capacity that the hash table should have.
+ * @param key_type Indicates the type of the key.
+ * @param options A pointer to the allocation options (`NULL` for the defaults).
+ * @returns A pointer for a new hash table if all memory allocations were successeful
+ * and the options are valid, or a `NULL` pointer otherwise.
+ * @see `htCreate`.
+*/
+HashTable* htCreateWithOptions(const HashFunction hash_fun, const cds_size min_capacity,
+                               const KeyType key_type, const AllocOptions* const options);
+
 /*!
  * @brief Destructor function for the hash table structure.
  * @param ht A pointer to the hash table.
@@ -0,0 +1,394 @@
+/*!
+ * @file intrusive.h
+ * @copyright GNU General Public Licence 3 or Later (GPLv3).
+ * @author Paulo Arruda
+ * @brief Header-only intrusive singly linked lists, doubly linked lists and
+ * hash bucket chains.
+ * @note The links are embedded in the user's own structures, and the structure
+ * owning a link is recovered with `CDS_CONTAINER_OF`. The lists never allocate
+ * nor copy anything: linking and unlinking only rewrite pointers, and a
+ * structure embedding several links sits on several lists at once. The
+ * structures must outlive their membership in the lists.
+ * @defgroup intrusive
+ * @{
+*/
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#ifndef INTRUSIVE_H
+#define INTRUSIVE_H
+
+#include <stddef.h>
+#include "common.h"
+
+/*!
+ * @brief Retrieves a pointer to the structure of type `type` whose member
+ * `member` is pointed to by `ptr`.
+*/
+#define CDS_CONTAINER_OF(ptr, type, member) \
+    ((type*) (void*) ((cds_byte*) (ptr) - offsetof(type, member)))
+
+/**
+ * SINGLY LINKED LISTS
+ * -------------------
+*/
+
+/*!
+ * @brief Link of an intrusive singly linked list.
+*/
+typedef struct ISLink{
+    struct ISLink* next;
+}ISLink;
+
+/*!
+ * @brief Intrusive singly linked list, a stack of links.
+*/
+typedef struct ISList{
+    ISLink* first;
+}ISList;
+
+/*!
+ * @brief Initializer of an empty singly linked list.
+*/
+#define ISLIST_INIT {(ISLink*) NULL}
+
+/*!
+ * @brief Iterates `pos` (an `ISLink*`) over the links of `list` (an
+ * `ISList*`).
+ * @note The link `pos` must not be unlinked in the body of the loop.
+*/
+#define ISLIST_FOR_EACH(pos, list) \
+    for ((pos)=(list)->first; (pos); (pos)=(pos)->next)
+
+/*!
+ * @brief Initializes an empty singly linked list.
+*/
+static inline void islistInit(ISList* const list){
+    list->first = (ISLink*) NULL;
+}
+
+/*!
+ * @brief Whether the singly linked list is empty.
+*/
+static inline cds_bool islistIsEmpty(const ISList* const list){
+    return !list->first;
+}
+
+/*!
+ * @brief Links `link` at the front of the list in constant time.
+*/
+static inline void islistPush(ISList* const list, ISLink* const link){
+    link->next = list->first;
+    list->first = link;
+}
+
+/*!
+ * @brief Unlinks the first link of the list in constant time.
+ * @return The link unlinked, or a `NULL` pointer if the list is empty.
+*/
+static inline ISLink* islistPop(ISList* const list){
+    ISLink* link = list->first;
+    if (link){
+        list->first = link->next;
+        link->next = (ISLink*) NULL;
+    }
+    return link;
+}
+
+/*!
+ * @brief Links `link` right after `pos`, which is on a list.
+*/
+static inline void islistInsertAfter(ISLink* const pos, ISLink* const link){
+    link->next = pos->next;
+    pos->next = link;
+}
+
+/*!
+ * @brief Unlinks `link` from the list.
+ * @note The list is walked up to `link`, so the time is linear; use a doubly
+ * linked list when arbitrary links are unlinked often.
+ * @return `true` if `link` was on the list, `false` otherwise.
+*/
+static inline cds_bool islistRemove(ISList* const list, ISLink* const link){
+    for (ISLink** pnext=&list->first; *pnext; pnext=&(*pnext)->next){
+        if (*pnext == link){
+            *pnext = link->next;
+            link->next = (ISLink*) NULL;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * DOUBLY LINKED LISTS
+ * -------------------
+*/
+
+/*!
+ * @brief Link of an intrusive doubly linked list.
+ * @note The lists are circular around a head link that belongs to no
+ * structure, so no operation tests for the ends of the list. An unlinked link
+ * points to itself.
+*/
+typedef struct IDLink{
+    struct IDLink* next;
+    struct IDLink* prev;
+}IDLink;
+
+/*!
+ * @brief Initializer of the empty list (or unlinked link) `name`, e.g.
+ * `IDLink list = IDLIST_INIT(list);`.
+*/
+#define IDLIST_INIT(name) {&(name), &(name)}
+
+/*!
+ * @brief Iterates `pos` (an `IDLink*`) over the links of the list whose head is
+ * `head`, from the front to the back.
+ * @note The link `pos` must not be unlinked in the body of the loop; see
+ * `IDLIST_FOR_EACH_SAFE`.
+*/
+#define IDLIST_FOR_EACH(pos, head) \
+    for ((pos)=(head)->next; (pos) != (head); (pos)=(pos)->next)
+
+/*!
+ * @brief Iterates `pos` over the links of the list whose head is `head`, from
+ * the back to the front.
+*/
+#define IDLIST_FOR_EACH_REVERSE(pos, head) \
+    for ((pos)=(head)->prev; (pos) != (head); (pos)=(pos)->prev)
+
+/*!
+ * @brief Iterates `pos` over the links of the list whose head is `head`,
+ * keeping the next link in `tmp` so that the body may unlink `pos`.
+*/
+#define IDLIST_FOR_EACH_SAFE(pos, tmp, head) \
+    for ((pos)=(head)->next, (tmp)=(pos)->next; (pos) != (head); (pos)=(tmp), (tmp)=(pos)->next)
+
+/*!
+ * @brief Initializes an empty list head or an unlinked link.
+*/
+static inline void idlistInit(IDLink* const head){
+    head->next = head;
+    head->prev = head;
+}
+
+/*!
+ * @brief Whether the list whose head is `head` is empty.
+*/
+static inline cds_bool idlistIsEmpty(const IDLink* const head){
+    return head->next == head;
+}
+
+/*!
+ * @brief Whether `link` is on a list.
+ * @note Only meaningful for links initialized with `idlistInit` and unlinked
+ * with `idlistRemove`.
+*/
+static inline cds_bool idlistIsLinked(const IDLink* const link){
+    return link->next != link;
+}
+
+/*!
+ * @brief Links `link` right after `pos`, which is a head or a link of a list.
+*/
+static inline void idlistInsertAfter(IDLink* const pos, IDLink* const link){
+    link->prev = pos;
+    link->next = pos->next;
+    pos->next->prev = link;
+    pos->next = link;
+}
+
+/*!
+ * @brief Links `link` right before `pos`, which is a head or a link of a list.
+*/
+static inline void idlistInsertBefore(IDLink* const pos, IDLink* const link){
+    idlistInsertAfter(pos->prev, link);
+}
+
+/*!
+ * @brief Links `link` at the front of the list whose head is `head`.
+*/
+static inline void idlistPushFront(IDLink* const head, IDLink* const link){
+    idlistInsertAfter(head, link);
+}
+
+/*!
+ * @brief Links `link` at the back of the list whose head is `head`.
+*/
+static inline void idlistPushBack(IDLink* const head, IDLink* const link){
+    idlistInsertAfter(head->prev, link);
+}
+
+/*!
+ * @brief Unlinks `link` from its list in constant time, leaving it pointing to
+ * itself.
+*/
+static inline void idlistRemove(IDLink* const link){
+    link->prev->next = link->next;
+    link->next->prev = link->prev;
+    idlistInit(link);
+}
+
+/*!
+ * @brief Retrieves the first link of the list whose head is `head`.
+ * @return The link, or a `NULL` pointer if the list is empty.
+*/
+static inline IDLink* idlistFront(const IDLink* const head){
+    return idlistIsEmpty(head) ? (IDLink*) NULL : head->next;
+}
+
+/*!
+ * @brief Retrieves the last link of the list whose head is `head`.
+ * @return The link, or a `NULL` pointer if the list is empty.
+*/
+static inline IDLink* idlistBack(const IDLink* const head){
+    return idlistIsEmpty(head) ? (IDLink*) NULL : head->prev;
+}
+
+/*!
+ * @brief Unlinks the first link of the list whose head is `head`.
+ * @return The link unlinked, or a `NULL` pointer if the list is empty.
+*/
+static inline IDLink* idlistPopFront(IDLink* const head){
+    IDLink* link = idlistFront(head);
+    if (link){
+        idlistRemove(link);
+    }
+    return link;
+}
+
+/*!
+ * @brief Unlinks the last link of the list whose head is `head`.
+ * @return The link unlinked, or a `NULL` pointer if the list is empty.
+*/
+static inline IDLink* idlistPopBack(IDLink* const head){
+    IDLink* link = idlistBack(head);
+    if (link){
+        idlistRemove(link);
+    }
+    return link;
+}
+
+/*!
+ * @brief Moves every link of the list whose head is `src` to the back of the
+ * list whose head is `dst` in constant time, leaving `src` empty.
+*/
+static inline void idlistSplice(IDLink* const dst, IDLink* const src){
+    if (idlistIsEmpty(src)){
+        return;
+    }
+    src->next->prev = dst->prev;
+    dst->prev->next = src->next;
+    src->prev->next = dst;
+    dst->prev = src->prev;
+    idlistInit(src);
+}
+
+/**
+ * HASH BUCKET CHAINS
+ * ------------------
+*/
+
+/*!
+ * @brief Link of an intrusive hash bucket chain.
+ * @note `pprev` points to the pointer that points to the link (the `first`
+ * field of the bucket or the `next` field of the previous link), so a link is
+ * unlinked in constant time while the bucket itself holds a single pointer.
+*/
+typedef struct IHLink{
+    struct IHLink* next;
+    struct IHLink** pprev;
+}IHLink;
+
+/*!
+ * @brief Head of an intrusive hash bucket chain, the size of one pointer so that
+ * tables of buckets stay compact.
+*/
+typedef struct IHList{
+    IHLink* first;
+}IHList;
+
+/*!
+ * @brief Initializer of an empty bucket.
+*/
+#define IHLIST_INIT {(IHLink*) NULL}
+
+/*!
+ * @brief Iterates `pos` (an `IHLink*`) over the links of the bucket `bucket`
+ * (an `IHList*`).
+ * @note The link `pos` must not be unlinked in the body of the loop; see
+ * `IHLIST_FOR_EACH_SAFE`.
+*/
+#define IHLIST_FOR_EACH(pos, bucket) \
+    for ((pos)=(bucket)->first; (pos); (pos)=(pos)->next)
+
+/*!
+ * @brief Iterates `pos` over the links of the bucket `bucket`, keeping the next
+ * link in `tmp` so that the body may unlink `pos`.
+*/
+#define IHLIST_FOR_EACH_SAFE(pos, tmp, bucket) \
+    for ((pos)=(bucket)->first; (pos) && ((tmp)=(pos)->next, true); (pos)=(tmp))
+
+/*!
+ * @brief Initializes an empty bucket.
+*/
+static inline void ihlistInit(IHList* const bucket){
+    bucket->first = (IHLink*) NULL;
+}
+
+/*!
+ * @brief Initializes an unlinked link.
+*/
+static inline void ihlinkInit(IHLink* const link){
+    link->next = (IHLink*) NULL;
+    link->pprev = (IHLink**) NULL;
+}
+
+/*!
+ * @brief Whether the bucket is empty.
+*/
+static inline cds_bool ihlistIsEmpty(const IHList* const bucket){
+    return !bucket->first;
+}
+
+/*!
+ * @brief Whether `link` is on a bucket.
+ * @note Only meaningful for links initialized with `ihlinkInit` and unlinked
+ * with `ihlistRemove`.
+*/
+static inline cds_bool ihlistIsLinked(const IHLink* const link){
+    return link->pprev != (IHLink**) NULL;
+}
+
+/*!
+ * @brief Links `link` at the front of the bucket in constant time.
+*/
+static inline void ihlistAdd(IHList* const bucket, IHLink* const link){
+    link->next = bucket->first;
+    if (link->next){
+        link->next->pprev = &link->next;
+    }
+    bucket->first = link;
+    link->pprev = &bucket->first;
+}
+
+/*!
+ * @brief Unlinks `link` from its bucket in constant time, leaving it unlinked.
+*/
+static inline void ihlistRemove(IHLink* const link){
+    *link->pprev = link->next;
+    if (link->next){
+        link->next->pprev = link->pprev;
+    }
+    ihlinkInit(link);
+}
+
+#endif // INTRUSIVE_H
+
+/*! @} */ // end of intrusive group.
+
+#ifdef __cplusplus
+};
+#endif // __cplusplus
@@ -0,0 +1,203 @@
+/*!
+ * @file kernels.h
+ * @copyright GNU General Public Licence 3 or Later (GPLv3).
+ * @author Paulo Arruda
+ * @brief Header file containing vectorized searching, filtering and reduction
+ * kernels over the linear containers.
+ * @note On x86-64 the kernels use SSE2 and, when the processor supports it,
+ * AVX2 (selected at runtime). Other targets use scalar loops.
+ * @defgroup kernels
+ * @{
+*/
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#ifndef KERNELS_H
+#define KERNELS_H
+
+#include "common.h"
+#include "linear.h"
+
+/*!
+ * @brief Comparison operators used by the filtering kernels. An element `x` is
+ * kept whenever `x <op> value` holds.
+*/
+enum CompareOp{
+    CMP_EQ,
+    CMP_NE,
+    CMP_LT,
+    CMP_LE,
+    CMP_GT,
+    CMP_GE,
+};
+
+/*!
+ * @brief Searches for the first element equal to `value`.
+ * @note Elements are compared bytewise, hence `0.0` and `-0.0` are different
+ * and a NaN is found by its bit pattern.
+ * @param vec A pointer to the vector.
+ * @param value A pointer to the value (of the data size of the vector).
+ * @return The index of the first occurrence of `value`, or `CDS_NOT_FOUND` if
+ * there is none or either pointer is `NULL`.
+*/
+cds_size vectorFind(const Vector* const vec, const void* const value);
+
+/*!
+ * @brief Counts the elements equal to `value`.
+ * @note Elements are compared bytewise (see `vectorFind`).
+ * @param vec A pointer to the vector.
+ * @param value A pointer to the value (of the data size of the vector).
+ * @return The number of occurrences of `value`.
+*/
+cds_size vectorCount(const Vector* const vec, const void* const value);
+
+/*!
+ * @brief Appends to `dst` every element `x` of `src` such that `x <op> value`.
+ * @note `src` may be `dst` itself, in which case only the elements present
+ * before the call are filtered.
+ * @param src A pointer to the source vector.
+ * @param dst A pointer to the destination vector (of the same data size).
+ * @param op The comparison operator.
+ * @param value A pointer to the value to compare to.
+ * @param type The numeric type of the elements.
+ * @return The number of elements appended, or `CDS_NOT_FOUND` if a pointer is
+ * `NULL`, the data sizes do not match `type` or `dst` could not be expanded.
+*/
+cds_size vectorFilterInto(const Vector* const src, Vector* const dst, const enum CompareOp op,
+                          const void* const value, const enum NumericType type);
+
+/*!
+ * @brief Retrieves the minimum element of a numeric vector.
+ * @param vec A pointer to the vector.
+ * @param type The numeric type of the elements.
+ * @param[out] out A pointer to where the minimum (of type `type`) is written.
+ * @return `true` if the minimum was written, or `false` if the vector is empty,
+ * a pointer is `NULL` or `type` does not match the data size.
+ * @note NaNs are ignored unless every element is NaN.
+*/
+cds_bool vectorMin(const Vector* const vec, const enum NumericType type, void* const out);
+
+/*!
+ * @brief Retrieves the maximum element of a numeric vector.
+ * @see `vectorMin`.
+*/
+cds_bool vectorMax(const Vector* const vec, const enum NumericType type, void* const out);
+
+/*!
+ * @brief Sums the elements of a numeric vector.
+ * @note The sum is written as a `int64_t` for signed integers, as a `uint64_t`
+ * for unsigned integers (both wrapping on overflow) and as a `cds_double` for
+ * floating point numbers. Floating point sums use several partial sums, so
+ * the rounding may differ from a sequential sum.
+ * @param vec A pointer to the vector.
+ * @param type The numeric type of the elements.
+ * @param[out] out A pointer to where the sum is written.
+ * @return `true` if the sum was written, or `false` if a pointer is `NULL` or
+ * `type` does not match the data size.
+*/
+cds_bool vectorSum(const Vector* const vec, const enum NumericType type, void* const out);
+
+/*!
+ * @brief Replaces every element of the vector by the sum of the elements up to
+ * and including it (inclusive scan).
+ * @note Integer sums wrap around in the element type.
+ * @param vec A pointer to the vector.
+ * @param type The numeric type of the elements.
+ * @return `true` if the scan was done, or `false` if the pointer is `NULL` or
+ * `type` does not match the data size.
+*/
+cds_bool vectorPrefixSum(Vector* const vec, const enum NumericType type);
+
+/*!
+ * @brief Tuple counterpart of `vectorFind`.
+*/
+cds_size tupleFind(const Tuple* const tuple, const void* const value);
+
+/*!
+ * @brief Tuple counterpart of `vectorCount`.
+*/
+cds_size tupleCount(const Tuple* const tuple, const void* const value);
+
+/*!
+ * @brief Tuple counterpart of `vectorFilterInto`.
+*/
+cds_size tupleFilterInto(const Tuple* const src, Vector* const dst, const enum CompareOp op,
+                         const void* const value, const enum NumericType type);
+
+/*!
+ * @brief Tuple counterpart of `vectorMin`.
+*/
+cds_bool tupleMin(const Tuple* const tuple, const enum NumericType type, void* const out);
+
+/*!
+ * @brief Tuple counterpart of `vectorMax`.
+*/
+cds_bool tupleMax(const Tuple* const tuple, const enum NumericType type, void* const out);
+
+/*!
+ * @brief Tuple counterpart of `vectorSum`.
+*/
+cds_bool tupleSum(const Tuple* const tuple, const enum NumericType type, void* const out);
+
+/*!
+ * @brief Slice counterpart of `vectorFind`.
+ * @return The index (in the slice) of the first occurrence of `value`.
+*/
+cds_size vectorSliceFind(const VectorSlice* const slice, const void* const value);
+
+/*!
+ * @brief Slice counterpart of `vectorCount`.
+*/
+cds_size vectorSliceCount(const VectorSlice* const slice, const void* const value);
+
+/*!
+ * @brief Slice counterpart of `tupleFind`.
+ * @return The index (in the slice) of the first occurrence of `value`.
+*/
+cds_size tupleSliceFind(const TupleSlice* const slice, const void* const value);
+
+/*!
+ * @brief Slice counterpart of `tupleCount`.
+*/
+cds_size tupleSliceCount(const TupleSlice* const slice, const void* const value);
+
+/**
+ * RAW ARRAYS
+ * ----------
+ * The kernels above operate on the following functions, which are exposed
+ * for buffers that do not belong to a container.
+*/
+
+cds_size arrFind(const void* const arr, const cds_size length, const cds_size data_size,
+                 const void* const value);
+
+cds_size arrCount(const void* const arr, const cds_size length, const cds_size data_size,
+                  const void* const value);
+
+/*!
+ * @brief Writes to `out` every element `x` of `arr` such that `x <op> value`.
+ * @note `out` must have room for `length` elements.
+ * @return The number of elements written.
+*/
+cds_size arrFilter(const void* const arr, const cds_size length, void* const out,
+                   const enum CompareOp op, const void* const value, const enum NumericType type);
+
+cds_bool arrMin(const void* const arr, const cds_size length, const enum NumericType type,
+                void* const out);
+
+cds_bool arrMax(const void* const arr, const cds_size length, const enum NumericType type,
+                void* const out);
+
+void arrSum(const void* const arr, const cds_size length, const enum NumericType type,
+            void* const out);
+
+void arrPrefixSum(void* const arr, const cds_size length, const enum NumericType type);
+
+#endif // KERNELS_H
+
+/*! @} */ // end of kernels group.
+
+#ifdef __cplusplus
+};
+#endif // __cplusplus
@@ -16,6 +16,8 @@ extern "C" {
 #define LINEAR_H
 
 #include "hash.h"
+#include "arena.h"
+#include "pool.h"
 
 #ifndef LINEAR_DEFAULT_STATUS_ACTION_ALLOCATION_FAILURE
 #define LINEAR_DEFAULT_STATUS_ACTION_ALLOCATION_FAILURE ACTION_WARN
@@ -52,6 +54,28 @@ typedef struct Vector Vector;
 
 typedef struct Tuple Tuple;
 
+/*!
+ * @brief Non-owning view of a range of the elements of a vector.
+ * @note Slices are plain values: creating, copying and narrowing them allocates
+ * nothing and copies no element. A slice is valid until its vector is expanded
+ * or deleted.
+*/
+typedef struct VectorSlice{
+    void* data;             //!< pointer to the first element of the slice.
+    cds_size length;        //!< number of elements of the slice.
+    cds_size data_size;     //!< size of the elements.
+}VectorSlice;
+
+/*!
+ * @brief Non-owning (read only) view of a range of the elements of a tuple.
+ * @see `VectorSlice`.
+*/
+typedef struct TupleSlice{
+    const void* data;       //!< pointer to the first element of the slice.
+    cds_size length;        //!< number of elements of the slice.
+    cds_size data_size;     //!< size of the elements.
+}TupleSlice;
+
 /*!
  * @brief Constructor function for the vector structure.
  * @param min_capacity The minimal capacity of the vector.
@@ -61,6 +85,77 @@ typedef struct Tuple Tuple;
 */ 
 Vector* vectorCreate(const cds_size min_capacity, const cds_size data_size);
 
+/*!
+ * @brief Constructor function for vectors with allocation options.
+ * @note The buffer of the vector is aligned to `options->alignment` bytes (which
+ * suits aligned SIMD loads and streaming stores) and, if requested, backed by
+ * huge pages, which reduces the TLB misses of large vectors. The options are
+ * kept by the vector and also apply when it expands.
+ * @param min_capacity The minimal capacity of the vector.
+ * @param data_size The size of the data to be stored.
+ * @param options A pointer to the allocation options (`NULL` for the defaults).
+ * @return A pointer to a new empty vector if all memory allocations were
+ * sucesseful and the options are valid, or a `NULL` pointer otherwise.
+*/
+Vector* vectorCreateWithOptions(const cds_size min_capacity, const cds_size data_size,
+                                const AllocOptions* const options);
+
+/*!
+ * @brief Constructor function for vectors meant to grow very large.
+ * @note The buffer of the vector is an anonymous memory mapping. On Linux, it
+ * grows with `mremap`, which moves the pages instead of copying the elements,
+ * so doubling the capacity does not depend on the size of the vector.
+ * @param min_capacity The minimal capacity of the vector.
+ * @param data_size The size of the data to be stored.
+ * @param huge_pages Whether transparent huge pages should be requested for
+ * the buffer (`madvise(MADV_HUGEPAGE)`).
+ * @return A pointer to a new empty vector if all memory allocations were
+ * sucesseful, or a `NULL` pointer otherwise.
+*/
+Vector* vectorCreateLarge(const cds_size min_capacity, const cds_size data_size,
+                          const cds_bool huge_pages);
+
+/*!
+ * @brief Modes of opening files as memory mapped containers.
+*/
+enum MappedMode{
+    MAPPED_READ_ONLY,   // the file must exist; the container cannot be modified.
+    MAPPED_READ_WRITE,  // the file is created if it does not exist.
+    MAPPED_TRUNCATE,    // the file is created or truncated to length 0.
+};
+
+/*!
+ * @brief Opens a file of contiguous elements as a vector backed by a shared
+ * memory mapping of the file.
+ * @note The elements are not loaded into memory: the pages of the file are
+ * read on demand, so the file may be larger than the available memory. The
+ * vector grows by resizing the file (`ftruncate`) and remapping it, and the
+ * file is trimmed to the length of the vector by `vectorSync` and
+ * `vectorDelete`. Changes reach the file through the page cache; `vectorSync`
+ * forces them to be written.
+ * The functions modifying vectors opened with `MAPPED_READ_ONLY` fail, and
+ * their slices must not be written.
+ * @param path The path to the file.
+ * @param data_size The size of the elements. The size of the file must be a
+ * multiple of it.
+ * @param mode The mode of opening the file.
+ * @return A pointer to the vector if the file could be opened and mapped, or a
+ * `NULL` pointer otherwise.
+*/
+Vector* vectorOpenMapped(const cds_char* const path, const cds_size data_size,
+                         const enum MappedMode mode);
+
+/*!
+ * @brief Flushes the changes of a file backed vector to its file and trims the
+ * file to the length of the vector, so that it can be reopened as is.
+ * @note The capacity of the vector shrinks to its length, since the pages past
+ * the end of the file cannot be written; the next push grows the file again.
+ * @param vec A pointer to the vector.
+ * @return `true` if the changes were written (or there is nothing to write
+ * since the vector is not backed by a file), or `false` otherwise.
+*/
+cds_bool vectorSync(Vector* const vec);
+
 Vector* vectorFromArray(const void* const arr, const cds_size data_size, const cds_size arr_len);
 
 Vector* vectorCopy(const Vector* const arr);
@@ -114,7 +209,8 @@ void* vectorPopAt(Vector* vec, cds_size index, cds_bool shrink);
  * @param vec A pointer to the vector.
  * @param data A pointer to the new data.
  * @param index The index where the update should occur.
- * @return The old value stored in the vector at the specified index.
+ * @return The old value stored in the vector at the specified index, or a
+ * `NULL` pointer if the index is out of range or the vector is read only.
 */
 void* vectorUpdateAt(Vector* const vec, void* data, const cds_size index);
 
@@ -134,6 +230,27 @@ cds_size vectorLength(const Vector* const vec);
 */
 cds_size vectorCapacity(const Vector* const vec);
 
+/*!
+ * @brief Expands the vector so that it can hold at least `min_capacity` elements.
+ * @note The new capacity is the least power of 2 larger or equal to `min_capacity`.
+ * Vectors whose capacity is already large enough are left untouched.
+ * @param vec A pointer to the vector.
+ * @param min_capacity The minimal capacity of the vector.
+ * @return `true` if the vector can hold `min_capacity` elements, or `false` if
+ * the pointer is `NULL` or the memory allocation failed.
+*/
+cds_bool vectorReserve(Vector* const vec, const cds_size min_capacity);
+
+/*!
+ * @brief Shrinks the capacity of the vector to its length.
+ * @note Empty vectors keep a capacity of 1 element and read only file backed
+ * vectors are left untouched.
+ * @param vec A pointer to the vector.
+ * @return `true` if the capacity equals the length (or 1 for empty vectors),
+ * or `false` if the pointer is `NULL` or the memory allocation failed.
+*/
+cds_bool vectorShrinkToFit(Vector* const vec);
+
 /*!
  * @brief Return a pointer to the memory allocated array container of vector.
  * @note This pointer will be freed by `vectorDelete`.
@@ -151,6 +268,56 @@ const void* vectorToArr(const Vector* const vec);
 */
 Tuple* vectorToTuple(const Vector* const vec);
 
+/*!
+ * @brief Transforms the vector into a tuple that takes over its buffer, so no
+ * element is copied.
+ * @note On success the vector is consumed: its pointer must not be used (nor
+ * deleted) anymore. File backed vectors are trimmed to their length and the
+ * tuple keeps the mapping.
+ * @param vec A pointer to the vector.
+ * @param shrink_to_fit Whether the spare capacity of the buffer is released.
+ * @return A pointer to the tuple, or a `NULL` pointer if the pointer to the
+ * vector is `NULL` or the allocation of the tuple failed, in which case the
+ * vector is left untouched.
+*/
+Tuple* vectorIntoTuple(Vector* vec, const cds_bool shrink_to_fit);
+
+/*!
+ * @brief Creates a tuple that borrows the buffer of the vector.
+ * @note No element is copied. The view is valid until the vector is modified,
+ * expanded or deleted, and `tupleDelete` does not release the buffer.
+ * @param vec A pointer to the vector.
+ * @return A pointer to the tuple view, or a `NULL` pointer if the pointer to
+ * the vector is `NULL` or the allocation failed.
+*/
+Tuple* vectorToTupleView(const Vector* const vec);
+
+/*!
+ * @brief Creates a slice of the vector sharing its buffer.
+ * @note The range is truncated to the end of the vector, so consecutive windows
+ * can be taken with a fixed `length`.
+ * @param vec A pointer to the vector.
+ * @param start The index of the first element of the slice.
+ * @param length The number of elements of the slice.
+ * @return The slice, which is empty (with a `NULL` data pointer) if the pointer
+ * to the vector is `NULL` or `start` is out of range.
+*/
+VectorSlice vectorSlice(const Vector* const vec, const cds_size start, const cds_size length);
+
+/*!
+ * @brief Narrows a slice to a sub-range of it.
+ * @see `vectorSlice`.
+*/
+VectorSlice vectorSliceSub(const VectorSlice* const slice, const cds_size start,
+                           const cds_size length);
+
+/*!
+ * @brief Retrieves the element of the slice at `index`.
+ * @return A pointer to the element, or a `NULL` pointer if the index is out of
+ * range or the pointer to the slice is `NULL`.
+*/
+void* vectorSliceGetAt(const VectorSlice* const slice, const cds_size index);
+
 /****************** Tuples *******************/
 
 /*!
@@ -171,6 +338,48 @@ Tuple* tupleCreate(const cds_size length, const cds_size data_size, ...);
 */
 
 Tuple* tupleFromArray(const void* const arr, const size_t data_size, const size_t length);
+
+/*!
+ * @brief Constructor function for the tuple structure from arrays with
+ * allocation options.
+ * @param arr A pointer to the array.
+ * @param data_size The size of the elements.
+ * @param length The number of elements.
+ * @param options A pointer to the allocation options (`NULL` for the defaults).
+ * @return A pointer to a new tuple if all memory allocations were successeful
+ * and the options are valid, or a `NULL` pointer otherwise.
+ * @see `vectorCreateWithOptions`.
+*/
+Tuple* tupleFromArrayWithOptions(const void* const arr, const cds_size data_size,
+                                 const cds_size length, const AllocOptions* const options);
+
+/*!
+ * @brief Constructor function for the tuple structure from arrays, allocating
+ * the tuple from an arena.
+ * @note Meant for large numbers of short-lived tuples (e.g. composite hash
+ * keys): the tuple is released with the arena (by `arenaReset` or
+ * `arenaDelete`) and `tupleDelete` does nothing on it.
+ * @param arena A pointer to the arena.
+ * @param arr A pointer to the array.
+ * @param data_size The size of the elements.
+ * @param length The number of elements.
+ * @return A pointer to a new tuple if the arena allocation was successeful, or
+ * a `NULL` pointer otherwise.
+*/
+Tuple* tupleCreateInArena(Arena* const arena, const void* const arr, const cds_size data_size,
+                          const cds_size length);
+/*!
+ * @brief Opens a file of contiguous elements as a tuple backed by a read only
+ * memory mapping of the file.
+ * @param path The path to the file.
+ * @param data_size The size of the elements. The size of the file must be a
+ * multiple of it.
+ * @return A pointer to the tuple if the file could be opened and mapped, or a
+ * `NULL` pointer otherwise.
+ * @see `vectorOpenMapped`.
+*/
+Tuple* tupleOpenMapped(const cds_char* const path, const cds_size data_size);
+
 /**
  * @brief Destructor function for the tuple structure.
  * @param tuple A pointer to the tuple to be destroyed.
@@ -193,6 +402,26 @@ const void* tupleGetAt(const Tuple* const tuple, const cds_size index);
 */
 cds_size tupleLength(const Tuple* const tuple);
 
+/*!
+ * @brief Creates a slice of the tuple sharing its buffer.
+ * @see `vectorSlice`.
+*/
+TupleSlice tupleSlice(const Tuple* const tuple, const cds_size start, const cds_size length);
+
+/*!
+ * @brief Narrows a slice to a sub-range of it.
+ * @see `vectorSlice`.
+*/
+TupleSlice tupleSliceSub(const TupleSlice* const slice, const cds_size start,
+                         const cds_size length);
+
+/*!
+ * @brief Retrieves the element of the slice at `index`.
+ * @return A pointer to the element, or a `NULL` pointer if the index is out of
+ * range or the pointer to the slice is `NULL`.
+*/
+const void* tupleSliceGetAt(const TupleSlice* const slice, const cds_size index);
+
 /*!
  * @brief Converts the tuple into a vector.
  * @param tuple A pointer to the tuple.
@@ -201,6 +430,19 @@ cds_size tupleLength(const Tuple* const tuple);
 */
 Vector* tupleToVector(const Tuple* const tuple);
 
+/*!
+ * @brief Transforms the tuple into a vector that takes over its buffer, so no
+ * element is copied.
+ * @note On success the tuple is consumed: its pointer must not be used (nor
+ * deleted) anymore. The elements of file backed tuples and tuple views are
+ * copied, since their buffers cannot grow.
+ * @param tuple A pointer to the tuple.
+ * @return A pointer to the vector, or a `NULL` pointer if the pointer to the
+ * tuple is `NULL` or the allocations failed, in which case the tuple is left
+ * untouched.
+*/
+Vector* tupleIntoVector(Tuple* tuple);
+
 /**
  * SINGLY LINKED LIST
  * ------------------
@@ -208,13 +450,78 @@ Vector* tupleToVector(const Tuple* const tuple);
 */
 typedef struct SLList SLList;
 
+/*!
+ * @brief Default number of nodes of each slab of the node pool of a list.
+*/
+#define SLL_NODES_PER_SLAB 256
+
 /**
  * @brief Creator function for the singly linked list structure.
+ * @note The data is stored inline in the nodes, which are allocated from a pool
+ * owned by the list, so neighbouring nodes share slabs and deleting the list
+ * releases every node at once.
  * @param data_size The size of the data to be stored.
  * @return A new empty linked list if all allocations of
  * memory were successeful, or NULL otherwise.
 */
-SLList* sllistCreate(cds_size data_size);
+SLList* sllCreate(const cds_size data_size);
+
+/**
+ * @brief Creator function for a singly linked list whose nodes are allocated
+ * from a shared pool.
+ * @note Lists sharing a pool reuse each other's freed nodes. The pool must
+ * outlive the lists and its objects must be at least `sllNodeSize(data_size)`
+ * bytes long.
+ * @param data_size The size of the data to be stored.
+ * @param pool A pointer to the pool.
+ * @return A new empty linked list, or a `NULL` pointer if the allocation failed
+ * or the objects of the pool are too small.
+*/
+SLList* sllCreateWithPool(const cds_size data_size, Pool* const pool);
+
+/**
+ * @brief Retrieves the size of the nodes of a list storing data of `data_size`
+ * bytes, which is the object size of a pool shared by such lists.
+*/
+cds_size sllNodeSize(const cds_size data_size);
+
+/**
+ * @brief Destructor function for the singly linked list structure.
+ * @note The nodes go back to a shared pool in constant time, and an owned pool
+ * is deleted.
+ * @param list A pointer to the list.
+*/
+void sllDelete(SLList* list);
+
+/**
+ * @brief Retrieves the number of elements of the list.
+*/
+cds_size sllLength(const SLList* const list);
+
+/**
+ * @brief Inserts a new node with a copy of `data` at the beginning of the list.
+ * @param list A pointer to the list.
+ * @param data A pointer to the data.
+ * @return `true` if the insertion was successeful, or `false` otherwise.
+*/
+cds_bool sllPrepend(SLList* list, const void* data);
+
+/**
+ * @brief Inserts a new node with a copy of `data` at the end of the list.
+ * @see `sllPrepend`.
+*/
+cds_bool sllAppend(SLList* list, const void* data);
+
+/**
+ * @brief Removes the first node of the list.
+ * @param list A pointer to the list.
+ * @param[out] out A pointer to where the data of the node is copied, or a
+ * `NULL` pointer to discard it.
+ * @return `true` if a node was removed, or `false` if the list is empty or its
+ * pointer `NULL`.
+*/
+cds_bool sllPopFront(SLList* list, void* const out);
+
 /**
  * DOUBLE LINKED LIST
  * ------------------
@@ -236,6 +543,11 @@ enum IterableType{
     SLLIST,
     HASH_TABLE,
     SET,
+    SEG_VECTOR,
+    VECTOR_SLICE,
+    TUPLE_SLICE,
+    PACKED_VECTOR,
+    UNROLLED_LIST,
 };
 
 /*!
@@ -247,6 +559,10 @@ enum IterableType{
  * - Singly Linked Lists;
  * - Hash Tables (iteration occours over the keys);
  * - Sets;
+ * - Segmented Vectors;
+ * - Vector and tuple slices (a pointer to the slice is passed);
+ * - Packed vectors (decoded a block at a time);
+ * - Unrolled lists;
 */
 typedef struct Iter Iter;
 
@@ -294,9 +610,17 @@ const void* iterGetData(const Iter* const iter);
  ****************************************/
 /**
  * @brief Opaque definition of the stack structure.
+ * @note Stacks store their elements contiguously in a vector, so pushes and
+ * pops are a copy at the end of the buffer and grow it (by doubling) only when
+ * it is full.
 */
 typedef struct Stack Stack;
 
+/*!
+ * @brief Initial capacity of the stacks.
+*/
+#define STACK_DEFAULT_CAPACITY 16
+
 /**
  * @brief Constructor function for the stack structure.
  * @param data_size The size of the data to be stored.
@@ -312,35 +636,101 @@ Stack* stackCreate(cds_size data_size);
 void stackDelete(Stack* stack);
 
 /**
-* @brief Adds new data to the specified stack.
+ * @brief Retrieves the number of elements of the stack.
+*/
+cds_size stackLength(const Stack* const stack);
+
+/**
+ * @brief Makes room for at least `min_capacity` elements, so that pushes up to
+ * that depth do not reallocate.
+ * @return `true` if the stack holds `min_capacity` elements, or `false` if the
+ * allocation failed or the pointer is `NULL`.
+*/
+cds_bool stackReserve(Stack* const stack, const cds_size min_capacity);
+
+/**
+* @brief Adds a copy of `data` to the specified stack.
 * @param stack A pointer to the stack.
 * @param data A pointer to the data.
 * @return `true` if the insertion was sucesseful, or `false` otherwise.
 */
-cds_bool stackPush(Stack* stack, void* data);
+cds_bool stackPush(Stack* stack, const void* data);
 
 /**
- * @brief Retrieve and delete the position of the last element added to the 
- * stack.
+ * @brief Pushes the `count` elements of the array `data` with a single copy,
+ * the last element ending on top.
+ * @return `true` if the elements were pushed, or `false` if the allocation
+ * failed or a pointer is `NULL` (in which case nothing is pushed).
+*/
+cds_bool stackPushN(Stack* const stack, const void* const data, const cds_size count);
+
+/**
+ * @brief Retrieve and delete the last element added to the stack.
+ * @param stack A pointer to the stack.
+ * @param[out] out A pointer to where the element is copied, or a `NULL`
+ * pointer to discard it.
+ * @return `true` if an element was removed, or `false` if the stack is empty or
+ * its pointer `NULL`.
+*/
+cds_bool stackPop(Stack* stack, void* const out);
+
+/**
+ * @brief Pops up to `count` elements with a single copy.
+ * @note The elements are written in the order they were pushed (the top
+ * element last), hence `stackPopN` undoes `stackPushN`.
  * @param stack A pointer to the stack.
- * @return A void pointer to the last data added, if any, or a `NULL` pointer
- * otherwise.
+ * @param[out] out A pointer to an array of `count` elements, or a `NULL`
+ * pointer to discard them.
+ * @param count The largest number of elements popped.
+ * @return The number of elements popped.
 */
-void* stackPop(Stack* stack);
+cds_size stackPopN(Stack* const stack, void* const out, const cds_size count);
+
+/**
+ * @brief Retrieves the element on top of the stack without removing it.
+ * @return A pointer to the element, valid until the next push, or a `NULL`
+ * pointer if the stack is empty.
+*/
+void* stackPeek(const Stack* const stack);
 
 /**
  * QUEUES
  * ------
 */
+/**
+ * @brief Opaque definition of the (FIFO) queue structure.
+*/
 typedef struct Queue Queue;
 
+/**
+ * @brief Constructor function for the queue structure.
+ * @param data_size The size of the data to be stored.
+ * @return A pointer to a new empty queue if all memory allocations were
+ * sucesseful, or `NULL` pointer otherwise.
+*/
 Queue* queueCreate(cds_size data_size);
 
+/**
+ * @brief Destructor function for the queue structure.
+*/
 void queueDelete(Queue* queue);
 
-cds_bool queuePush(Queue* queue);
+/**
+ * @brief Retrieves the number of elements of the queue.
+*/
+cds_size queueLength(const Queue* const queue);
+
+/**
+ * @brief Adds a copy of `data` to the end of the queue.
+ * @see `stackPush`.
+*/
+cds_bool queuePush(Queue* queue, const void* data);
 
-void* queuePop(Queue* queue);
+/**
+ * @brief Retrieve and delete the first element added to the queue.
+ * @see `stackPop`.
+*/
+cds_bool queuePop(Queue* queue, void* const out);
 
 #endif// LINEAR_H
 
@@ -0,0 +1,96 @@
+/*!
+ * @file linear_inline.h
+ * @copyright GNU General Public Licence 3 or Later (GPLv3).
+ * @author Paulo Arruda
+ * @brief Opt-in header with inline, unchecked accessors for vectors and tuples.
+ * @note The accessors here do not test for `NULL` pointers nor for the range of
+ * the index, so that loops compile to plain pointer arithmetic. Defining
+ * `CDS_BOUNDS_CHECK` before including this header turns every access into an
+ * `assert`ed one, which is meant for debug builds.
+ * @defgroup linear_inline
+ * @{
+*/
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#ifndef LINEAR_INLINE_H
+#define LINEAR_INLINE_H
+
+#include "_private_linear.h"
+
+#ifdef CDS_BOUNDS_CHECK
+    #include <assert.h>
+    #define _CDS_CHECK_ACCESS(container, index) \
+        assert((container) && (index) < (container)->length)
+#else
+    #define _CDS_CHECK_ACCESS(container, index) ((void) 0)
+#endif // CDS_BOUNDS_CHECK
+
+/*!
+ * @brief Retrieves the buffer of the vector.
+ * @note The pointer is invalidated whenever the vector expands.
+*/
+static inline void* vectorData(const Vector* const vec){
+    return vec->container;
+}
+
+/*!
+ * @brief Retrieves the length of a vector that is known not to be `NULL`.
+*/
+static inline cds_size vectorLengthUnchecked(const Vector* const vec){
+    return vec->length;
+}
+
+/*!
+ * @brief Retrieves a pointer to the element of the vector at `index` without
+ * checking the range of the index.
+*/
+static inline void* vectorAtUnchecked(const Vector* const vec, const cds_size index){
+    _CDS_CHECK_ACCESS(vec, index);
+    return CDS_BYTE_OFFSET(vec->container, index*vec->data_size);
+}
+
+/*!
+ * @brief Retrieves the buffer of the tuple.
+*/
+static inline const void* tupleData(const Tuple* const tuple){
+    return tuple->container;
+}
+
+/*!
+ * @brief Retrieves the length of a tuple that is known not to be `NULL`.
+*/
+static inline cds_size tupleLengthUnchecked(const Tuple* const tuple){
+    return tuple->length;
+}
+
+/*!
+ * @brief Retrieves a pointer to the element of the tuple at `index` without
+ * checking the range of the index.
+*/
+static inline const void* tupleAtUnchecked(const Tuple* const tuple, const cds_size index){
+    _CDS_CHECK_ACCESS(tuple, index);
+    return CDS_BYTE_OFFSET(tuple->container, index*tuple->data_size);
+}
+
+/*!
+ * @brief Typed access to the element of a vector, usable as an lvalue:
+ * `VECTOR_AT(v, cds_int, i) += 1;`.
+ * @note `type` must have the data size of the vector.
+*/
+#define VECTOR_AT(vec, type, index) (*(type*) vectorAtUnchecked(vec, index))
+
+/*!
+ * @brief Typed (read only) access to the element of a tuple.
+ * @note `type` must have the data size of the tuple.
+*/
+#define TUPLE_AT(tuple, type, index) (*(const type*) tupleAtUnchecked(tuple, index))
+
+#endif // LINEAR_INLINE_H
+
+/*! @} */ // end of linear_inline group.
+
+#ifdef __cplusplus
+};
+#endif // __cplusplus
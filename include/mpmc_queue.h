@@ -0,0 +1,134 @@
+/*!
+ * @file mpmc_queue.h
+ * @copyright GNU General Public Licence 3 or Later (GPLv3).
+ * @author Paulo Arruda
+ * @brief Header file containing the API for the bounded lock-free
+ * multi-producer/multi-consumer queue.
+ * @note The queue is a ring of a power of two slots, each one holding an
+ * element and a sequence number (D. Vyukov's bounded MPMC queue). Producers and
+ * consumers claim positions with a compare-and-swap on their own counter, which
+ * live on separate cache lines, and hand the slots over through the sequence
+ * numbers, so no lock is taken unless a blocking operation has to sleep.
+ * Elements are copied in and out.
+ * @defgroup mpmc_queue
+ * @{
+*/
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#ifndef MPMC_QUEUE_H
+#define MPMC_QUEUE_H
+
+#include "common.h"
+
+/*!
+ * @brief Opaque data type definition for the MPMC queue structure.
+*/
+typedef struct MPMCQueue MPMCQueue;
+
+/*!
+ * @brief Constructor function for the MPMC queue structure.
+ * @param capacity The least number of elements the queue holds, which is
+ * rounded up to a power of 2.
+ * @param data_size The size of the elements.
+ * @return A pointer to a new empty queue if all memory allocations were
+ * successeful and both parameters are positive, or a `NULL` pointer otherwise.
+*/
+MPMCQueue* mpmcqCreate(const cds_size capacity, const cds_size data_size);
+
+/*!
+ * @brief Destructor function for the MPMC queue structure.
+ * @note No thread may be using the queue.
+ * @param queue A pointer to the queue.
+*/
+void mpmcqDelete(MPMCQueue* queue);
+
+/*!
+ * @brief Retrieves the number of elements the queue holds.
+*/
+cds_size mpmcqCapacity(const MPMCQueue* const queue);
+
+/*!
+ * @brief Retrieves the number of elements in the queue.
+ * @note The value is a snapshot, which may be stale when other threads use the
+ * queue.
+*/
+cds_size mpmcqLength(const MPMCQueue* const queue);
+
+/*!
+ * @brief Adds a copy of `data` to the queue if it is not full.
+ * @param queue A pointer to the queue.
+ * @param data A pointer to the data.
+ * @return `true` if the element was added, or `false` if the queue is full or a
+ * pointer is `NULL`.
+*/
+cds_bool mpmcqTryPush(MPMCQueue* const queue, const void* const data);
+
+/*!
+ * @brief Removes the oldest element of the queue if it is not empty.
+ * @param queue A pointer to the queue.
+ * @param[out] out A pointer to where the element is copied.
+ * @return `true` if an element was removed, or `false` if the queue is empty or
+ * a pointer is `NULL`.
+*/
+cds_bool mpmcqTryPop(MPMCQueue* const queue, void* const out);
+
+/*!
+ * @brief Adds a copy of `data` to the queue, waiting while it is full.
+ * @note Waiting threads spin, then yield, then sleep until a consumer frees a
+ * slot.
+ * @return `true` if the element was added, or `false` if a pointer is `NULL`.
+*/
+cds_bool mpmcqPush(MPMCQueue* const queue, const void* const data);
+
+/*!
+ * @brief Removes the oldest element of the queue, waiting while it is empty.
+ * @see `mpmcqPush`.
+*/
+cds_bool mpmcqPop(MPMCQueue* const queue, void* const out);
+
+/*!
+ * @brief Adds up to `count` elements of the array `data` to the queue.
+ * @note The free slots are claimed with a single compare-and-swap, so batches
+ * pay the contended operation once.
+ * @param queue A pointer to the queue.
+ * @param data A pointer to an array of `count` elements.
+ * @param count The number of elements.
+ * @return The number of (leading) elements of `data` added, which is less than
+ * `count` if the queue filled up.
+*/
+cds_size mpmcqTryPushN(MPMCQueue* const queue, const void* const data, const cds_size count);
+
+/*!
+ * @brief Removes up to `max` elements from the queue.
+ * @see `mpmcqTryPushN`.
+ * @param queue A pointer to the queue.
+ * @param[out] out A pointer to an array of `max` elements.
+ * @param max The largest number of elements removed.
+ * @return The number of elements written to `out`.
+*/
+cds_size mpmcqTryPopN(MPMCQueue* const queue, void* const out, const cds_size max);
+
+/*!
+ * @brief Adds the `count` elements of the array `data` to the queue, waiting
+ * while it is full.
+ * @return The number of elements added, `count` unless a pointer is `NULL`.
+*/
+cds_size mpmcqPushN(MPMCQueue* const queue, const void* const data, const cds_size count);
+
+/*!
+ * @brief Removes up to `max` elements from the queue, waiting while it is
+ * empty.
+ * @return The number of elements written to `out`, which is positive unless a
+ * pointer is `NULL` or `max` is 0.
+*/
+cds_size mpmcqPopN(MPMCQueue* const queue, void* const out, const cds_size max);
+
+#endif // MPMC_QUEUE_H
+
+/*! @} */ // end of mpmc_queue group.
+
+#ifdef __cplusplus
+};
+#endif // __cplusplus
@@ -0,0 +1,131 @@
+/*!
+ * @file packed_vector.h
+ * @copyright GNU General Public Licence 3 or Later (GPLv3).
+ * @author Paulo Arruda
+ * @brief Header file containing the API for the compressed (packed) integer
+ * vector.
+ * @note A packed vector is an immutable sequence of integers split into blocks
+ * of `PACKED_BLOCK_SIZE` values. Every block stores a header (its reference
+ * value, its encoding and the position of its bits) and its values bit-packed
+ * with the least width that holds them:
+ * - frame of reference: the values minus the least value of the block;
+ * - delta: the differences between consecutive values minus the least
+ *   difference, which takes a few bits for sorted data.
+ *
+ * Random access reads one block header and the bits of the value (plus the
+ * preceding deltas of the block for delta blocks), and sequential reads decode
+ * whole blocks at once (with AVX2 gathers when available).
+ * @defgroup packed_vector
+ * @{
+*/
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#ifndef PACKED_VECTOR_H
+#define PACKED_VECTOR_H
+
+#include "common.h"
+#include "linear.h"
+
+/*!
+ * @brief Number of values per block.
+*/
+#define PACKED_BLOCK_SIZE 128
+
+/*!
+ * @brief Encodings of the blocks of a packed vector.
+*/
+enum PackedEncoding{
+    PACKED_FOR,     // frame of reference bit-packing
+    PACKED_DELTA,   // bit-packed deltas, for sorted or slowly varying data
+    PACKED_AUTO,    // the smaller of the two, block by block
+};
+
+/*!
+ * @brief Opaque data type definition for the packed vector structure.
+*/
+typedef struct PackedVector PackedVector;
+
+/*!
+ * @brief Builds a packed vector out of an array of integers.
+ * @param arr A pointer to the first integer.
+ * @param length The number of integers.
+ * @param type The integer type of the elements (floating point types are not
+ * supported).
+ * @param encoding The encoding of the blocks.
+ * @return A pointer to a new packed vector if all memory allocations were
+ * successeful and `type` is an integer type, or a `NULL` pointer otherwise.
+*/
+PackedVector* packvecFromArray(const void* const arr, const cds_size length,
+                               const enum NumericType type, const enum PackedEncoding encoding);
+
+/*!
+ * @brief Builds a packed vector out of a vector of integers.
+ * @note The data size of the vector must be the size of `type`.
+ * @see `packvecFromArray`.
+*/
+PackedVector* packvecFromVector(const Vector* const vec, const enum NumericType type,
+                                const enum PackedEncoding encoding);
+
+/*!
+ * @brief Destructor function for the packed vector structure.
+ * @param pv A pointer to the packed vector.
+*/
+void packvecDelete(PackedVector* pv);
+
+/*!
+ * @brief Retrieves the number of values of the packed vector.
+*/
+cds_size packvecLength(const PackedVector* const pv);
+
+/*!
+ * @brief Retrieves the size of the (decoded) values of the packed vector.
+*/
+cds_size packvecDataSize(const PackedVector* const pv);
+
+/*!
+ * @brief Retrieves the number of bytes used by the packed vector, headers
+ * included.
+*/
+cds_size packvecMemoryUsage(const PackedVector* const pv);
+
+/*!
+ * @brief Retrieves the value at `index`.
+ * @param pv A pointer to the packed vector.
+ * @param index The index of the value.
+ * @param[out] out A pointer to where the value (of the type of the packed
+ * vector) is written.
+ * @return `true` if the value was written, or `false` if the index is out of
+ * range or a pointer is `NULL`.
+*/
+cds_bool packvecGet(const PackedVector* const pv, const cds_size index, void* const out);
+
+/*!
+ * @brief Decodes the values in [`start`, `start + count`) into an array.
+ * @note Whole blocks are decoded at once, so this is the fast way of reading a
+ * range of values.
+ * @param pv A pointer to the packed vector.
+ * @param start The index of the first value.
+ * @param count The number of values.
+ * @param[out] out A pointer to an array of `count` values of the type of the
+ * packed vector.
+ * @return The number of values decoded, which is less than `count` if the range
+ * exceeds the packed vector.
+*/
+cds_size packvecDecode(const PackedVector* const pv, const cds_size start, const cds_size count,
+                       void* const out);
+
+/*!
+ * @brief Decodes the whole packed vector into a new vector.
+ * @return A pointer to a new vector, or a `NULL` pointer otherwise.
+*/
+Vector* packvecToVector(const PackedVector* const pv);
+
+#endif // PACKED_VECTOR_H
+
+/*! @} */ // end of packed_vector group.
+
+#ifdef __cplusplus
+};
+#endif // __cplusplus
@@ -0,0 +1,121 @@
+/*!
+ * @file parallel.h
+ * @copyright GNU General Public Licence 3 or Later (GPLv3).
+ * @author Paulo Arruda
+ * @brief Header file containing data-parallel operations over vectors.
+ * @note The elements are split into chunks run as the tasks of a thread pool.
+ * The chunks start at the first element beginning at or after a cache line
+ * boundary (an address multiple of `CDS_CACHE_LINE`) of the written buffer, so
+ * threads never write to the same cache line when the buffer is aligned to its
+ * elements, as `malloc` buffers of power of 2 sized elements are.
+ * @defgroup parallel
+ * @{
+*/
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include "common.h"
+#include "linear.h"
+#include "thread_pool.h"
+
+/*!
+ * @brief Minimal number of bytes per chunk. Vectors smaller than it are
+ * processed by the calling thread.
+*/
+#ifndef PARALLEL_GRAIN
+#define PARALLEL_GRAIN (1 << 14)
+#endif // PARALLEL_GRAIN
+
+/*!
+ * @brief Number of chunks per thread, which balances the load when the cost of
+ * the elements varies.
+*/
+#ifndef PARALLEL_CHUNKS_PER_THREAD
+#define PARALLEL_CHUNKS_PER_THREAD 4
+#endif // PARALLEL_CHUNKS_PER_THREAD
+
+/*!
+ * @brief Signature of the functions applied by `vectorParallelForEach`.
+ * @param data A pointer to the element.
+ * @param index The index of the element.
+ * @param arg The user argument.
+*/
+typedef void (*ForEachFun)(void* data, const cds_size index, void* arg);
+
+/*!
+ * @brief Signature of the functions applied by `vectorParallelMap`.
+ * @param in A pointer to the source element.
+ * @param[out] out A pointer to the destination element.
+ * @param arg The user argument.
+*/
+typedef void (*MapFun)(const void* in, void* out, void* arg);
+
+/*!
+ * @brief Signature of the functions folding an element into an accumulator.
+*/
+typedef void (*FoldFun)(void* acc, const void* data, void* arg);
+
+/*!
+ * @brief Signature of the functions combining two accumulators into the first.
+*/
+typedef void (*CombineFun)(void* acc, const void* other, void* arg);
+
+/*!
+ * @brief Applies `fun` to every element of the vector in parallel.
+ * @param vec A pointer to the vector.
+ * @param fun The function applied to the elements.
+ * @param arg The user argument passed to `fun`.
+ * @param pool A pointer to the thread pool (`NULL` for the default pool).
+ * @return `true` if `fun` was applied, or `false` if a pointer is `NULL`.
+*/
+cds_bool vectorParallelForEach(Vector* const vec, const ForEachFun fun, void* arg,
+                               ThreadPool* const pool);
+
+/*!
+ * @brief Writes `fun` of every element of `src` to the element of `dst` at the
+ * same index, in parallel.
+ * @note `dst` is grown to the length of `src`, and its elements may have a
+ * different data size.
+ * @param src A pointer to the source vector.
+ * @param dst A pointer to the destination vector.
+ * @param fun The function mapping the elements.
+ * @param arg The user argument passed to `fun`.
+ * @param pool A pointer to the thread pool (`NULL` for the default pool).
+ * @return `true` if the elements were mapped, or `false` if a pointer is `NULL`
+ * or `dst` could not be expanded.
+*/
+cds_bool vectorParallelMap(const Vector* const src, Vector* const dst, const MapFun fun, void* arg,
+                           ThreadPool* const pool);
+
+/*!
+ * @brief Reduces the vector in parallel.
+ * @note Every chunk folds its elements into a copy of the initial value of
+ * `acc`, and the results of the chunks are then combined in order, so `combine`
+ * needs to be associative (but not commutative) and the initial value an
+ * identity of it.
+ * @param vec A pointer to the vector.
+ * @param[in,out] acc A pointer to the accumulator: its initial value is the
+ * identity, and the result is written to it.
+ * @param acc_size The size of the accumulator.
+ * @param fold The function folding an element into an accumulator.
+ * @param combine The function combining two accumulators.
+ * @param arg The user argument passed to `fold` and `combine`.
+ * @param pool A pointer to the thread pool (`NULL` for the default pool).
+ * @return `true` if the result was written, or `false` if a pointer is `NULL`
+ * or the accumulators could not be allocated.
+*/
+cds_bool vectorParallelReduce(const Vector* const vec, void* const acc, const cds_size acc_size,
+                              const FoldFun fold, const CombineFun combine, void* arg,
+                              ThreadPool* const pool);
+
+#endif // PARALLEL_H
+
+/*! @} */ // end of parallel group.
+
+#ifdef __cplusplus
+};
+#endif // __cplusplus
@@ -0,0 +1,80 @@
+/*!
+ * @file pool.h
+ * @copyright GNU General Public Licence 3 or Later (GPLv3).
+ * @author Paulo Arruda
+ * @brief Header file containing the API for the pool (slab) allocator.
+ * @defgroup pool
+ * @{
+*/
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#ifndef POOL_H
+#define POOL_H
+
+#include "common.h"
+
+/*!
+ * @brief Opaque data type definition for the pool structure.
+ * @note A pool hands out objects of a single size carved from large slabs.
+ * Freed objects go to a free list and are reused first, so allocations are a
+ * pointer pop, neighbouring objects share cache lines, and deleting the pool
+ * releases every object at once. Pools are not thread safe.
+*/
+typedef struct Pool Pool;
+
+/*!
+ * @brief Constructor function for the pool structure.
+ * @param object_size The size in bytes of the objects, which is rounded up to
+ * keep every object aligned for any type.
+ * @param objects_per_slab The number of objects of each slab.
+ * @return A pointer to a new pool if all memory allocations were successeful
+ * and both parameters are positive, or a `NULL` pointer otherwise.
+*/
+Pool* poolCreate(const cds_size object_size, const cds_size objects_per_slab);
+
+/*!
+ * @brief Destructor function for the pool structure, which releases every
+ * object allocated from it.
+ * @param pool A pointer to the pool.
+*/
+void poolDelete(Pool* pool);
+
+/*!
+ * @brief Allocates an object from the pool.
+ * @param pool A pointer to the pool.
+ * @return A pointer to the (uninitialized) object, or a `NULL` pointer if the
+ * pointer to the pool is `NULL` or a new slab could not be allocated.
+*/
+void* poolAlloc(Pool* const pool);
+
+/*!
+ * @brief Returns an object to the pool.
+ * @param pool A pointer to the pool.
+ * @param object A pointer to an object allocated from `pool`.
+*/
+void poolFree(Pool* const pool, void* const object);
+
+/*!
+ * @brief Returns a chain of objects to the pool in constant time.
+ * @note The objects must be linked through their first field, a pointer to the
+ * next object of the chain (as the nodes of linked lists are).
+ * @param pool A pointer to the pool.
+ * @param first A pointer to the first object of the chain.
+ * @param last A pointer to the last object of the chain.
+*/
+void poolFreeChain(Pool* const pool, void* const first, void* const last);
+
+/*!
+ * @brief Retrieves the (rounded) size of the objects of the pool.
+*/
+cds_size poolObjectSize(const Pool* const pool);
+
+#endif // POOL_H
+
+/*! @} */ // end of pool group.
+
+#ifdef __cplusplus
+};
+#endif // __cplusplus
@@ -0,0 +1,126 @@
+/*!
+ * @file segmented_vector.h
+ * @copyright GNU General Public Licence 3 or Later (GPLv3).
+ * @author Paulo Arruda
+ * @brief Header file containing the API for the segmented vector structure.
+ * @defgroup segmented_vector
+ * @{
+*/
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#ifndef SEGMENTED_VECTOR_H
+#define SEGMENTED_VECTOR_H
+
+#include "common.h"
+
+/*!
+ * @brief Opaque data type definition for the segmented vector structure.
+ * @note The segmented vector stores its elements in fixed-size chunks plus an
+ * index of chunks. Appending never moves the elements already stored, hence
+ * the pointers returned by `segvecGetAt` stay valid until the element is
+ * removed or the vector is deleted.
+*/
+typedef struct SegVector SegVector;
+
+/*!
+ * @brief Signature of the function applied to every chunk by
+ * `segvecParallelForEachChunk`.
+ * @param chunk A pointer to the first element of the chunk.
+ * @param length The number of elements in the chunk.
+ * @param first_index The index (in the segmented vector) of the first element.
+ * @param arg The user argument passed to `segvecParallelForEachChunk`.
+*/
+typedef void (*SegVectorChunkFun)(void* chunk, const cds_size length, const cds_size first_index,
+                                  void* arg);
+
+/*!
+ * @brief Constructor function for the segmented vector structure.
+ * @param chunk_capacity The minimal number of elements per chunk. The actual
+ * number is the least power of 2 larger or equal to it.
+ * @param data_size The size of the data to be stored.
+ * @return A pointer to a new empty segmented vector if all memory allocations
+ * were successeful, or a `NULL` pointer otherwise.
+*/
+SegVector* segvecCreate(const cds_size chunk_capacity, const cds_size data_size);
+
+/*!
+ * @brief Destructor function for the segmented vector structure.
+ * @param sv A pointer to the segmented vector.
+*/
+void segvecDelete(SegVector* sv);
+
+/*!
+ * @brief Appends a new element to the segmented vector.
+ * @note A new chunk is allocated whenever the last one is full; the elements
+ * already stored are never copied.
+ * @param sv A pointer to the segmented vector.
+ * @param data A pointer to the data to be stored.
+ * @return `true` if the insertion was successeful, or `false` otherwise.
+*/
+cds_bool segvecAppend(SegVector* const sv, const void* const data);
+
+/*!
+ * @brief Removes the last element of the segmented vector.
+ * @note The chunk emptied by the removal is kept for later appends.
+ * @param sv A pointer to the segmented vector.
+ * @return `true` if an element was removed, or `false` if the segmented vector
+ * is empty or its pointer is `NULL`.
+*/
+cds_bool segvecPopBack(SegVector* const sv);
+
+/*!
+ * @brief Retrieves the element stored at a specific index.
+ * @param sv A pointer to the segmented vector.
+ * @param index The index of the element.
+ * @return A pointer to the element, which stays valid while the element is
+ * stored, or a `NULL` pointer if the index is out of range.
+*/
+void* segvecGetAt(const SegVector* const sv, const cds_size index);
+
+/*!
+ * @brief Retrieves the number of elements of the segmented vector.
+*/
+cds_size segvecLength(const SegVector* const sv);
+
+/*!
+ * @brief Retrieves the number of elements per chunk.
+*/
+cds_size segvecChunkCapacity(const SegVector* const sv);
+
+/*!
+ * @brief Retrieves the number of chunks holding elements.
+*/
+cds_size segvecNumChunks(const SegVector* const sv);
+
+/*!
+ * @brief Retrieves a chunk of the segmented vector.
+ * @param sv A pointer to the segmented vector.
+ * @param chunk The index of the chunk.
+ * @param[out] plength A pointer to where the number of elements of the chunk is
+ * written.
+ * @return A pointer to the first element of the chunk, or a `NULL` pointer if
+ * the chunk index is out of range.
+*/
+void* segvecChunk(const SegVector* const sv, const cds_size chunk, cds_size* const plength);
+
+/*!
+ * @brief Applies `fun` to every chunk of the segmented vector, distributing the
+ * chunks between threads.
+ * @note Chunks are handed out dynamically to the threads of the default pool
+ * (see `tpoolDefault`), so chunks that take longer to be processed do not stall
+ * the other threads. `fun` must not append to nor pop from the segmented vector.
+ * @param sv A pointer to the segmented vector.
+ * @param fun The function applied to every chunk.
+ * @param arg The user argument passed to `fun`.
+*/
+void segvecParallelForEachChunk(const SegVector* const sv, const SegVectorChunkFun fun, void* arg);
+
+#endif // SEGMENTED_VECTOR_H
+
+/*! @} */ // end of segmented_vector group.
+
+#ifdef __cplusplus
+};
+#endif // __cplusplus
@@ -0,0 +1,204 @@
+/*!
+ * @file serialize.h
+ * @copyright GNU General Public Licence 3 or Later (GPLv3).
+ * @author Paulo Arruda
+ * @brief Header file containing the binary serialization API of the containers.
+ * @note Every container is written as a header (the magic bytes `CDS`, the kind
+ * of container, the format version and flags, followed by the sizes of the
+ * container as little-endian 64 bits integers) and its elements. Elements are
+ * copied byte by byte as plain old data, in a single bulk copy for vectors and
+ * tuples, so their byte order is the one of the writer: it is recorded in the
+ * flags and streams of the other byte order are rejected.
+ * @defgroup serialize
+ * @{
+*/
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#ifndef SERIALIZE_H
+#define SERIALIZE_H
+
+#include "common.h"
+#include "linear.h"
+#include "hash.h"
+#include "arena.h"
+
+/*!
+ * @brief Version of the binary format written by this library. Streams of
+ * later versions are rejected.
+*/
+#define CDS_SERIAL_VERSION 1
+
+/*!
+ * @brief Size in bytes of the buffer of file descriptor streams. Writes and
+ * reads larger than it bypass the buffer.
+*/
+#ifndef STREAM_CHUNK_SIZE
+#define STREAM_CHUNK_SIZE (1 << 16)
+#endif // STREAM_CHUNK_SIZE
+
+/*!
+ * @brief Opaque data type definition for the stream structure.
+ * @note A stream either writes to or reads from a file descriptor (through an
+ * internal buffer of `STREAM_CHUNK_SIZE` bytes) or a user buffer. A stream
+ * should be used either for writing or for reading, not both.
+*/
+typedef struct Stream Stream;
+
+/*!
+ * @brief Constructor function for streams over a file descriptor.
+ * @note The file descriptor is not closed by `streamDelete`.
+ * @param fd The file descriptor (of a file, pipe or socket).
+ * @return A pointer to a new stream if all memory allocations were successeful,
+ * or a `NULL` pointer otherwise.
+*/
+Stream* streamFromFd(const cds_int fd);
+
+/*!
+ * @brief Constructor function for streams over a user buffer.
+ * @note Writes fail once the buffer is full and reads reach the end of the
+ * stream at the end of the buffer.
+ * @param buffer A pointer to the buffer.
+ * @param size The size in bytes of the buffer.
+ * @return A pointer to a new stream if all memory allocations were successeful
+ * and the buffer is not `NULL`, or a `NULL` pointer otherwise.
+*/
+Stream* streamFromBuffer(void* const buffer, const cds_size size);
+
+/*!
+ * @brief Destructor function for the stream structure, which flushes the
+ * pending writes.
+ * @param stream A pointer to the stream.
+ * @return `true` if all the writes reached the file descriptor, or `false`
+ * otherwise.
+*/
+cds_bool streamDelete(Stream* stream);
+
+/*!
+ * @brief Writes the bytes buffered by the stream to its file descriptor.
+ * @param stream A pointer to the stream.
+ * @return `true` if the bytes were written, or `false` if a write failed.
+*/
+cds_bool streamFlush(Stream* const stream);
+
+/*!
+ * @brief Writes `size` bytes to the stream.
+ * @param stream A pointer to the stream.
+ * @param data A pointer to the bytes.
+ * @param size The number of bytes.
+ * @return `true` if all the bytes were written (or buffered), or `false`
+ * otherwise.
+*/
+cds_bool streamWrite(Stream* const stream, const void* const data, const cds_size size);
+
+/*!
+ * @brief Reads up to `size` bytes from the stream.
+ * @param stream A pointer to the stream.
+ * @param[out] data A pointer to where the bytes are written.
+ * @param size The number of bytes.
+ * @return The number of bytes read, which is less than `size` only at the end
+ * of the stream or on errors.
+*/
+cds_size streamRead(Stream* const stream, void* const data, const cds_size size);
+
+/*!
+ * @brief Retrieves the number of bytes written to or read from the stream.
+*/
+cds_size streamPosition(const Stream* const stream);
+
+/*!
+ * @brief Writes a vector to the stream.
+ * @param vec A pointer to the vector.
+ * @param stream A pointer to the stream.
+ * @return `true` if the vector was written, or `false` otherwise.
+*/
+cds_bool vectorWrite(const Vector* const vec, Stream* const stream);
+
+/*!
+ * @brief Reads a vector written by `vectorWrite`.
+ * @note The buffer grows as the elements are read, so a corrupt length in the
+ * header fails at the end of the stream instead of allocating its size.
+ * @param stream A pointer to the stream.
+ * @return A pointer to a new vector, or a `NULL` pointer if the stream is not a
+ * valid vector or the memory allocations failed.
+*/
+Vector* vectorRead(Stream* const stream);
+
+/*!
+ * @brief Appends to the vector the elements read from the stream until its
+ * end, without knowing their number in advance.
+ * @note The stream holds bare elements (no header). The vector is grown
+ * geometrically and every chunk is read straight into its buffer.
+ * @param vec A pointer to the vector.
+ * @param stream A pointer to the stream.
+ * @return The number of elements appended, or `CDS_NOT_FOUND` if a pointer is
+ * `NULL`, the vector could not be expanded or the stream ended in the middle
+ * of an element (the whole elements read are kept).
+*/
+cds_size vectorAppendFromStream(Vector* const vec, Stream* const stream);
+
+/*!
+ * @brief Writes a tuple to the stream.
+ * @see `vectorWrite`.
+*/
+cds_bool tupleWrite(const Tuple* const tuple, Stream* const stream);
+
+/*!
+ * @brief Reads a tuple written by `tupleWrite` (or a vector written by
+ * `vectorWrite`).
+ * @see `vectorRead`.
+*/
+Tuple* tupleRead(Stream* const stream);
+
+/*!
+ * @brief Writes a singly linked list (the data of its nodes) to the stream.
+ * @see `vectorWrite`.
+*/
+cds_bool sllWrite(const SLList* const list, Stream* const stream);
+
+/*!
+ * @brief Reads a singly linked list written by `sllWrite`.
+ * @param stream A pointer to the stream.
+ * @return A pointer to a new list, or a `NULL` pointer otherwise.
+*/
+SLList* sllRead(Stream* const stream);
+
+/*!
+ * @brief Writes a hash table (its keys and data) to the stream.
+ * @note String keys are written up to their terminating null character and
+ * tuple keys as their elements.
+ * @see `vectorWrite`.
+*/
+cds_bool htWrite(const HashTable* const ht, Stream* const stream);
+
+/*!
+ * @brief Reads a hash table written by `htWrite`.
+ * @note The hash table references its keys and data, so they are stored in
+ * `arena`, which must outlive the hash table.
+ * @param stream A pointer to the stream.
+ * @param hash_fun The hash function of the new hash table.
+ * @param arena A pointer to the arena where the keys and the data are stored.
+ * @return A pointer to a new hash table, or a `NULL` pointer otherwise.
+*/
+HashTable* htRead(Stream* const stream, const HashFunction hash_fun, Arena* const arena);
+
+/*!
+ * @brief Writes a set (its keys) to the stream.
+ * @see `htWrite`.
+*/
+cds_bool setWrite(const Set* const set, Stream* const stream);
+
+/*!
+ * @brief Reads a set written by `setWrite`.
+ * @see `htRead`.
+*/
+Set* setRead(Stream* const stream, const HashFunction hash_fun, Arena* const arena);
+
+#endif // SERIALIZE_H
+
+/*! @} */ // end of serialize group.
+
+#ifdef __cplusplus
+};
+#endif // __cplusplus
@@ -0,0 +1,124 @@
+/*!
+ * @file sort.h
+ * @copyright GNU General Public Licence 3 or Later (GPLv3).
+ * @author Paulo Arruda
+ * @brief Header file containing the sorting API for the linear containers.
+ * @defgroup sort
+ * @{
+*/
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#ifndef SORT_H
+#define SORT_H
+
+#include "common.h"
+#include "comparison_functions.h"
+#include "linear.h"
+
+/*!
+ * @brief Minimum number of elements for which the sorting functions split the
+ * work between threads. Below it, the sort runs on the calling thread.
+*/
+#ifndef SORT_PARALLEL_THRESHOLD
+#define SORT_PARALLEL_THRESHOLD (1UL << 16)
+#endif // SORT_PARALLEL_THRESHOLD
+
+/*!
+ * @brief Maximum number of threads used by the sorting functions. A value of 0
+ * means one thread per online processor.
+*/
+#ifndef SORT_MAX_THREADS
+#define SORT_MAX_THREADS 0
+#endif // SORT_MAX_THREADS
+
+/*!
+ * @brief Sorts the vector in place using a stable parallel merge sort.
+ * @note If `compare` is `intOrderComp` and the data size of the vector is
+ * `sizeof(cds_int)`, the radix sort of `vectorSortNumeric` is used instead.
+ * @param vec A pointer to the vector.
+ * @param compare The trichotomous comparison function of the elements.
+ * @return `true` if the vector was sorted, or `false` if either pointer is `NULL`
+ * or the temporary buffer could not be allocated.
+*/
+cds_bool vectorSort(Vector* const vec, const TComparisonFun compare);
+
+/*!
+ * @brief Sorts a vector of numeric elements in place using a LSD radix sort.
+ * @note Signed integers and floating point numbers are sorted by their numeric
+ * value (negative zero sorts before positive zero and NaNs are placed at the
+ * ends according to their sign bit).
+ * @param vec A pointer to the vector.
+ * @param type The numeric type of the elements.
+ * @return `true` if the vector was sorted, or `false` if the pointer is `NULL`,
+ * the size of `type` differs from the data size of the vector or the temporary
+ * buffer could not be allocated.
+*/
+cds_bool vectorSortNumeric(Vector* const vec, const enum NumericType type);
+
+/*!
+ * @brief Sorts the elements of a vector slice in place, leaving the rest of the
+ * vector untouched.
+ * @see `vectorSort`.
+*/
+cds_bool vectorSliceSort(const VectorSlice* const slice, const TComparisonFun compare);
+
+/*!
+ * @brief Sorts the numeric elements of a vector slice in place.
+ * @see `vectorSortNumeric`.
+*/
+cds_bool vectorSliceSortNumeric(const VectorSlice* const slice, const enum NumericType type);
+
+/*!
+ * @brief Creates a sorted copy of the tuple.
+ * @param tuple A pointer to the tuple.
+ * @param compare The trichotomous comparison function of the elements.
+ * @return A pointer to a new sorted tuple if all memory allocations were
+ * successeful, or a `NULL` pointer otherwise.
+*/
+Tuple* tupleSorted(const Tuple* const tuple, const TComparisonFun compare);
+
+/*!
+ * @brief Creates a sorted copy of a tuple of numeric elements.
+ * @param tuple A pointer to the tuple.
+ * @param type The numeric type of the elements.
+ * @return A pointer to a new sorted tuple if all memory allocations were
+ * successeful and `type` matches the data size of the tuple, or a `NULL`
+ * pointer otherwise.
+*/
+Tuple* tupleSortedNumeric(const Tuple* const tuple, const enum NumericType type);
+
+/*!
+ * @brief Creates a sorted tuple out of the elements of a tuple slice.
+ * @see `tupleSorted`.
+*/
+Tuple* tupleSliceSorted(const TupleSlice* const slice, const TComparisonFun compare);
+
+/*!
+ * @brief Sorts a raw array in place using a stable parallel merge sort.
+ * @param arr A pointer to the first element.
+ * @param length The number of elements.
+ * @param data_size The size of each element.
+ * @param compare The trichotomous comparison function of the elements.
+ * @return `true` if the array was sorted, or `false` otherwise.
+*/
+cds_bool arrSort(void* const arr, const cds_size length, const cds_size data_size,
+                 const TComparisonFun compare);
+
+/*!
+ * @brief Sorts a raw array of numeric elements in place using a LSD radix sort.
+ * @param arr A pointer to the first element.
+ * @param length The number of elements.
+ * @param type The numeric type of the elements.
+ * @return `true` if the array was sorted, or `false` otherwise.
+*/
+cds_bool arrSortNumeric(void* const arr, const cds_size length, const enum NumericType type);
+
+#endif // SORT_H
+
+/*! @} */ // end of sort group.
+
+#ifdef __cplusplus
+};
+#endif // __cplusplus
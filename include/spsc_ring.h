@@ -0,0 +1,158 @@
+/*!
+ * @file spsc_ring.h
+ * @copyright GNU General Public Licence 3 or Later (GPLv3).
+ * @author Paulo Arruda
+ * @brief Header file containing the API for the wait-free single-producer/
+ * single-consumer ring buffer.
+ * @note Exactly one thread (or process) produces and one consumes. The
+ * producer and consumer positions live on cache lines of their own, and each
+ * side keeps a private copy of the other side's position, which it reloads only
+ * when the copy says the ring is full (or empty); hence in steady state the
+ * sides do not share written cache lines beyond the data itself. Every
+ * operation finishes in a bounded number of steps.
+ *
+ * Besides copying elements in and out, the ring hands out contiguous regions of
+ * its buffer: the producer writes in place between `spscReserve` and
+ * `spscCommit`, and the consumer reads in place between `spscPeek` and
+ * `spscRelease`.
+ * @defgroup spsc_ring
+ * @{
+*/
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include "common.h"
+
+/*!
+ * @brief Opaque data type definition for the SPSC ring structure.
+*/
+typedef struct SPSCRing SPSCRing;
+
+/*!
+ * @brief Constructor function for a ring on the heap.
+ * @param capacity The least number of elements of the ring, which is rounded
+ * up to a power of 2.
+ * @param data_size The size of the elements.
+ * @return A pointer to a new empty ring if all memory allocations were
+ * successeful and both parameters are positive, or a `NULL` pointer otherwise.
+*/
+SPSCRing* spscCreate(const cds_size capacity, const cds_size data_size);
+
+/*!
+ * @brief Constructor function for a ring in an anonymous shared mapping, which
+ * child processes created by `fork` share with their parent.
+ * @see `spscCreate`.
+*/
+SPSCRing* spscCreateShared(const cds_size capacity, const cds_size data_size);
+
+/*!
+ * @brief Constructor function for a ring in a shared mapping of the file `fd`
+ * (e.g. a `shm_open` object), which is resized and initialized.
+ * @note Other processes attach to the ring with `spscOpenFd`. The file
+ * descriptor is not closed by the ring.
+ * @see `spscCreate`.
+*/
+SPSCRing* spscCreateFromFd(const cds_int fd, const cds_size capacity, const cds_size data_size);
+
+/*!
+ * @brief Attaches to a ring created by `spscCreateFromFd` on the same file.
+ * @param fd The file descriptor.
+ * @return A pointer to the ring, or a `NULL` pointer if the file does not hold
+ * a ring or the mapping failed.
+*/
+SPSCRing* spscOpenFd(const cds_int fd);
+
+/*!
+ * @brief Destructor function for the SPSC ring structure.
+ * @note Shared rings are unmapped, and remain available to the other processes.
+ * @param ring A pointer to the ring.
+*/
+void spscDelete(SPSCRing* ring);
+
+/*!
+ * @brief Retrieves the number of elements the ring holds.
+*/
+cds_size spscCapacity(const SPSCRing* const ring);
+
+/*!
+ * @brief Retrieves the number of elements in the ring.
+ * @note The value is exact for the producer and consumer only up to the
+ * operations of the other side.
+*/
+cds_size spscLength(const SPSCRing* const ring);
+
+/*!
+ * @brief Copies `data` into the ring (producer).
+ * @return `true` if the element was added, or `false` if the ring is full.
+*/
+cds_bool spscTryPush(SPSCRing* const ring, const void* const data);
+
+/*!
+ * @brief Copies the oldest element out of the ring (consumer).
+ * @return `true` if an element was removed, or `false` if the ring is empty.
+*/
+cds_bool spscTryPop(SPSCRing* const ring, void* const out);
+
+/*!
+ * @brief Copies up to `count` elements of the array `data` into the ring
+ * (producer), publishing them at once.
+ * @return The number of leading elements of `data` added.
+*/
+cds_size spscPushN(SPSCRing* const ring, const void* const data, const cds_size count);
+
+/*!
+ * @brief Copies up to `max` elements out of the ring (consumer), releasing
+ * their slots at once.
+ * @return The number of elements written to `out`.
+*/
+cds_size spscPopN(SPSCRing* const ring, void* const out, const cds_size max);
+
+/*!
+ * @brief Reserves a contiguous region of free slots for the producer.
+ * @note The region ends at the end of the buffer at the latest, so a request
+ * may be granted fewer slots than are free. Nothing is visible to the consumer
+ * until `spscCommit`.
+ * @param ring A pointer to the ring.
+ * @param count The number of slots wanted.
+ * @param[out] pgranted A pointer to where the number of slots granted is
+ * written.
+ * @return A pointer to the first slot of the region, or a `NULL` pointer if the
+ * ring is full.
+*/
+void* spscReserve(SPSCRing* const ring, const cds_size count, cds_size* const pgranted);
+
+/*!
+ * @brief Publishes the first `count` slots of the region returned by
+ * `spscReserve`, which must not exceed the slots granted.
+*/
+void spscCommit(SPSCRing* const ring, const cds_size count);
+
+/*!
+ * @brief Retrieves a contiguous region of elements for the consumer.
+ * @see `spscReserve`.
+ * @param ring A pointer to the ring.
+ * @param max The largest number of elements wanted.
+ * @param[out] pavailable A pointer to where the number of elements of the
+ * region is written.
+ * @return A pointer to the oldest element, or a `NULL` pointer if the ring is
+ * empty.
+*/
+const void* spscPeek(SPSCRing* const ring, const cds_size max, cds_size* const pavailable);
+
+/*!
+ * @brief Frees the first `count` elements of the region returned by
+ * `spscPeek`, which must not exceed the elements available.
+*/
+void spscRelease(SPSCRing* const ring, const cds_size count);
+
+#endif // SPSC_RING_H
+
+/*! @} */ // end of spsc_ring group.
+
+#ifdef __cplusplus
+};
+#endif // __cplusplus
@@ -0,0 +1,135 @@
+/*!
+ * @file thread_pool.h
+ * @copyright GNU General Public Licence 3 or Later (GPLv3).
+ * @author Paulo Arruda
+ * @brief Header file containing the API for the thread pool.
+ * @defgroup thread_pool
+ * @{
+*/
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include "common.h"
+
+/*!
+ * @brief Opaque data type definition for the thread pool structure.
+ * @note The threads of a pool are created once and wait for jobs, so running
+ * a job does not create threads. A job is a number of independent tasks,
+ * which the threads (including the calling one) take from a shared counter.
+*/
+typedef struct ThreadPool ThreadPool;
+
+/*!
+ * @brief Signature of the tasks run by `tpoolRun`.
+ * @param arg The user argument passed to `tpoolRun`.
+ * @param task The index of the task.
+*/
+typedef void (*PoolTaskFun)(void* arg, const cds_size task);
+
+/*!
+ * @brief Opaque data type definition for the fork/join tasks.
+ * @note A forked task is pushed on the work-stealing deque of the thread that
+ * forked it (see `ws_deque.h`). Idle threads steal the oldest tasks of the
+ * other threads, which in a recursive computation are the largest pieces of
+ * work left, so the load balances itself however irregular the recursion is.
+*/
+typedef struct ForkJoinTask ForkJoinTask;
+
+/*!
+ * @brief Signature of the fork/join tasks.
+ * @param arg The user argument passed to `tpoolFork` or `tpoolForkJoin`.
+*/
+typedef void (*ForkJoinFun)(void* arg);
+
+/*!
+ * @brief Number of fork/join tasks per slab of the task pool of each thread.
+*/
+#define FORK_JOIN_TASKS_PER_SLAB 256
+
+/*!
+ * @brief Constructor function for the thread pool structure.
+ * @param num_threads The number of threads running the jobs, including the one
+ * calling `tpoolRun` (`0` means one per online processor).
+ * @return A pointer to a new thread pool if all allocations were successeful
+ * and the threads could be created, or a `NULL` pointer otherwise.
+*/
+ThreadPool* tpoolCreate(const cds_size num_threads);
+
+/*!
+ * @brief Destructor function for the thread pool structure, which joins its
+ * threads.
+ * @note It must not be called while a job runs nor on the default pool.
+ * @param pool A pointer to the thread pool.
+*/
+void tpoolDelete(ThreadPool* pool);
+
+/*!
+ * @brief Retrieves the pool shared by the parallel functions of the library,
+ * which is created on the first call with one thread per online processor.
+ * @return A pointer to the default pool, or a `NULL` pointer if it could not be
+ * created (in which case jobs run on the calling thread).
+*/
+ThreadPool* tpoolDefault(void);
+
+/*!
+ * @brief Retrieves the number of threads running the jobs of the pool.
+*/
+cds_size tpoolNumThreads(const ThreadPool* const pool);
+
+/*!
+ * @brief Runs `fun(arg, task)` for every task in `[0, num_tasks)` and waits for
+ * all of them to finish.
+ * @note Jobs submitted concurrently to the same pool run one after the other.
+ * Jobs submitted from within a task run on the calling thread.
+ * @param pool A pointer to the thread pool (`NULL` for the default pool).
+ * @param fun The task function.
+ * @param arg The user argument passed to `fun`.
+ * @param num_tasks The number of tasks.
+*/
+void tpoolRun(ThreadPool* pool, const PoolTaskFun fun, void* arg, const cds_size num_tasks);
+
+/*!
+ * @brief Runs `fun(arg)` as the root of a fork/join computation on the pool and
+ * waits for it to return.
+ * @note The calling thread runs the root while the other threads steal the
+ * tasks it forks (and the tasks those fork). Computations started from within
+ * a fork/join task join the current one; those started from within a task of
+ * `tpoolRun` run on the calling thread only.
+ * @param pool A pointer to the thread pool (`NULL` for the default pool).
+ * @param fun The root task function.
+ * @param arg The user argument passed to `fun`.
+*/
+void tpoolForkJoin(ThreadPool* pool, const ForkJoinFun fun, void* arg);
+
+/*!
+ * @brief Forks `fun(arg)`, which may then run on any thread of the pool until
+ * it is joined.
+ * @note Every task must be joined by the task that forked it before the latter
+ * returns. Outside of a fork/join computation, or if the task could not be
+ * allocated, `fun(arg)` runs at once.
+ * @param fun The task function.
+ * @param arg The user argument passed to `fun`.
+ * @return A pointer to the task to join, or a `NULL` pointer if the task
+ * already ran.
+*/
+ForkJoinTask* tpoolFork(const ForkJoinFun fun, void* arg);
+
+/*!
+ * @brief Waits for a forked task to finish, running it on the calling thread
+ * if no thread has stolen it, or running other tasks while it runs elsewhere.
+ * @param task A pointer to the task returned by `tpoolFork`, which is released
+ * (`NULL` returns at once).
+*/
+void tpoolJoin(ForkJoinTask* const task);
+
+#endif // THREAD_POOL_H
+
+/*! @} */ // end of thread_pool group.
+
+#ifdef __cplusplus
+};
+#endif // __cplusplus
@@ -0,0 +1,119 @@
+/*!
+ * @file unrolled_list.h
+ * @copyright GNU General Public Licence 3 or Later (GPLv3).
+ * @author Paulo Arruda
+ * @brief Header file containing the API for the unrolled linked list.
+ * @note An unrolled list is a singly linked list whose nodes hold a small array
+ * of elements (`ULL_NODE_SIZE` bytes per node, header included), so a scan
+ * touches one cache miss per few elements instead of one per element. Nodes
+ * are split when an insertion finds them full and merged with their successor
+ * when removals leave them less than half full. Iterate over the list with
+ * `iterCreate(list, UNROLLED_LIST)`.
+ * @defgroup unrolled_list
+ * @{
+*/
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#ifndef UNROLLED_LIST_H
+#define UNROLLED_LIST_H
+
+#include "common.h"
+
+/*!
+ * @brief Size in bytes of the nodes of unrolled lists (four cache lines).
+*/
+#define ULL_NODE_SIZE (4*CDS_CACHE_LINE)
+
+/*!
+ * @brief Least number of elements per node, for large elements.
+*/
+#define ULL_MIN_NODE_CAPACITY 4
+
+/*!
+ * @brief Opaque data type definition for the unrolled list structure.
+*/
+typedef struct UnrolledList UnrolledList;
+
+/*!
+ * @brief Constructor function for the unrolled list structure.
+ * @param data_size The size of the data to be stored.
+ * @return A pointer to a new empty list if all memory allocations were
+ * successeful and `data_size` is positive, or a `NULL` pointer otherwise.
+*/
+UnrolledList* ullCreate(const cds_size data_size);
+
+/*!
+ * @brief Destructor function for the unrolled list structure.
+ * @param list A pointer to the list.
+*/
+void ullDelete(UnrolledList* list);
+
+/*!
+ * @brief Retrieves the number of elements of the list.
+*/
+cds_size ullLength(const UnrolledList* const list);
+
+/*!
+ * @brief Retrieves the number of elements each node of the list holds.
+*/
+cds_size ullNodeCapacity(const UnrolledList* const list);
+
+/*!
+ * @brief Inserts a copy of `data` at the end of the list in amortized constant
+ * time.
+ * @param list A pointer to the list.
+ * @param data A pointer to the data.
+ * @return `true` if the insertion was successeful, or `false` otherwise.
+*/
+cds_bool ullAppend(UnrolledList* list, const void* data);
+
+/*!
+ * @brief Inserts a copy of `data` at the beginning of the list in amortized
+ * constant time.
+ * @see `ullAppend`.
+*/
+cds_bool ullPrepend(UnrolledList* list, const void* data);
+
+/*!
+ * @brief Inserts a copy of `data` before the element at `index`.
+ * @note Reaching the node takes one step per node rather than per element, and
+ * a full node is split in two halves.
+ * @param list A pointer to the list.
+ * @param index The position of the new element, at most the length of the list.
+ * @param data A pointer to the data.
+ * @return `true` if the insertion was successeful, or `false` if the index is
+ * out of range, a pointer is `NULL` or the allocation failed.
+*/
+cds_bool ullInsert(UnrolledList* list, const cds_size index, const void* data);
+
+/*!
+ * @brief Removes the element at `index`.
+ * @note A node left less than half full takes elements from its successor, or
+ * is merged with it when both fit in one node.
+ * @param list A pointer to the list.
+ * @param index The index of the element.
+ * @param[out] out A pointer to where the element is copied, or a `NULL`
+ * pointer to discard it.
+ * @return `true` if the element was removed, or `false` if the index is out of
+ * range or the pointer to the list is `NULL`.
+*/
+cds_bool ullRemove(UnrolledList* list, const cds_size index, void* const out);
+
+/*!
+ * @brief Retrieves the element at `index`.
+ * @param list A pointer to the list.
+ * @param index The index of the element.
+ * @return A pointer to the element, valid until the list is modified, or a
+ * `NULL` pointer if the index is out of range.
+*/
+void* ullGetAt(const UnrolledList* const list, const cds_size index);
+
+#endif // UNROLLED_LIST_H
+
+/*! @} */ // end of unrolled_list group.
+
+#ifdef __cplusplus
+};
+#endif // __cplusplus
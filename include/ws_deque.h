@@ -0,0 +1,94 @@
+/*!
+ * @file ws_deque.h
+ * @copyright GNU General Public Licence 3 or Later (GPLv3).
+ * @author Paulo Arruda
+ * @brief Header file containing the API for the work-stealing deque.
+ * @note The deque is the Chase-Lev deque (with the memory orders of Lê et al.,
+ * "Correct and Efficient Work-Stealing for Weak Memory Models"): its owner
+ * thread pushes and pops pointers at the bottom like a stack, without
+ * compare-and-swap unless a single element is left, while any number of
+ * thieves take the oldest pointers from the top. The buffer is a ring that
+ * doubles when full; buffers outgrown are kept until the deque is deleted,
+ * since a thief may still be reading them.
+ * @defgroup ws_deque
+ * @{
+*/
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#ifndef WS_DEQUE_H
+#define WS_DEQUE_H
+
+#include "common.h"
+
+/*!
+ * @brief Default number of elements of the buffer of a deque.
+*/
+#define WSDEQUE_DEFAULT_CAPACITY 256
+
+/*!
+ * @brief Opaque data type definition for the work-stealing deque structure.
+*/
+typedef struct WSDeque WSDeque;
+
+/*!
+ * @brief Constructor function for the work-stealing deque structure.
+ * @param capacity The initial number of elements of the buffer, which is
+ * rounded up to a power of 2 (`0` means `WSDEQUE_DEFAULT_CAPACITY`).
+ * @return A pointer to a new empty deque if all memory allocations were
+ * successeful, or a `NULL` pointer otherwise.
+*/
+WSDeque* wsdequeCreate(const cds_size capacity);
+
+/*!
+ * @brief Destructor function for the work-stealing deque structure.
+ * @note No thread may be using the deque. The pointers left in it are not
+ * freed.
+ * @param deque A pointer to the deque.
+*/
+void wsdequeDelete(WSDeque* deque);
+
+/*!
+ * @brief Retrieves the number of elements in the deque.
+ * @note The value is a snapshot, which may be stale when thieves use the
+ * deque.
+*/
+cds_size wsdequeLength(const WSDeque* const deque);
+
+/*!
+ * @brief Pushes `item` at the bottom of the deque, growing its buffer if it is
+ * full.
+ * @note Only the owner thread may push.
+ * @param deque A pointer to the deque.
+ * @param item The (not `NULL`) pointer pushed.
+ * @return `true` if the pointer was pushed, or `false` if a pointer is `NULL`
+ * or the buffer could not grow.
+*/
+cds_bool wsdequePush(WSDeque* const deque, void* const item);
+
+/*!
+ * @brief Pops the newest pointer, at the bottom of the deque.
+ * @note Only the owner thread may pop.
+ * @param deque A pointer to the deque.
+ * @return The pointer popped, or a `NULL` pointer if the deque is empty or a
+ * thief took the last element.
+*/
+void* wsdequePop(WSDeque* const deque);
+
+/*!
+ * @brief Steals the oldest pointer, at the top of the deque.
+ * @note Any thread may steal.
+ * @param deque A pointer to the deque.
+ * @return The pointer stolen, or a `NULL` pointer if the deque is empty or
+ * another thread took the element first.
+*/
+void* wsdequeSteal(WSDeque* const deque);
+
+#endif // WS_DEQUE_H
+
+/*! @} */ // end of ws_deque group.
+
+#ifdef __cplusplus
+};
+#endif // __cplusplus
@@ -0,0 +1,121 @@
+/*!
+ * @file arena.c
+ * @copyright GNU General Public Licence 3 or Later (GPLv3).
+ * @author Paulo Arruda
+ * @brief Implementation of the arena allocator.
+*/
+
+#include <stddef.h>
+#include "../include/arena.h"
+
+#define ARENA_ALIGNMENT _Alignof(max_align_t)
+#define ARENA_ROUND(bytes) (((bytes) + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1))
+
+/**
+ * Blocks are chained from the newest to the oldest. The header is padded so
+ * that the memory following it is aligned for any type.
+*/
+typedef struct ArenaBlock{
+    struct ArenaBlock* previous;
+    cds_size size;
+    cds_size used;
+    _Alignas(max_align_t) cds_uchar data[];
+}ArenaBlock;
+
+struct Arena{
+    cds_size block_size;
+    cds_size used;
+    ArenaBlock* current;
+};
+
+static ArenaBlock* _arenaNewBlock(const cds_size size, ArenaBlock* const previous){
+    if (size > (cds_size) -1 - sizeof(ArenaBlock)){
+        return (ArenaBlock*) NULL;
+    }
+    ArenaBlock* block = (ArenaBlock*) malloc(sizeof(ArenaBlock) + size);
+    if (!block){
+        return (ArenaBlock*) NULL;
+    }
+    block->previous = previous;
+    block->size = size;
+    block->used = 0;
+    return block;
+}
+
+Arena* arenaCreate(const cds_size block_size){
+    if (!block_size || ARENA_ROUND(block_size) < block_size){
+        return (Arena*) NULL;
+    }
+    Arena* new_arena = (Arena*) malloc(sizeof(Arena));
+    if (!new_arena){
+        return (Arena*) NULL;
+    }
+    new_arena->block_size = ARENA_ROUND(block_size);
+    new_arena->used = 0;
+    new_arena->current = _arenaNewBlock(new_arena->block_size, (ArenaBlock*) NULL);
+    if (!new_arena->current){
+        free(new_arena);
+        return (Arena*) NULL;
+    }
+    return new_arena;
+}
+
+/**
+ * Frees the blocks newer than `last`.
+*/
+static void _arenaFreeUntil(Arena* const arena, const ArenaBlock* const last){
+    while (arena->current != last){
+        ArenaBlock* previous = arena->current->previous;
+        free(arena->current);
+        arena->current = previous;
+    }
+}
+
+void arenaDelete(Arena* arena){
+    if (!arena){
+        return;
+    }
+    _arenaFreeUntil(arena, (ArenaBlock*) NULL);
+    free(arena);
+}
+
+void* arenaAlloc(Arena* const arena, const cds_size bytes){
+    if (!arena){
+        return NULL;
+    }
+    const cds_size rounded = ARENA_ROUND(bytes ? bytes : 1);
+    if (rounded < bytes){
+        return NULL;
+    }
+    ArenaBlock* block = arena->current;
+    if (block->size - block->used < rounded){
+        // oversized requests get a block of their own, the others a fresh block.
+        const cds_size size = rounded > arena->block_size ? rounded : arena->block_size;
+        block = _arenaNewBlock(size, arena->current);
+        if (!block){
+            return NULL;
+        }
+        arena->current = block;
+    }
+    void* ptr = block->data + block->used;
+    block->used += rounded;
+    arena->used += rounded;
+    return ptr;
+}
+
+void arenaReset(Arena* const arena){
+    if (!arena){
+        return;
+    }
+    ArenaBlock* first = arena->current;
+    while (first->previous){
+        first = first->previous;
+    }
+    _arenaFreeUntil(arena, first);
+    first->used = 0;
+    arena->used = 0;
+}
+
+cds_size arenaUsed(const Arena* const arena){
+    return arena ? arena->used : 0;
+}
@@ -0,0 +1,393 @@
+/*!
+ * @file bitset.c
+ * @copyright GNU General Public Licence 3 or Later (GPLv3).
+ * @author Paulo Arruda
+ * @brief Implementation of the bitset API.
+*/
+
+#include "../include/bitset.h"
+#include "../include/_private_linear.h"
+#include "../include/_private_memory.h"
+#include "../include/_private_simd.h"
+
+#define WORD_BITS 64
+#define WORD_OF(index) ((index) / WORD_BITS)
+#define BIT_OF(index) ((uint64_t) 1 << ((index) % WORD_BITS))
+#define NUM_WORDS(length) (((length) + WORD_BITS - 1) / WORD_BITS)
+
+/**
+ * Definition of the bitset structure. The bits after `length` in the last word
+ * are kept cleared, so counting and comparing never mask them.
+*/
+struct Bitset{
+    cds_size length;        // bits
+    cds_size capacity;      // words
+    uint64_t* words;
+};
+
+static const AllocOptions _bitset_options = {CDS_CACHE_LINE, HUGE_PAGES_NONE};
+
+/**
+ * Mask of the bits of the last word that are in use.
+*/
+static inline uint64_t _tailMask(const cds_size length){
+    return length % WORD_BITS ? BIT_OF(length) - 1 : ~(uint64_t) 0;
+}
+
+static cds_bool _bitsetResizeWords(Bitset* const bs, const cds_size capacity){
+    uint64_t* words = (uint64_t*) _cdsRealloc(bs->words, bs->capacity*sizeof(uint64_t),
+                                              capacity*sizeof(uint64_t), &_bitset_options);
+    if (!words){
+        return false;
+    }
+    bs->words = words;
+    bs->capacity = capacity;
+    return true;
+}
+
+Bitset* bitsetCreate(const cds_size length){
+    Bitset* bs = (Bitset*) malloc(sizeof(Bitset));
+    if (!bs){
+        return (Bitset*) NULL;
+    }
+    cds_size capacity = NUM_WORDS(length) ? NUM_WORDS(length) : 1;
+    bs->words = (uint64_t*) _cdsCalloc(capacity*sizeof(uint64_t), &_bitset_options);
+    if (!bs->words){
+        free(bs);
+        return (Bitset*) NULL;
+    }
+    bs->length = length;
+    bs->capacity = capacity;
+    return bs;
+}
+
+Bitset* bitsetFromVector(const Vector* const vec){
+    if (!vec || sizeof(cds_bool) != vec->data_size){
+        return (Bitset*) NULL;
+    }
+    Bitset* bs = bitsetCreate(vec->length);
+    if (!bs){
+        return (Bitset*) NULL;
+    }
+    const cds_bool* bools = (const cds_bool*) vec->container;
+    for (cds_size i=0; i<vec->length; i++){
+        bs->words[WORD_OF(i)] |= (uint64_t) bools[i] << (i % WORD_BITS);
+    }
+    return bs;
+}
+
+Bitset* bitsetCopy(const Bitset* const bs){
+    if (!bs){
+        return (Bitset*) NULL;
+    }
+    Bitset* copy = bitsetCreate(bs->length);
+    if (!copy){
+        return (Bitset*) NULL;
+    }
+    (void) memcpy(copy->words, bs->words, NUM_WORDS(bs->length)*sizeof(uint64_t));
+    return copy;
+}
+
+void bitsetDelete(Bitset* bs){
+    if (!bs){
+        return;
+    }
+    _cdsFree(bs->words, bs->capacity*sizeof(uint64_t), &_bitset_options);
+    free(bs);
+}
+
+cds_size bitsetLength(const Bitset* const bs){
+    return bs ? bs->length : 0;
+}
+
+cds_size bitsetCapacity(const Bitset* const bs){
+    return bs ? bs->capacity*WORD_BITS : 0;
+}
+
+cds_bool bitsetReserve(Bitset* const bs, const cds_size min_capacity){
+    if (!bs){
+        return false;
+    }
+    cds_size words = NUM_WORDS(min_capacity);
+    if (words <= bs->capacity){
+        return true;
+    }
+    cds_size pow = _log2(words - 1) + 1;
+    if (pow >= _MAX_POW2_){
+        return false;
+    }
+    return _bitsetResizeWords(bs, (cds_size) 1 << pow);
+}
+
+cds_bool bitsetResize(Bitset* const bs, const cds_size length){
+    if (!bitsetReserve(bs, length)){
+        return false;
+    }
+    cds_size used = NUM_WORDS(bs->length);
+    if (length > bs->length){
+        (void) memset(bs->words + used, 0, (NUM_WORDS(length) - used)*sizeof(uint64_t));
+    }else if (length){
+        // the bits cut off the last word must stay cleared.
+        (void) memset(bs->words + NUM_WORDS(length), 0, (used - NUM_WORDS(length))*sizeof(uint64_t));
+        bs->words[WORD_OF(length - 1)] &= _tailMask(length);
+    }else{
+        (void) memset(bs->words, 0, used*sizeof(uint64_t));
+    }
+    bs->length = length;
+    return true;
+}
+
+cds_bool bitsetAppend(Bitset* const bs, const cds_bool bit){
+    if (!bs){
+        return false;
+    }
+    if (bs->length + 1 > bs->capacity*WORD_BITS && !_bitsetResizeWords(bs, 2*bs->capacity)){
+        return false;
+    }
+    if (!(bs->length % WORD_BITS)){
+        bs->words[WORD_OF(bs->length)] = 0;
+    }
+    bs->words[WORD_OF(bs->length)] |= (uint64_t) bit << (bs->length % WORD_BITS);
+    bs->length++;
+    return true;
+}
+
+/**
+ * SINGLE BITS
+ * -----------
+*/
+
+cds_bool bitsetSet(Bitset* const bs, const cds_size index){
+    if (!bs || index >= bs->length){
+        return false;
+    }
+    bs->words[WORD_OF(index)] |= BIT_OF(index);
+    return true;
+}
+
+cds_bool bitsetClear(Bitset* const bs, const cds_size index){
+    if (!bs || index >= bs->length){
+        return false;
+    }
+    bs->words[WORD_OF(index)] &= ~BIT_OF(index);
+    return true;
+}
+
+cds_bool bitsetFlip(Bitset* const bs, const cds_size index){
+    if (!bs || index >= bs->length){
+        return false;
+    }
+    bs->words[WORD_OF(index)] ^= BIT_OF(index);
+    return true;
+}
+
+cds_bool bitsetTest(const Bitset* const bs, const cds_size index){
+    if (!bs || index >= bs->length){
+        return false;
+    }
+    return 0 != (bs->words[WORD_OF(index)] & BIT_OF(index));
+}
+
+void bitsetSetAll(Bitset* const bs){
+    if (!bs || !bs->length){
+        return;
+    }
+    cds_size words = NUM_WORDS(bs->length);
+    (void) memset(bs->words, 0xff, words*sizeof(uint64_t));
+    bs->words[words - 1] = _tailMask(bs->length);
+}
+
+void bitsetClearAll(Bitset* const bs){
+    if (!bs){
+        return;
+    }
+    (void) memset(bs->words, 0, NUM_WORDS(bs->length)*sizeof(uint64_t));
+}
+
+/**
+ * COUNTING AND SEARCHING
+ * ----------------------
+ * Population counts are compiled twice: with the `popcnt` instruction for
+ * processors that have AVX2 (all of which have it), and with the portable
+ * builtin otherwise.
+*/
+
+#define DEFINE_COUNT(suffix, target)                                                        \
+target static cds_size _count##suffix(const uint64_t* const words, const cds_size num_words){ \
+    cds_size count = 0;                                                                     \
+    for (cds_size i=0; i<num_words; i++){                                                   \
+        count += CDS_POPCOUNT64(words[i]);                                                  \
+    }                                                                                       \
+    return count;                                                                           \
+}
+DEFINE_COUNT(Scalar, )
+#ifdef __CDS_X86_SIMD__
+DEFINE_COUNT(Avx2, CDS_TARGET_AVX2)
+#define COUNT_DISPATCH(words, num_words) \
+    (CDS_HAS_AVX2() ? _countAvx2(words, num_words) : _countScalar(words, num_words))
+#else
+#define COUNT_DISPATCH(words, num_words) _countScalar(words, num_words)
+#endif // __CDS_X86_SIMD__
+#undef DEFINE_COUNT
+
+cds_size bitsetCount(const Bitset* const bs){
+    if (!bs){
+        return 0;
+    }
+    return COUNT_DISPATCH(bs->words, NUM_WORDS(bs->length));
+}
+
+cds_size bitsetRank(const Bitset* const bs, const cds_size index){
+    if (!bs){
+        return 0;
+    }
+    if (index >= bs->length){
+        return bitsetCount(bs);
+    }
+    cds_size rank = COUNT_DISPATCH(bs->words, WORD_OF(index));
+    return rank + CDS_POPCOUNT64(bs->words[WORD_OF(index)] & (BIT_OF(index) - 1));
+}
+
+cds_size bitsetSelect(const Bitset* const bs, const cds_size rank){
+    if (!bs){
+        return CDS_NOT_FOUND;
+    }
+    cds_size remaining = rank;
+    cds_size words = NUM_WORDS(bs->length);
+    for (cds_size w=0; w<words; w++){
+        uint64_t word = bs->words[w];
+        cds_size count = CDS_POPCOUNT64(word);
+        if (remaining >= count){
+            remaining -= count;
+            continue;
+        }
+        // drops the lowest set bits until the one searched is the lowest.
+        for (; remaining; remaining--){
+            word &= word - 1;
+        }
+        return w*WORD_BITS + CDS_CTZ64(word);
+    }
+    return CDS_NOT_FOUND;
+}
+
+/**
+ * Retrieves the first bit at or after `from` that is set in the words xored
+ * with `flip` (0 to find set bits, all ones to find cleared bits).
+*/
+static cds_size _nextBit(const Bitset* const bs, const cds_size from, const uint64_t flip){
+    if (!bs || from >= bs->length){
+        return CDS_NOT_FOUND;
+    }
+    cds_size words = NUM_WORDS(bs->length);
+    cds_size w = WORD_OF(from);
+    uint64_t word = (bs->words[w] ^ flip) & ~(BIT_OF(from) - 1);
+    while (!word){
+        if (++w >= words){
+            return CDS_NOT_FOUND;
+        }
+        word = bs->words[w] ^ flip;
+    }
+    cds_size index = w*WORD_BITS + CDS_CTZ64(word);
+    return index < bs->length ? index : CDS_NOT_FOUND;
+}
+
+cds_size bitsetNextSet(const Bitset* const bs, const cds_size from){
+    return _nextBit(bs, from, 0);
+}
+
+cds_size bitsetNextClear(const Bitset* const bs, const cds_size from){
+    return _nextBit(bs, from, ~(uint64_t) 0);
+}
+
+/**
+ * BULK OPERATIONS
+ * ---------------
+ * The AVX2 versions process four words per iteration and finish with the
+ * scalar loop.
+*/
+
+#define DEFINE_SCALAR_BULK(name, expr)                                                      \
+static void _##name##Scalar(uint64_t* const dst, const uint64_t* const src,                 \
+                            const cds_size start, const cds_size num_words){                \
+    for (cds_size i=start; i<num_words; i++){                                               \
+        const uint64_t a = dst[i];                                                          \
+        const uint64_t b = src[i];                                                          \
+        dst[i] = (expr);                                                                    \
+    }                                                                                       \
+}
+DEFINE_SCALAR_BULK(and, a & b)
+DEFINE_SCALAR_BULK(or, a | b)
+DEFINE_SCALAR_BULK(xor, a ^ b)
+DEFINE_SCALAR_BULK(andNot, a & ~b)
+#undef DEFINE_SCALAR_BULK
+
+#ifdef __CDS_X86_SIMD__
+#define DEFINE_AVX2_BULK(name, op)                                                          \
+CDS_TARGET_AVX2 static void _##name##Avx2(uint64_t* const dst, const uint64_t* const src,   \
+                                          const cds_size num_words){                        \
+    cds_size i = 0;                                                                         \
+    for (; i + 4 <= num_words; i+=4){                                                       \
+        __m256i a = _mm256_loadu_si256((const __m256i*) (dst + i));                         \
+        __m256i b = _mm256_loadu_si256((const __m256i*) (src + i));                         \
+        _mm256_storeu_si256((__m256i*) (dst + i), op);                                      \
+    }                                                                                       \
+    _##name##Scalar(dst, src, i, num_words);                                                \
+}
+DEFINE_AVX2_BULK(and, _mm256_and_si256(a, b))
+DEFINE_AVX2_BULK(or, _mm256_or_si256(a, b))
+DEFINE_AVX2_BULK(xor, _mm256_xor_si256(a, b))
+DEFINE_AVX2_BULK(andNot, _mm256_andnot_si256(b, a))
+#undef DEFINE_AVX2_BULK
+#define BULK_DISPATCH(name, dst, src, num_words)                                            \
+    (CDS_HAS_AVX2() ? _##name##Avx2(dst, src, num_words) : _##name##Scalar(dst, src, 0, num_words))
+#else
+#define BULK_DISPATCH(name, dst, src, num_words) _##name##Scalar(dst, src, 0, num_words)
+#endif // __CDS_X86_SIMD__
+
+#define DEFINE_BULK(fun_name, name)                                                         \
+cds_bool fun_name(Bitset* const dst, const Bitset* const src){                              \
+    if (!dst || !src || dst->length != src->length){                                        \
+        return false;                                                                       \
+    }                                                                                       \
+    BULK_DISPATCH(name, dst->words, src->words, NUM_WORDS(dst->length));                    \
+    return true;                                                                            \
+}
+DEFINE_BULK(bitsetAnd, and)
+DEFINE_BULK(bitsetOr, or)
+DEFINE_BULK(bitsetXor, xor)
+DEFINE_BULK(bitsetAndNot, andNot)
+#undef DEFINE_BULK
+
+void bitsetNot(Bitset* const bs){
+    if (!bs || !bs->length){
+        return;
+    }
+    cds_size words = NUM_WORDS(bs->length);
+    for (cds_size i=0; i<words; i++){
+        bs->words[i] = ~bs->words[i];
+    }
+    bs->words[words - 1] &= _tailMask(bs->length);
+}
+
+cds_size bitsetToIndices(const Bitset* const bs, Vector* const indices){
+    if (!bs || !indices || sizeof(cds_size) != indices->data_size){
+        return CDS_NOT_FOUND;
+    }
+    cds_size count = bitsetCount(bs);
+    if (!vectorReserve(indices, indices->length + count)){
+        return CDS_NOT_FOUND;
+    }
+    cds_size* out = (cds_size*) indices->container + indices->length;
+    cds_size words = NUM_WORDS(bs->length);
+    for (cds_size w=0; w<words; w++){
+        for (uint64_t word = bs->words[w]; word; word &= word - 1){
+            *out++ = w*WORD_BITS + CDS_CTZ64(word);
+        }
+    }
+    indices->length += count;
+    return count;
+}
+
+const uint64_t* bitsetWords(const Bitset* const bs){
+    return bs ? bs->words : (const uint64_t*) NULL;
+}
@@ -0,0 +1,416 @@
+/*!
+ * @file blocking_queue.c
+ * @copyright GNU General Public Licence 3 or Later (GPLv3).
+ * @author Paulo Arruda
+ * @brief Implementation of the blocking producer/consumer queue.
+*/
+
+#include <limits.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#ifdef __linux__
+    #include <unistd.h>
+    #include <sys/syscall.h>
+    #include <linux/futex.h>
+#endif // __linux__
+#include "../include/blocking_queue.h"
+#include "../include/_private_memory.h"
+#include "../include/_private_sync.h"
+
+/**
+ * EVENTS
+ * ------
+ * An event is a 32-bit counter bumped by every wake-up. A thread sleeps only
+ * while the counter still holds the value it read before checking the queue,
+ * so a wake-up between the check and the sleep is never lost. Sleepers are
+ * counted, and wakers skip the system call when there are none.
+*/
+typedef struct Event{
+    atomic_uint sequence;
+    atomic_uint sleepers;
+#ifndef __linux__
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+#endif // __linux__
+}Event;
+
+/**
+ * The lock guards the ring; `length` is also read without the lock by threads
+ * deciding whether to sleep. Each event has a cache line of its own, since
+ * producers write one and consumers the other.
+*/
+struct BlockingQueue{
+    pthread_mutex_t lock;
+    cds_uchar* buffer;
+    cds_size head;              // index of the oldest element
+    atomic_size_t length;
+    cds_size size;              // number of elements the buffer holds
+    cds_size capacity;          // 0 if the queue is unbounded
+    cds_size data_size;
+    atomic_bool closed;
+    _Alignas(CDS_CACHE_LINE) Event not_empty;
+    _Alignas(CDS_CACHE_LINE) Event not_full;
+};
+
+static const AllocOptions _bqueue_options = {CDS_CACHE_LINE, HUGE_PAGES_NONE};
+
+static void _eventInit(Event* const event){
+    atomic_init(&event->sequence, 0);
+    atomic_init(&event->sleepers, 0);
+#ifndef __linux__
+    pthread_condattr_t attr;
+    (void) pthread_condattr_init(&attr);
+    (void) pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    (void) pthread_mutex_init(&event->lock, NULL);
+    (void) pthread_cond_init(&event->changed, &attr);
+    (void) pthread_condattr_destroy(&attr);
+#endif // __linux__
+}
+
+static void _eventDestroy(Event* const event){
+#ifndef __linux__
+    (void) pthread_cond_destroy(&event->changed);
+    (void) pthread_mutex_destroy(&event->lock);
+#else
+    (void) event;
+#endif // __linux__
+}
+
+/**
+ * Wakes up to `count` sleepers. The fence pairs with the one of
+ * `_bqueueWait`: either the waker sees the new sleeper, or the sleeper sees
+ * the change of the queue and does not sleep.
+*/
+static void _eventWake(Event* const event, const cds_size count){
+    atomic_thread_fence(memory_order_seq_cst);
+    if (!atomic_load_explicit(&event->sleepers, memory_order_relaxed)){
+        return;
+    }
+#ifdef __linux__
+    (void) atomic_fetch_add_explicit(&event->sequence, 1, memory_order_release);
+    (void) syscall(SYS_futex, (void*) &event->sequence, FUTEX_WAKE_PRIVATE,
+                   count < INT_MAX ? (int) count : INT_MAX, NULL, NULL, 0);
+#else
+    (void) count;
+    (void) pthread_mutex_lock(&event->lock);
+    (void) atomic_fetch_add_explicit(&event->sequence, 1, memory_order_release);
+    (void) pthread_cond_broadcast(&event->changed);
+    (void) pthread_mutex_unlock(&event->lock);
+#endif // __linux__
+}
+
+/**
+ * Sleeps while the counter of the event is `sequence`, at most until
+ * `deadline` (on the monotonic clock) unless it is `NULL`. Spurious returns
+ * are allowed; the caller checks the queue again.
+*/
+static void _eventSleep(Event* const event, const cds_uint32 sequence, const struct timespec* const deadline){
+#ifdef __linux__
+    struct timespec remaining, *ptimeout = (struct timespec*) NULL;
+    if (deadline){
+        struct timespec now;
+        (void) clock_gettime(CLOCK_MONOTONIC, &now);
+        remaining.tv_sec = deadline->tv_sec - now.tv_sec;
+        remaining.tv_nsec = deadline->tv_nsec - now.tv_nsec;
+        if (remaining.tv_nsec < 0){
+            remaining.tv_sec--;
+            remaining.tv_nsec += 1000000000L;
+        }
+        if (remaining.tv_sec < 0){
+            return;
+        }
+        ptimeout = &remaining;
+    }
+    (void) syscall(SYS_futex, (void*) &event->sequence, FUTEX_WAIT_PRIVATE, sequence, ptimeout, NULL, 0);
+#else
+    (void) pthread_mutex_lock(&event->lock);
+    if (sequence == atomic_load_explicit(&event->sequence, memory_order_relaxed)){
+        if (deadline){
+            (void) pthread_cond_timedwait(&event->changed, &event->lock, deadline);
+        }
+        else{
+            (void) pthread_cond_wait(&event->changed, &event->lock);
+        }
+    }
+    (void) pthread_mutex_unlock(&event->lock);
+#endif // __linux__
+}
+
+/**
+ * TIMEOUTS
+ * --------
+ * Timeouts are turned into deadlines on the monotonic clock once, so that the
+ * wake-ups that find nothing to do do not extend the wait.
+*/
+
+static const struct timespec* _bqueueDeadline(const cds_long timeout, struct timespec* const deadline){
+    if (timeout < 0){
+        return (const struct timespec*) NULL;
+    }
+    (void) clock_gettime(CLOCK_MONOTONIC, deadline);
+    deadline->tv_sec += timeout / 1000;
+    deadline->tv_nsec += (timeout % 1000) * 1000000L;
+    if (deadline->tv_nsec >= 1000000000L){
+        deadline->tv_sec++;
+        deadline->tv_nsec -= 1000000000L;
+    }
+    return deadline;
+}
+
+static cds_bool _bqueueExpired(const struct timespec* const deadline){
+    if (!deadline){
+        return false;
+    }
+    struct timespec now;
+    (void) clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec > deadline->tv_sec || (now.tv_sec == deadline->tv_sec && now.tv_nsec >= deadline->tv_nsec);
+}
+
+BlockingQueue* bqueueCreate(const cds_size capacity, const cds_size data_size){
+    cds_size size = capacity ? capacity : BQUEUE_DEFAULT_CAPACITY;
+    if (!data_size || (cds_size) -1 / data_size < size){
+        return (BlockingQueue*) NULL;
+    }
+    BlockingQueue* queue = (BlockingQueue*) _cdsAlloc(sizeof(BlockingQueue), &_bqueue_options);
+    if (!queue){
+        return (BlockingQueue*) NULL;
+    }
+    queue->buffer = (cds_uchar*) _cdsAlloc(size*data_size, &_bqueue_options);
+    if (!queue->buffer){
+        _cdsFree(queue, sizeof(BlockingQueue), &_bqueue_options);
+        return (BlockingQueue*) NULL;
+    }
+    (void) pthread_mutex_init(&queue->lock, NULL);
+    queue->head = 0;
+    atomic_init(&queue->length, 0);
+    queue->size = size;
+    queue->capacity = capacity;
+    queue->data_size = data_size;
+    atomic_init(&queue->closed, false);
+    _eventInit(&queue->not_empty);
+    _eventInit(&queue->not_full);
+    return queue;
+}
+
+void bqueueDelete(BlockingQueue* queue){
+    if (!queue){
+        return;
+    }
+    _eventDestroy(&queue->not_full);
+    _eventDestroy(&queue->not_empty);
+    (void) pthread_mutex_destroy(&queue->lock);
+    _cdsFree(queue->buffer, queue->size*queue->data_size, &_bqueue_options);
+    _cdsFree(queue, sizeof(BlockingQueue), &_bqueue_options);
+}
+
+cds_size bqueueCapacity(const BlockingQueue* const queue){
+    return queue ? queue->capacity : 0;
+}
+
+cds_size bqueueLength(const BlockingQueue* const queue){
+    return queue ? atomic_load_explicit(&((BlockingQueue*) queue)->length, memory_order_relaxed) : 0;
+}
+
+void bqueueClose(BlockingQueue* const queue){
+    if (!queue){
+        return;
+    }
+    (void) pthread_mutex_lock(&queue->lock);
+    atomic_store_explicit(&queue->closed, true, memory_order_relaxed);
+    (void) pthread_mutex_unlock(&queue->lock);
+    _eventWake(&queue->not_empty, (cds_size) -1);
+    _eventWake(&queue->not_full, (cds_size) -1);
+}
+
+cds_bool bqueueIsClosed(const BlockingQueue* const queue){
+    return !queue || atomic_load_explicit(&((BlockingQueue*) queue)->closed, memory_order_relaxed);
+}
+
+/**
+ * RING
+ * ----
+ * The following functions are called with the lock held. Elements are copied
+ * in at most two runs, before and after the end of the buffer.
+*/
+
+/**
+ * Doubles the buffer of an unbounded queue, unwrapping the elements.
+*/
+static cds_bool _bqueueGrow(BlockingQueue* const queue){
+    const cds_size length = atomic_load_explicit(&queue->length, memory_order_relaxed);
+    if ((cds_size) -1 / 2 / queue->data_size < queue->size){
+        return false;
+    }
+    cds_uchar* buffer = (cds_uchar*) _cdsAlloc(2*queue->size*queue->data_size, &_bqueue_options);
+    if (!buffer){
+        return false;
+    }
+    const cds_size first = queue->size - queue->head < length ? queue->size - queue->head : length;
+    memcpy(buffer, queue->buffer + queue->head*queue->data_size, first*queue->data_size);
+    memcpy(buffer + first*queue->data_size, queue->buffer, (length - first)*queue->data_size);
+    _cdsFree(queue->buffer, queue->size*queue->data_size, &_bqueue_options);
+    queue->buffer = buffer;
+    queue->head = 0;
+    queue->size *= 2;
+    return true;
+}
+
+/**
+ * Copies up to `count` elements of `data` to the back of the ring, growing the
+ * buffer of an unbounded queue. Returns the number of elements copied.
+*/
+static cds_size _bqueuePushSome(BlockingQueue* const queue, const void* const data, const cds_size count){
+    cds_size length = atomic_load_explicit(&queue->length, memory_order_relaxed);
+    if (!queue->capacity){
+        while (queue->size - length < count && _bqueueGrow(queue)){}
+    }
+    const cds_size n = queue->size - length < count ? queue->size - length : count;
+    cds_size tail = queue->head + length;
+    tail -= tail >= queue->size ? queue->size : 0;
+    const cds_size first = queue->size - tail < n ? queue->size - tail : n;
+    memcpy(queue->buffer + tail*queue->data_size, data, first*queue->data_size);
+    memcpy(queue->buffer, CDS_BYTE_OFFSET(data, (first*queue->data_size)), (n - first)*queue->data_size);
+    atomic_store_explicit(&queue->length, length + n, memory_order_relaxed);
+    return n;
+}
+
+/**
+ * Copies up to `max` elements from the front of the ring to `out`. Returns the
+ * number of elements copied.
+*/
+static cds_size _bqueuePopSome(BlockingQueue* const queue, void* const out, const cds_size max){
+    const cds_size length = atomic_load_explicit(&queue->length, memory_order_relaxed);
+    const cds_size n = length < max ? length : max;
+    const cds_size first = queue->size - queue->head < n ? queue->size - queue->head : n;
+    memcpy(out, queue->buffer + queue->head*queue->data_size, first*queue->data_size);
+    memcpy(CDS_BYTE_OFFSET(out, (first*queue->data_size)), queue->buffer, (n - first)*queue->data_size);
+    queue->head += n;
+    queue->head -= queue->head >= queue->size ? queue->size : 0;
+    atomic_store_explicit(&queue->length, length - n, memory_order_relaxed);
+    return n;
+}
+
+/**
+ * WAITING
+ * -------
+*/
+
+/**
+ * Whether a producer (or consumer) would find the queue full (or empty).
+*/
+static cds_bool _bqueueBlocked(BlockingQueue* const queue, const cds_bool push){
+    if (atomic_load_explicit(&queue->closed, memory_order_relaxed)){
+        return false;
+    }
+    const cds_size length = atomic_load_explicit(&queue->length, memory_order_relaxed);
+    return push ? queue->capacity && length >= queue->capacity : !length;
+}
+
+/**
+ * Waits after a failed attempt: backs off for the first attempts, then sleeps
+ * on the event until it is signalled or the deadline passes. Returns `false`
+ * once the deadline has passed.
+*/
+static cds_bool _bqueueWait(BlockingQueue* const queue, const cds_bool push, cds_size* const round,
+                            const struct timespec* const deadline){
+    if (*round < CDS_SPIN_LIMIT){
+        _cdsBackoff(round);
+        return !_bqueueExpired(deadline);
+    }
+    Event* event = push ? &queue->not_full : &queue->not_empty;
+    const cds_uint32 sequence = atomic_load_explicit(&event->sequence, memory_order_acquire);
+    (void) atomic_fetch_add(&event->sleepers, 1);
+    atomic_thread_fence(memory_order_seq_cst);
+    if (_bqueueBlocked(queue, push)){
+        _eventSleep(event, sequence, deadline);
+    }
+    (void) atomic_fetch_sub(&event->sleepers, 1);
+    return !_bqueueExpired(deadline);
+}
+
+cds_bool bqueuePush(BlockingQueue* const queue, const void* const data, const cds_long timeout){
+    return 1 == bqueuePushN(queue, data, 1, timeout);
+}
+
+cds_size bqueuePushN(BlockingQueue* const queue, const void* const data, const cds_size count,
+                     const cds_long timeout){
+    if (!queue || !data){
+        return 0;
+    }
+    struct timespec buffer;
+    const struct timespec* deadline = (const struct timespec*) NULL;
+    cds_bool timed = false;
+    cds_size pushed = 0, round = 0;
+    while (pushed < count){
+        (void) pthread_mutex_lock(&queue->lock);
+        if (atomic_load_explicit(&queue->closed, memory_order_relaxed)){
+            (void) pthread_mutex_unlock(&queue->lock);
+            break;
+        }
+        cds_size n = _bqueuePushSome(queue, CDS_BYTE_OFFSET(data, (pushed*queue->data_size)), count - pushed);
+        (void) pthread_mutex_unlock(&queue->lock);
+        if (n){
+            _eventWake(&queue->not_empty, n);
+            pushed += n;
+            continue;
+        }
+        // an unbounded queue that cannot grow is out of memory.
+        if (!queue->capacity || !timeout){
+            break;
+        }
+        if (!timed){
+            deadline = _bqueueDeadline(timeout, &buffer);
+            timed = true;
+        }
+        if (!_bqueueWait(queue, true, &round, deadline)){
+            break;
+        }
+    }
+    return pushed;
+}
+
+cds_bool bqueuePop(BlockingQueue* const queue, void* const out, const cds_long timeout){
+    return 1 == bqueuePopBatch(queue, out, 1, timeout);
+}
+
+cds_size bqueuePopBatch(BlockingQueue* const queue, void* const out, const cds_size max,
+                        const cds_long timeout){
+    if (!queue || !out || !max){
+        return 0;
+    }
+    struct timespec buffer;
+    const struct timespec* deadline = (const struct timespec*) NULL;
+    cds_bool timed = false;
+    cds_size round = 0;
+    while (true){
+        (void) pthread_mutex_lock(&queue->lock);
+        cds_size n = _bqueuePopSome(queue, out, max);
+        cds_bool closed = atomic_load_explicit(&queue->closed, memory_order_relaxed);
+        (void) pthread_mutex_unlock(&queue->lock);
+        if (n){
+            if (queue->capacity){
+                _eventWake(&queue->not_full, n);
+            }
+            return n;
+        }
+        if (closed || !timeout){
+            return 0;
+        }
+        if (!timed){
+            deadline = _bqueueDeadline(timeout, &buffer);
+            timed = true;
+        }
+        if (!_bqueueWait(queue, false, &round, deadline)){
+            // a last attempt, for the elements pushed while the deadline passed.
+            (void) pthread_mutex_lock(&queue->lock);
+            n = _bqueuePopSome(queue, out, max);
+            (void) pthread_mutex_unlock(&queue->lock);
+            if (n && queue->capacity){
+                _eventWake(&queue->not_full, n);
+            }
+            return n;
+        }
+    }
+}
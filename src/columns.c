@@ -0,0 +1,243 @@
+/*!
+ * @file columns.c
+ * @copyright GNU General Public Licence 3 or Later (GPLv3).
+ * @author Paulo Arruda
+ * @brief Implementation of the columns API.
+*/
+
+#include "../include/columns.h"
+#include "../include/_private_linear.h"
+
+/**
+ * Definition of the columns structure. Every column is a heap vector aligned
+ * to the cache line, and all of them hold `length` elements.
+*/
+struct Columns{
+    cds_size length;
+    cds_size num_columns;
+    Vector* columns[];
+};
+
+#define COLUMN_AT(vec, index) CDS_BYTE_OFFSET((vec)->container, (index)*(vec)->data_size)
+
+static const AllocOptions _column_options = {CDS_CACHE_LINE, HUGE_PAGES_NONE};
+
+Columns* columnsCreate(const cds_size min_capacity, const cds_size num_columns,
+                       const cds_size* const column_sizes){
+    if (!num_columns || !column_sizes){
+        return (Columns*) NULL;
+    }
+    for (cds_size c=0; c<num_columns; c++){
+        if (!column_sizes[c]){
+            return (Columns*) NULL;
+        }
+    }
+    Columns* cols = (Columns*) malloc(sizeof(Columns) + num_columns*sizeof(Vector*));
+    if (!cols){
+        return (Columns*) NULL;
+    }
+    cols->length = 0;
+    cols->num_columns = 0;
+    for (cds_size c=0; c<num_columns; c++){
+        cols->columns[c] = vectorCreateWithOptions(min_capacity, column_sizes[c], &_column_options);
+        if (!cols->columns[c]){
+            columnsDelete(cols);
+            return (Columns*) NULL;
+        }
+        cols->num_columns++;
+    }
+    return cols;
+}
+
+void columnsDelete(Columns* cols){
+    if (!cols){
+        return;
+    }
+    for (cds_size c=0; c<cols->num_columns; c++){
+        vectorDelete(cols->columns[c]);
+    }
+    free(cols);
+}
+
+/**
+ * Every column is reserved before any of them is written, so failed
+ * expansions never leave columns of different lengths.
+*/
+cds_bool columnsReserve(Columns* const cols, const cds_size min_capacity){
+    if (!cols){
+        return false;
+    }
+    for (cds_size c=0; c<cols->num_columns; c++){
+        if (!vectorReserve(cols->columns[c], min_capacity)){
+            return false;
+        }
+    }
+    return true;
+}
+
+static void _columnsSetLength(Columns* const cols, const cds_size length){
+    cols->length = length;
+    for (cds_size c=0; c<cols->num_columns; c++){
+        cols->columns[c]->length = length;
+    }
+}
+
+cds_bool columnsAppendRow(Columns* const cols, const void* const* const fields){
+    if (!cols || !fields){
+        return false;
+    }
+    for (cds_size c=0; c<cols->num_columns; c++){
+        if (!fields[c]){
+            return false;
+        }
+    }
+    if (!columnsReserve(cols, cols->length + 1)){
+        return false;
+    }
+    for (cds_size c=0; c<cols->num_columns; c++){
+        Vector* column = cols->columns[c];
+        (void) memcpy(COLUMN_AT(column, cols->length), fields[c], column->data_size);
+    }
+    _columnsSetLength(cols, cols->length + 1);
+    return true;
+}
+
+cds_bool columnsAppendRecords(Columns* const cols, const void* const records,
+                              const cds_size num_records, const cds_size record_size,
+                              const cds_size* const offsets){
+    if (!cols || !records || !offsets){
+        return false;
+    }
+    for (cds_size c=0; c<cols->num_columns; c++){
+        if (offsets[c] + cols->columns[c]->data_size > record_size){
+            return false;
+        }
+    }
+    if (!columnsReserve(cols, cols->length + num_records)){
+        return false;
+    }
+    const cds_uchar* first = (const cds_uchar*) records;
+    for (cds_size c=0; c<cols->num_columns; c++){
+        Vector* column = cols->columns[c];
+        const cds_size data_size = column->data_size;
+        cds_uchar* dst = (cds_uchar*) COLUMN_AT(column, cols->length);
+        const cds_uchar* src = first + offsets[c];
+        for (cds_size r=0; r<num_records; r++){
+            (void) memcpy(dst + r*data_size, src + r*record_size, data_size);
+        }
+    }
+    _columnsSetLength(cols, cols->length + num_records);
+    return true;
+}
+
+cds_bool columnsGetRow(const Columns* const cols, const cds_size row, void* const* const fields){
+    if (!cols || !fields || row >= cols->length){
+        return false;
+    }
+    for (cds_size c=0; c<cols->num_columns; c++){
+        if (fields[c]){
+            const Vector* column = cols->columns[c];
+            (void) memcpy(fields[c], COLUMN_AT(column, row), column->data_size);
+        }
+    }
+    return true;
+}
+
+cds_size columnsLength(const Columns* const cols){
+    return cols ? cols->length : 0;
+}
+
+cds_size columnsNumColumns(const Columns* const cols){
+    return cols ? cols->num_columns : 0;
+}
+
+Vector* columnsColumn(const Columns* const cols, const cds_size column){
+    if (!cols || column >= cols->num_columns){
+        return (Vector*) NULL;
+    }
+    return cols->columns[column];
+}
+
+void* columnsData(const Columns* const cols, const cds_size column){
+    if (!cols || column >= cols->num_columns){
+        return NULL;
+    }
+    return cols->columns[column]->container;
+}
+
+VectorSlice columnsSlice(const Columns* const cols, const cds_size column, const cds_size start,
+                         const cds_size length){
+    return vectorSlice(columnsColumn(cols, column), start, length);
+}
+
+/**
+ * GATHERING
+ * ---------
+ * Columns of 1, 2, 4 and 8 bytes are gathered with typed loads and stores,
+ * which the compiler turns into gather instructions where available; other
+ * sizes are copied with `memcpy`.
+*/
+
+#define DEFINE_GATHER(bits)                                                                 \
+static void _gather##bits(uint##bits##_t* restrict dst, const uint##bits##_t* restrict src, \
+                          const cds_size* restrict indices, const cds_size length){         \
+    for (cds_size i=0; i<length; i++){                                                      \
+        dst[i] = src[indices[i]];                                                           \
+    }                                                                                       \
+}
+DEFINE_GATHER(8)
+DEFINE_GATHER(16)
+DEFINE_GATHER(32)
+DEFINE_GATHER(64)
+#undef DEFINE_GATHER
+
+static void _gatherColumn(Vector* const dst, const Vector* const src,
+                          const cds_size* const indices, const cds_size length){
+    switch (src->data_size){
+        case 1:
+            _gather8(dst->container, src->container, indices, length);
+            return;
+        case 2:
+            _gather16(dst->container, src->container, indices, length);
+            return;
+        case 4:
+            _gather32(dst->container, src->container, indices, length);
+            return;
+        case 8:
+            _gather64(dst->container, src->container, indices, length);
+            return;
+    }
+    for (cds_size i=0; i<length; i++){
+        (void) memcpy(COLUMN_AT(dst, i), COLUMN_AT(src, indices[i]), src->data_size);
+    }
+}
+
+Columns* columnsGather(const Columns* const cols, const Vector* const indices){
+    if (!cols || !indices || sizeof(cds_size) != indices->data_size){
+        return (Columns*) NULL;
+    }
+    const cds_size* idx = (const cds_size*) indices->container;
+    const cds_size length = indices->length;
+    for (cds_size i=0; i<length; i++){
+        if (idx[i] >= cols->length){
+            return (Columns*) NULL;
+        }
+    }
+    cds_size* sizes = (cds_size*) malloc(cols->num_columns*sizeof(cds_size));
+    if (!sizes){
+        return (Columns*) NULL;
+    }
+    for (cds_size c=0; c<cols->num_columns; c++){
+        sizes[c] = cols->columns[c]->data_size;
+    }
+    Columns* gathered = columnsCreate(length ? length : 1, cols->num_columns, sizes);
+    free(sizes);
+    if (!gathered){
+        return (Columns*) NULL;
+    }
+    for (cds_size c=0; c<cols->num_columns; c++){
+        _gatherColumn(gathered->columns[c], cols->columns[c], idx, length);
+    }
+    _columnsSetLength(gathered, length);
+    return gathered;
+}
@@ -1,4 +1,5 @@
 #include <stdio.h>
+#include <unistd.h>
 #include "../include/common.h"
 
 #define ERROR_MESSAGE(internal_message, message, file) fprintf(file, internal_message, message)
@@ -67,6 +68,26 @@ size_t _log2(const size_t x){
     return log - 1;
 }
 
+size_t _numericSize(const enum NumericType type){
+    switch (type){
+        case NUM_INT8:
+        case NUM_UINT8:
+            return 1;
+        case NUM_INT16:
+        case NUM_UINT16:
+            return 2;
+        case NUM_INT32:
+        case NUM_UINT32:
+        case NUM_FLOAT:
+            return 4;
+        case NUM_INT64:
+        case NUM_UINT64:
+        case NUM_DOUBLE:
+            return 8;
+    }
+    return 0;
+}
+
 const void* _dataDup(const void* const data, const size_t data_size){
     void* dup = (void*) malloc(data_size);
     if (!dup){
@@ -97,3 +118,9 @@ const char* _strDup(const char* string){
     memcpy( (void*) new_str, string, len+1);
     return new_str;
 }
+
+/* Number of online processors, used as the default number of threads. **/
+size_t _numThreads(void){
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    return online > 0 ? (size_t) online : 1;
+}
@@ -0,0 +1,253 @@
+/*!
+ * @file concurrent_stack.c
+ * @copyright GNU General Public Licence 3 or Later (GPLv3).
+ * @author Paulo Arruda
+ * @brief Implementation of the lock-free (Treiber) stack.
+*/
+
+#include <string.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include "../include/concurrent_stack.h"
+#include "../include/_private_memory.h"
+#include "../include/_private_sync.h"
+
+/**
+ * Nodes are referenced by their index plus one (0 is the empty reference). The
+ * tops of the stacks and the elimination offers are 64-bit words holding a
+ * reference in the low half and a tag in the high half.
+*/
+#define TAGGED(tag, ref) (((uint64_t) (tag) << 32) | (uint64_t) (ref))
+#define REF(word) ((uint32_t) (word))
+#define TAG(word) ((uint32_t) ((word) >> 32))
+
+#define NODE(stack, ref) ((CStackNode*) ((stack)->nodes + ((cds_size) (ref) - 1)*(stack)->node_size))
+
+/**
+ * The link is atomic because a thread that lost a race may still read it while
+ * the new owner of the node rewrites it; the tag then makes its
+ * compare-and-swap fail.
+*/
+typedef struct CStackNode{
+    atomic_uint_least32_t next;
+    _Alignas(max_align_t) cds_uchar data[];
+}CStackNode;
+
+typedef struct EliminationSlot{
+    _Alignas(CDS_CACHE_LINE) atomic_uint_least64_t offer;   // tagged node offered by a push, or 0
+}EliminationSlot;
+
+struct ConcurrentStack{
+    _Alignas(CDS_CACHE_LINE) atomic_uint_least64_t top;
+    _Alignas(CDS_CACHE_LINE) atomic_uint_least64_t free_top;   // the node pool
+    _Alignas(CDS_CACHE_LINE) atomic_uint_least32_t offers;     // tags of the elimination offers
+    EliminationSlot slots[CSTACK_ELIMINATION_SLOTS];
+    _Alignas(CDS_CACHE_LINE) cds_size capacity;
+    cds_size data_size;
+    cds_size node_size;
+    cds_uchar* nodes;
+};
+
+static const AllocOptions _cstack_options = {CDS_CACHE_LINE, HUGE_PAGES_NONE};
+
+static _Thread_local uint32_t _cstack_seed = 0;
+
+/**
+ * Thread local xorshift generator picking the elimination slots.
+*/
+static uint32_t _cstackRandom(void){
+    uint32_t x = _cstack_seed;
+    if (!x){
+        x = (uint32_t) (uintptr_t) &_cstack_seed | 1;
+    }
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    _cstack_seed = x;
+    return x;
+}
+
+ConcurrentStack* cstackCreate(const cds_size capacity, const cds_size data_size){
+    if (!capacity || !data_size || capacity >= UINT32_MAX){
+        return (ConcurrentStack*) NULL;
+    }
+    const cds_size node_size = ((sizeof(CStackNode) + data_size + _Alignof(max_align_t) - 1)
+                                / _Alignof(max_align_t)) * _Alignof(max_align_t);
+    if (node_size < data_size || (cds_size) -1 / node_size < capacity){
+        return (ConcurrentStack*) NULL;
+    }
+    ConcurrentStack* stack = (ConcurrentStack*) _cdsAlloc(sizeof(ConcurrentStack), &_cstack_options);
+    if (!stack){
+        return (ConcurrentStack*) NULL;
+    }
+    stack->nodes = (cds_uchar*) _cdsAlloc(capacity*node_size, &_cstack_options);
+    if (!stack->nodes){
+        _cdsFree(stack, sizeof(ConcurrentStack), &_cstack_options);
+        return (ConcurrentStack*) NULL;
+    }
+    stack->capacity = capacity;
+    stack->data_size = data_size;
+    stack->node_size = node_size;
+    // every node starts in the pool, linked in order.
+    for (cds_size ref=1; ref<=capacity; ref++){
+        atomic_init(&NODE(stack, ref)->next, ref < capacity ? (uint32_t) ref + 1 : 0);
+    }
+    atomic_init(&stack->top, TAGGED(0, 0));
+    atomic_init(&stack->free_top, TAGGED(0, 1));
+    atomic_init(&stack->offers, 0);
+    for (cds_size i=0; i<CSTACK_ELIMINATION_SLOTS; i++){
+        atomic_init(&stack->slots[i].offer, 0);
+    }
+    return stack;
+}
+
+void cstackDelete(ConcurrentStack* stack){
+    if (!stack){
+        return;
+    }
+    _cdsFree(stack->nodes, stack->capacity*stack->node_size, &_cstack_options);
+    _cdsFree(stack, sizeof(ConcurrentStack), &_cstack_options);
+}
+
+cds_size cstackCapacity(const ConcurrentStack* const stack){
+    return stack ? stack->capacity : 0;
+}
+
+cds_bool cstackIsEmpty(const ConcurrentStack* const stack){
+    return !stack || !REF(atomic_load_explicit(&((ConcurrentStack*) stack)->top, memory_order_relaxed));
+}
+
+/**
+ * TAGGED STACKS
+ * -------------
+ * One attempt at pushing or popping a node on a tagged top; the release and
+ * acquire orders publish the link and the data of the node.
+*/
+
+static cds_bool _cstackTryPushRef(ConcurrentStack* const stack, atomic_uint_least64_t* const top,
+                                  const uint32_t ref){
+    uint64_t old = atomic_load_explicit(top, memory_order_relaxed);
+    atomic_store_explicit(&NODE(stack, ref)->next, REF(old), memory_order_relaxed);
+    return atomic_compare_exchange_weak_explicit(top, &old, TAGGED(TAG(old) + 1, ref),
+                                                 memory_order_release, memory_order_relaxed);
+}
+
+/**
+ * Returns the reference popped, or 0 when the compare-and-swap failed or the
+ * stack is empty, which is written to `pempty`.
+*/
+static uint32_t _cstackTryPopRef(ConcurrentStack* const stack, atomic_uint_least64_t* const top,
+                                 cds_bool* const pempty){
+    uint64_t old = atomic_load_explicit(top, memory_order_acquire);
+    *pempty = !REF(old);
+    if (*pempty){
+        return 0;
+    }
+    uint32_t next = atomic_load_explicit(&NODE(stack, REF(old))->next, memory_order_relaxed);
+    if (atomic_compare_exchange_weak_explicit(top, &old, TAGGED(TAG(old) + 1, next),
+                                              memory_order_acquire, memory_order_relaxed)){
+        return REF(old);
+    }
+    return 0;
+}
+
+/**
+ * The pool of free nodes is a plain tagged stack with backoff.
+*/
+static uint32_t _cstackAllocNode(ConcurrentStack* const stack){
+    cds_size round = 0;
+    cds_bool empty;
+    uint32_t ref;
+    while (!(ref = _cstackTryPopRef(stack, &stack->free_top, &empty)) && !empty){
+        _cdsBackoff(&round);
+    }
+    return ref;
+}
+
+static void _cstackFreeNode(ConcurrentStack* const stack, const uint32_t ref){
+    cds_size round = 0;
+    while (!_cstackTryPushRef(stack, &stack->free_top, ref)){
+        _cdsBackoff(&round);
+    }
+}
+
+/**
+ * ELIMINATION
+ * -----------
+ * A push that lost a race offers its node in a random slot and waits briefly;
+ * a pop that lost a race takes the offer of a random slot, if any. A matched
+ * push and pop cancel out, leaving the top untouched. Offers are tagged, so a
+ * push withdrawing its offer cannot mistake a later offer of the same node for
+ * its own.
+*/
+
+static cds_bool _cstackEliminatePush(ConcurrentStack* const stack, const uint32_t ref){
+    atomic_uint_least64_t* slot = &stack->slots[_cstackRandom() % CSTACK_ELIMINATION_SLOTS].offer;
+    const uint64_t offer = TAGGED(atomic_fetch_add_explicit(&stack->offers, 1, memory_order_relaxed), ref);
+    uint64_t expected = 0;
+    if (!atomic_compare_exchange_strong_explicit(slot, &expected, offer, memory_order_release,
+                                                 memory_order_relaxed)){
+        return false;
+    }
+    for (cds_size i=0; i<CDS_SPIN_LIMIT; i++){
+        if (offer != atomic_load_explicit(slot, memory_order_relaxed)){
+            return true;
+        }
+        CDS_CPU_RELAX();
+    }
+    // a failed withdrawal means that a pop took the node meanwhile.
+    expected = offer;
+    return !atomic_compare_exchange_strong_explicit(slot, &expected, 0, memory_order_relaxed,
+                                                    memory_order_relaxed);
+}
+
+static uint32_t _cstackEliminatePop(ConcurrentStack* const stack){
+    atomic_uint_least64_t* slot = &stack->slots[_cstackRandom() % CSTACK_ELIMINATION_SLOTS].offer;
+    uint64_t offer = atomic_load_explicit(slot, memory_order_relaxed);
+    if (REF(offer) && atomic_compare_exchange_strong_explicit(slot, &offer, 0, memory_order_acquire,
+                                                              memory_order_relaxed)){
+        return REF(offer);
+    }
+    return 0;
+}
+
+cds_bool cstackPush(ConcurrentStack* const stack, const void* const data){
+    if (!stack || !data){
+        return false;
+    }
+    const uint32_t ref = _cstackAllocNode(stack);
+    if (!ref){
+        return false;
+    }
+    memcpy(NODE(stack, ref)->data, data, stack->data_size);
+    cds_size round = 0;
+    while (!_cstackTryPushRef(stack, &stack->top, ref)){
+        if (_cstackEliminatePush(stack, ref)){
+            return true;
+        }
+        _cdsBackoff(&round);
+    }
+    return true;
+}
+
+cds_bool cstackPop(ConcurrentStack* const stack, void* const out){
+    if (!stack || !out){
+        return false;
+    }
+    cds_size round = 0;
+    cds_bool empty;
+    uint32_t ref;
+    while (!(ref = _cstackTryPopRef(stack, &stack->top, &empty))){
+        if (empty){
+            return false;
+        }
+        if ((ref = _cstackEliminatePop(stack))){
+            break;
+        }
+        _cdsBackoff(&round);
+    }
+    memcpy(out, NODE(stack, ref)->data, stack->data_size);
+    _cstackFreeNode(stack, ref);
+    return true;
+}
@@ -0,0 +1,430 @@
+/*!
+ * @file flat_map.c
+ * @copyright GNU General Public Licence 3 or Later (GPLv3).
+ * @author Paulo Arruda
+ * @brief Implementation of the flat map and flat set API.
+*/
+
+#include <stddef.h>
+#include "../include/flat_map.h"
+#include "../include/sort.h"
+#include "../include/_private_linear.h"
+
+/**
+ * Definition of the flat map structure. `values` is `NULL` for flat sets.
+*/
+struct FlatMap{
+    Vector* keys;
+    Vector* values;
+    TComparisonFun compare;
+};
+
+/**
+ * Definition of the flat set structure.
+*/
+struct FlatSet{
+    struct FlatMap map;
+};
+
+#define KEY_AT(map, index) CDS_BYTE_OFFSET((map)->keys->container, (index)*(map)->keys->data_size)
+#define VALUE_AT(map, index) CDS_BYTE_OFFSET((map)->values->container, (index)*(map)->values->data_size)
+
+/**
+ * SEARCHING
+ * ---------
+ * The binary searches halve the range without branching on the result of the
+ * comparison: the half to keep is selected arithmetically, so the loop runs
+ * exactly log2(n) times and never mispredicts.
+*/
+
+/**
+ * Retrieves the index of the first key for which `compare(key_i, key) < bias`,
+ * i.e. the lower bound for a bias of 0 and the upper bound for a bias of 1.
+*/
+static cds_size _bound(const struct FlatMap* const map, const void* const key, const cds_int8 bias){
+    cds_size n = map->keys->length;
+    if (!n){
+        return 0;
+    }
+    const cds_size key_size = map->keys->data_size;
+    const cds_uchar* base = (const cds_uchar*) map->keys->container;
+    while (n > 1){
+        cds_size half = n >> 1;
+        base += (cds_size) (map->compare(base + half*key_size, key) < bias) * half*key_size;
+        n -= half;
+    }
+    cds_size index = (cds_size) (base - (const cds_uchar*) map->keys->container) / key_size;
+    return index + (map->compare(base, key) < bias);
+}
+
+/**
+ * Retrieves the index of `key`, or `CDS_NOT_FOUND` if it is not stored.
+*/
+static cds_size _find(const struct FlatMap* const map, const void* const key){
+    cds_size index = _bound(map, key, 0);
+    if (index < map->keys->length && !map->compare(KEY_AT(map, index), key)){
+        return index;
+    }
+    return CDS_NOT_FOUND;
+}
+
+/**
+ * CONSTRUCTION
+ * ------------
+*/
+
+static cds_bool _flatmapInit(struct FlatMap* const map, const cds_size key_size,
+                             const cds_size value_size, const cds_size min_capacity,
+                             const TComparisonFun compare){
+    map->compare = compare;
+    map->values = (Vector*) NULL;
+    map->keys = vectorCreate(min_capacity, key_size);
+    if (!map->keys){
+        return false;
+    }
+    if (value_size){
+        map->values = vectorCreate(min_capacity, value_size);
+        if (!map->values){
+            vectorDelete(map->keys);
+            return false;
+        }
+    }
+    return true;
+}
+
+FlatMap* flatmapCreate(const cds_size key_size, const cds_size value_size,
+                       const TComparisonFun compare){
+    if (!key_size || !value_size || !compare){
+        return (FlatMap*) NULL;
+    }
+    FlatMap* map = (FlatMap*) malloc(sizeof(FlatMap));
+    if (!map){
+        return (FlatMap*) NULL;
+    }
+    if (!_flatmapInit(map, key_size, value_size, 1, compare)){
+        free(map);
+        return (FlatMap*) NULL;
+    }
+    return map;
+}
+
+/**
+ * Sorts the keys (and values) of `src_keys`/`src_values` into the empty `map`,
+ * keeping the last pair of every run of equal keys. The pairs are sorted as
+ * records holding the key followed by its value, padded so that every key is
+ * suitably aligned for the comparison function. Keys without values are
+ * sorted in a plain copy.
+*/
+static cds_bool _flatmapBuild(struct FlatMap* const map, const Vector* const src_keys,
+                              const Vector* const src_values){
+    const cds_size length = src_keys->length;
+    const cds_size key_size = src_keys->data_size;
+    const cds_size value_size = src_values ? src_values->data_size : 0;
+    cds_size stride = key_size;
+    if (src_values){
+        stride = key_size + value_size + _Alignof(max_align_t) - 1;
+        stride -= stride % _Alignof(max_align_t);
+    }
+    cds_uchar* records = (cds_uchar*) malloc(length*stride);
+    if (!records){
+        return false;
+    }
+    if (src_values){
+        for (cds_size i=0; i<length; i++){
+            (void) memcpy(records + i*stride, CDS_BYTE_OFFSET(src_keys->container, i*key_size), key_size);
+            (void) memcpy(records + i*stride + key_size,
+                          CDS_BYTE_OFFSET(src_values->container, i*value_size), value_size);
+        }
+    }else{
+        (void) memcpy(records, src_keys->container, length*key_size);
+    }
+    // the merge sort is stable, so the last of equal keys is the last inserted.
+    if (!arrSort(records, length, stride, map->compare) || !vectorReserve(map->keys, length)
+        || (src_values && !vectorReserve(map->values, length))){
+        free(records);
+        return false;
+    }
+    cds_size unique = 0;
+    for (cds_size i=0; i<length; i++){
+        const cds_uchar* record = records + i*stride;
+        if (i + 1 < length && !map->compare(record, record + stride)){
+            continue;
+        }
+        (void) memcpy(KEY_AT(map, unique), record, key_size);
+        if (src_values){
+            (void) memcpy(VALUE_AT(map, unique), record + key_size, value_size);
+        }
+        unique++;
+    }
+    free(records);
+    map->keys->length = unique;
+    (void) vectorShrinkToFit(map->keys);
+    if (src_values){
+        map->values->length = unique;
+        (void) vectorShrinkToFit(map->values);
+    }
+    return true;
+}
+
+FlatMap* flatmapFromVectors(const Vector* const keys, const Vector* const values,
+                            const TComparisonFun compare){
+    if (!keys || !values || keys->length != values->length){
+        return (FlatMap*) NULL;
+    }
+    FlatMap* map = flatmapCreate(keys->data_size, values->data_size, compare);
+    if (!map){
+        return (FlatMap*) NULL;
+    }
+    if (keys->length && !_flatmapBuild(map, keys, values)){
+        flatmapDelete(map);
+        return (FlatMap*) NULL;
+    }
+    return map;
+}
+
+void flatmapDelete(FlatMap* map){
+    if (!map){
+        return;
+    }
+    vectorDelete(map->keys);
+    if (map->values){
+        vectorDelete(map->values);
+    }
+    free(map);
+}
+
+/**
+ * MODIFIERS
+ * ---------
+ * Both vectors are reserved before anything is moved, so a failed allocation
+ * leaves the map untouched.
+*/
+
+/**
+ * Inserts `key`, and `value` unless it is `NULL` (flat sets).
+*/
+static cds_bool _flatmapInsert(struct FlatMap* const map, const void* const key,
+                               const void* const value){
+    cds_size index = _bound(map, key, 0);
+    cds_size length = map->keys->length;
+    if (index < length && !map->compare(KEY_AT(map, index), key)){
+        if (value){
+            (void) memcpy(VALUE_AT(map, index), value, map->values->data_size);
+        }
+        return true;
+    }
+    if (!vectorReserve(map->keys, length + 1) || (value && !vectorReserve(map->values, length + 1))){
+        return false;
+    }
+    const cds_size key_size = map->keys->data_size;
+    (void) memmove(KEY_AT(map, index + 1), KEY_AT(map, index), (length - index)*key_size);
+    (void) memcpy(KEY_AT(map, index), key, key_size);
+    map->keys->length++;
+    if (value){
+        const cds_size value_size = map->values->data_size;
+        (void) memmove(VALUE_AT(map, index + 1), VALUE_AT(map, index), (length - index)*value_size);
+        (void) memcpy(VALUE_AT(map, index), value, value_size);
+        map->values->length++;
+    }
+    return true;
+}
+
+static cds_bool _flatmapRemove(struct FlatMap* const map, const void* const key){
+    cds_size index = _find(map, key);
+    if (CDS_NOT_FOUND == index){
+        return false;
+    }
+    cds_size tail = map->keys->length - index - 1;
+    (void) memmove(KEY_AT(map, index), KEY_AT(map, index + 1), tail*map->keys->data_size);
+    map->keys->length--;
+    if (map->values){
+        (void) memmove(VALUE_AT(map, index), VALUE_AT(map, index + 1), tail*map->values->data_size);
+        map->values->length--;
+    }
+    return true;
+}
+
+cds_bool flatmapInsert(FlatMap* const map, const void* const key, const void* const value){
+    if (!map || !key || !value){
+        return false;
+    }
+    return _flatmapInsert(map, key, value);
+}
+
+cds_bool flatmapRemove(FlatMap* const map, const void* const key){
+    if (!map || !key){
+        return false;
+    }
+    return _flatmapRemove(map, key);
+}
+
+/**
+ * QUERIES
+ * -------
+*/
+
+void* flatmapGet(const FlatMap* const map, const void* const key){
+    if (!map || !key){
+        return NULL;
+    }
+    cds_size index = _find(map, key);
+    return CDS_NOT_FOUND == index ? NULL : VALUE_AT(map, index);
+}
+
+cds_bool flatmapContains(const FlatMap* const map, const void* const key){
+    return map && key && CDS_NOT_FOUND != _find(map, key);
+}
+
+cds_size flatmapLength(const FlatMap* const map){
+    return map ? map->keys->length : 0;
+}
+
+cds_size flatmapLowerBound(const FlatMap* const map, const void* const key){
+    if (!map || !key){
+        return 0;
+    }
+    return _bound(map, key, 0);
+}
+
+cds_size flatmapUpperBound(const FlatMap* const map, const void* const key){
+    if (!map || !key){
+        return 0;
+    }
+    return _bound(map, key, 1);
+}
+
+const void* flatmapKeyAt(const FlatMap* const map, const cds_size index){
+    if (!map || index >= map->keys->length){
+        return NULL;
+    }
+    return KEY_AT(map, index);
+}
+
+void* flatmapValueAt(const FlatMap* const map, const cds_size index){
+    if (!map || index >= map->keys->length){
+        return NULL;
+    }
+    return VALUE_AT(map, index);
+}
+
+static cds_size _flatmapRange(const struct FlatMap* const map, const void* const low,
+                              const void* const high, VectorSlice* const keys,
+                              VectorSlice* const values){
+    cds_size first = low ? _bound(map, low, 0) : 0;
+    cds_size last = high ? _bound(map, high, 0) : map->keys->length;
+    cds_size length = last > first ? last - first : 0;
+    if (keys){
+        *keys = vectorSlice(map->keys, first, length);
+    }
+    if (values){
+        *values = vectorSlice(map->values, first, length);
+    }
+    return length;
+}
+
+cds_size flatmapRange(const FlatMap* const map, const void* const low, const void* const high,
+                      VectorSlice* const keys, VectorSlice* const values){
+    if (!map){
+        return 0;
+    }
+    return _flatmapRange(map, low, high, keys, values);
+}
+
+cds_bool flatmapShrinkToFit(FlatMap* const map){
+    if (!map){
+        return false;
+    }
+    return vectorShrinkToFit(map->keys) && vectorShrinkToFit(map->values);
+}
+
+/**
+ * FLAT SET
+ * --------
+ * Flat sets are flat maps without the vector of values.
+*/
+
+FlatSet* flatsetCreate(const cds_size key_size, const TComparisonFun compare){
+    if (!key_size || !compare){
+        return (FlatSet*) NULL;
+    }
+    FlatSet* set = (FlatSet*) malloc(sizeof(FlatSet));
+    if (!set){
+        return (FlatSet*) NULL;
+    }
+    if (!_flatmapInit(&set->map, key_size, 0, 1, compare)){
+        free(set);
+        return (FlatSet*) NULL;
+    }
+    return set;
+}
+
+FlatSet* flatsetFromVector(const Vector* const keys, const TComparisonFun compare){
+    if (!keys){
+        return (FlatSet*) NULL;
+    }
+    FlatSet* set = flatsetCreate(keys->data_size, compare);
+    if (!set){
+        return (FlatSet*) NULL;
+    }
+    if (keys->length && !_flatmapBuild(&set->map, keys, (const Vector*) NULL)){
+        flatsetDelete(set);
+        return (FlatSet*) NULL;
+    }
+    return set;
+}
+
+void flatsetDelete(FlatSet* set){
+    if (!set){
+        return;
+    }
+    vectorDelete(set->map.keys);
+    free(set);
+}
+
+cds_bool flatsetInsert(FlatSet* const set, const void* const key){
+    if (!set || !key){
+        return false;
+    }
+    return _flatmapInsert(&set->map, key, NULL);
+}
+
+cds_bool flatsetContains(const FlatSet* const set, const void* const key){
+    return set && key && CDS_NOT_FOUND != _find(&set->map, key);
+}
+
+cds_bool flatsetRemove(FlatSet* const set, const void* const key){
+    if (!set || !key){
+        return false;
+    }
+    return _flatmapRemove(&set->map, key);
+}
+
+cds_size flatsetLength(const FlatSet* const set){
+    return set ? set->map.keys->length : 0;
+}
+
+cds_size flatsetLowerBound(const FlatSet* const set, const void* const key){
+    if (!set || !key){
+        return 0;
+    }
+    return _bound(&set->map, key, 0);
+}
+
+const void* flatsetKeyAt(const FlatSet* const set, const cds_size index){
+    return set ? flatmapKeyAt(&set->map, index) : NULL;
+}
+
+cds_size flatsetRange(const FlatSet* const set, const void* const low, const void* const high,
+                      VectorSlice* const keys){
+    if (!set){
+        return 0;
+    }
+    return _flatmapRange(&set->map, low, high, keys, (VectorSlice*) NULL);
+}
+
+cds_bool flatsetShrinkToFit(FlatSet* const set){
+    if (!set){
+        return false;
+    }
+    return vectorShrinkToFit(set->map.keys);
+}
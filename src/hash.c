@@ -1,4 +1,5 @@
 #include "../include/_private_hash.h"
+#include "../include/_private_memory.h"
 
 /**
  * HASH FUNCTIONS
@@ -181,23 +182,29 @@ static cds_bool _hashKeyComp(const void* key1, const void* key2, const KeyType k
 */
 HashTable* htCreate(const HashFunction hash_fun, const cds_size min_capacity, 
                     const KeyType key_type){
-    if (min_capacity <= 0){
+    return htCreateWithOptions(hash_fun, min_capacity, key_type, NULL);
+}
+
+HashTable* htCreateWithOptions(const HashFunction hash_fun, const cds_size min_capacity,
+                               const KeyType key_type, const AllocOptions* const options){
+    if (min_capacity <= 0 || !_allocOptionsValid(options)){
         // handle error
         return (HashTable*) NULL;
     }
     cds_size pow = _log2(min_capacity) + 1;
-    if (pow >= _MAX_POW2_){
+    if (pow >= _MAX_POW2_ || (cds_size) -1 / sizeof(HTEntry) < ((cds_size) 1 << pow)){
         //handle size_t overflow error 
         return (HashTable*) NULL;
     }
     //make the capacity the next power of 2 
     //of the min_capacity
-    cds_size capacity = 1 << pow;
+    cds_size capacity = (cds_size) 1 << pow;
     HashTable* new_table = (HashTable*) malloc(sizeof(HashTable));
     if (!new_table){
         return (HashTable*) NULL;
     }
-    HTEntry* container = (HTEntry*) calloc(capacity, sizeof(HTEntry));
+    new_table->options = options ? *options : (AllocOptions){0, HUGE_PAGES_NONE};
+    HTEntry* container = (HTEntry*) _cdsCalloc(capacity * sizeof(HTEntry), &new_table->options);
     if (!container){
         //handle errors
         free(new_table);
@@ -215,7 +222,7 @@ void htDelete(HashTable* table){
     if (!table){ 
         return;
     }
-    free(table->container);
+    _cdsFree(table->container, table->capacity * sizeof(HTEntry), &table->options);
     free(table);
 }
 
@@ -249,7 +256,7 @@ static bool _htExpand(HashTable* ht){
     if (new_capacity <= ht->capacity){
         return false;
     }
-    HTEntry* new_container = (HTEntry*) calloc(new_capacity, sizeof(HTEntry));
+    HTEntry* new_container = (HTEntry*) _cdsCalloc(new_capacity * sizeof(HTEntry), &ht->options);
     if (!new_container){
         return false;
     }
@@ -270,7 +277,7 @@ static bool _htExpand(HashTable* ht){
             new_container[new_index].data_size = ht->container[index].data_size;
         }
     }
-    free(ht->container);
+    _cdsFree(ht->container, ht->capacity * sizeof(HTEntry), &ht->options);
     ht->container = new_container;
     ht->capacity = new_capacity;
     return true;
@@ -373,18 +380,27 @@ const void* htPop(HashTable* ht, const void* key){
 */
 Set* setCreate(const size_t min_capacity, const HashFunction hash_fun, 
                const KeyType key_type){
+    return setCreateWithOptions(min_capacity, hash_fun, key_type, NULL);
+}
+
+Set* setCreateWithOptions(const cds_size min_capacity, const HashFunction hash_fun,
+                          const KeyType key_type, const AllocOptions* const options){
+    if (!_allocOptionsValid(options)){
+        return (Set*) NULL;
+    }
     Set* new_set = (Set*) malloc(sizeof(Set));
     if (!new_set){
         return (Set*) NULL;
     }
     size_t pow = _log2(min_capacity) + 1;
-    if (pow >= _MAX_POW2_){
+    if (pow >= _MAX_POW2_ || (size_t) -1 / sizeof(SetEntry) < ((size_t) 1 << pow)){
         //handle overflow error
         free(new_set);
         return (Set*) NULL;
     }
-    size_t capacity = 1 << pow;
-    SetEntry* container = (SetEntry*) calloc(capacity, sizeof(SetEntry*));
+    size_t capacity = (size_t) 1 << pow;
+    new_set->options = options ? *options : (AllocOptions){0, HUGE_PAGES_NONE};
+    SetEntry* container = (SetEntry*) _cdsCalloc(capacity * sizeof(SetEntry), &new_set->options);
     if (!container){
         free(new_set);
         return (Set*) NULL;
@@ -401,7 +417,7 @@ void setDelete(Set* set){
     if (!set){
         return;
     }
-    free((void*) set->container);
+    _cdsFree((void*) set->container, set->capacity * sizeof(SetEntry), &set->options);
     free((void*) set);
 }
 
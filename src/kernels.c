@@ -0,0 +1,559 @@
+/*!
+ * @file kernels.c
+ * @copyright GNU General Public Licence 3 or Later (GPLv3).
+ * @author Paulo Arruda
+ * @brief Implementation of the kernels API.
+*/
+
+#include "../include/kernels.h"
+#include "../include/_private_linear.h"
+#include "../include/_private_simd.h"
+
+/**
+ * X-macro listing the numeric types: enumeration, function suffix, C type and
+ * the type of the sum.
+*/
+#define NUMERIC_TYPES(X)                            \
+    X(NUM_INT8,   Int8,   int8_t,     int64_t)      \
+    X(NUM_UINT8,  UInt8,  uint8_t,    uint64_t)     \
+    X(NUM_INT16,  Int16,  int16_t,    int64_t)      \
+    X(NUM_UINT16, UInt16, uint16_t,   uint64_t)     \
+    X(NUM_INT32,  Int32,  int32_t,    int64_t)      \
+    X(NUM_UINT32, UInt32, uint32_t,   uint64_t)     \
+    X(NUM_INT64,  Int64,  int64_t,    int64_t)      \
+    X(NUM_UINT64, UInt64, uint64_t,   uint64_t)     \
+    X(NUM_FLOAT,  Float,  cds_float,  cds_double)   \
+    X(NUM_DOUBLE, Double, cds_double, cds_double)
+
+/**
+ * EQUALITY KERNELS
+ * ----------------
+ * Searching and counting compare whole registers of elements at once and
+ * inspect the resulting byte mask.
+*/
+
+#define DEFINE_SCALAR_EQ(bits)                                                              \
+static cds_size _findScalar##bits(const uint##bits##_t* arr, const cds_size length,         \
+                                  const uint##bits##_t value){                              \
+    for (cds_size i=0; i<length; i++){                                                      \
+        if (arr[i] == value){                                                               \
+            return i;                                                                       \
+        }                                                                                   \
+    }                                                                                       \
+    return CDS_NOT_FOUND;                                                                   \
+}                                                                                           \
+static cds_size _countScalar##bits(const uint##bits##_t* arr, const cds_size length,        \
+                                   const uint##bits##_t value){                             \
+    cds_size count = 0;                                                                     \
+    for (cds_size i=0; i<length; i++){                                                      \
+        count += arr[i] == value;                                                           \
+    }                                                                                       \
+    return count;                                                                           \
+}
+
+DEFINE_SCALAR_EQ(8)
+DEFINE_SCALAR_EQ(16)
+DEFINE_SCALAR_EQ(32)
+DEFINE_SCALAR_EQ(64)
+
+#ifdef __CDS_X86_SIMD__
+
+/* SSE2 has no 64 bits comparison: both 32 bits halves have to match. **/
+static inline __m128i _sse2CmpEq64(const __m128i a, const __m128i b){
+    __m128i eq32 = _mm_cmpeq_epi32(a, b);
+    return _mm_and_si128(eq32, _mm_shuffle_epi32(eq32, _MM_SHUFFLE(2, 3, 0, 1)));
+}
+
+#define DEFINE_SIMD_EQ(name, attr, bits, vec_t, set_t, LOAD, SET1, CMPEQ, MOVEMASK)         \
+attr static cds_size _find##name(const uint##bits##_t* arr, const cds_size length,          \
+                                 const uint##bits##_t value){                               \
+    const cds_size lanes = sizeof(vec_t) / sizeof(*arr);                                    \
+    const vec_t needle = SET1((set_t) value);                                               \
+    cds_size i = 0;                                                                         \
+    for (; i + lanes <= length; i += lanes){                                                \
+        cds_uint32 mask = (cds_uint32) MOVEMASK(CMPEQ(LOAD((const vec_t*) (arr + i)), needle));\
+        if (mask){                                                                          \
+            return i + CDS_CTZ32(mask) / sizeof(*arr);                                      \
+        }                                                                                   \
+    }                                                                                       \
+    cds_size found = _findScalar##bits(arr + i, length - i, value);                         \
+    return CDS_NOT_FOUND == found ? CDS_NOT_FOUND : i + found;                              \
+}                                                                                           \
+attr static cds_size _count##name(const uint##bits##_t* arr, const cds_size length,         \
+                                  const uint##bits##_t value){                              \
+    const cds_size lanes = sizeof(vec_t) / sizeof(*arr);                                    \
+    const vec_t needle = SET1((set_t) value);                                               \
+    cds_size i = 0;                                                                         \
+    cds_size matched_bytes = 0;                                                             \
+    for (; i + lanes <= length; i += lanes){                                                \
+        cds_uint32 mask = (cds_uint32) MOVEMASK(CMPEQ(LOAD((const vec_t*) (arr + i)), needle));\
+        matched_bytes += CDS_POPCOUNT32(mask);                                              \
+    }                                                                                       \
+    return matched_bytes / sizeof(*arr) + _countScalar##bits(arr + i, length - i, value);   \
+}
+
+DEFINE_SIMD_EQ(Sse2_8, , 8, __m128i, char, _mm_loadu_si128, _mm_set1_epi8, _mm_cmpeq_epi8,
+               _mm_movemask_epi8)
+DEFINE_SIMD_EQ(Sse2_16, , 16, __m128i, short, _mm_loadu_si128, _mm_set1_epi16, _mm_cmpeq_epi16,
+               _mm_movemask_epi8)
+DEFINE_SIMD_EQ(Sse2_32, , 32, __m128i, int, _mm_loadu_si128, _mm_set1_epi32, _mm_cmpeq_epi32,
+               _mm_movemask_epi8)
+DEFINE_SIMD_EQ(Sse2_64, , 64, __m128i, long long, _mm_loadu_si128, _mm_set1_epi64x, _sse2CmpEq64,
+               _mm_movemask_epi8)
+DEFINE_SIMD_EQ(Avx2_8, CDS_TARGET_AVX2, 8, __m256i, char, _mm256_loadu_si256, _mm256_set1_epi8,
+               _mm256_cmpeq_epi8, _mm256_movemask_epi8)
+DEFINE_SIMD_EQ(Avx2_16, CDS_TARGET_AVX2, 16, __m256i, short, _mm256_loadu_si256, _mm256_set1_epi16,
+               _mm256_cmpeq_epi16, _mm256_movemask_epi8)
+DEFINE_SIMD_EQ(Avx2_32, CDS_TARGET_AVX2, 32, __m256i, int, _mm256_loadu_si256, _mm256_set1_epi32,
+               _mm256_cmpeq_epi32, _mm256_movemask_epi8)
+DEFINE_SIMD_EQ(Avx2_64, CDS_TARGET_AVX2, 64, __m256i, long long, _mm256_loadu_si256,
+               _mm256_set1_epi64x, _mm256_cmpeq_epi64, _mm256_movemask_epi8)
+
+#define EQ_DISPATCH(kernel, bits, arr, length, value)                                       \
+    (CDS_HAS_AVX2() ? _##kernel##Avx2_##bits(arr, length, value) :                          \
+                      _##kernel##Sse2_##bits(arr, length, value))
+#else
+#define EQ_DISPATCH(kernel, bits, arr, length, value) _##kernel##Scalar##bits(arr, length, value)
+#endif // __CDS_X86_SIMD__
+
+#define LOAD_VALUE(ptr, type) (*(const type*) (ptr))
+
+cds_size arrFind(const void* const arr, const cds_size length, const cds_size data_size,
+                 const void* const value){
+    if (!arr || !value || !data_size){
+        return CDS_NOT_FOUND;
+    }
+    switch (data_size){
+        case 1:
+            return EQ_DISPATCH(find, 8, arr, length, LOAD_VALUE(value, uint8_t));
+        case 2:
+            return EQ_DISPATCH(find, 16, arr, length, LOAD_VALUE(value, uint16_t));
+        case 4:
+            return EQ_DISPATCH(find, 32, arr, length, LOAD_VALUE(value, uint32_t));
+        case 8:
+            return EQ_DISPATCH(find, 64, arr, length, LOAD_VALUE(value, uint64_t));
+        default:
+            for (cds_size i=0; i<length; i++){
+                if (0 == memcmp(CDS_BYTE_OFFSET(arr, i*data_size), value, data_size)){
+                    return i;
+                }
+            }
+    }
+    return CDS_NOT_FOUND;
+}
+
+cds_size arrCount(const void* const arr, const cds_size length, const cds_size data_size,
+                  const void* const value){
+    if (!arr || !value || !data_size){
+        return 0;
+    }
+    cds_size count = 0;
+    switch (data_size){
+        case 1:
+            return EQ_DISPATCH(count, 8, arr, length, LOAD_VALUE(value, uint8_t));
+        case 2:
+            return EQ_DISPATCH(count, 16, arr, length, LOAD_VALUE(value, uint16_t));
+        case 4:
+            return EQ_DISPATCH(count, 32, arr, length, LOAD_VALUE(value, uint32_t));
+        case 8:
+            return EQ_DISPATCH(count, 64, arr, length, LOAD_VALUE(value, uint64_t));
+        default:
+            for (cds_size i=0; i<length; i++){
+                count += 0 == memcmp(CDS_BYTE_OFFSET(arr, i*data_size), value, data_size);
+            }
+    }
+    return count;
+}
+
+/**
+ * TYPED KERNELS
+ * -------------
+ * These are plain loops written so that the compiler vectorizes them; every
+ * reduction keeps one accumulator per lane of a 256 bits register so that the
+ * loop carried dependency does not serialize it.
+*/
+
+#define LANES(type) (32 / sizeof(type))
+
+/* Index of the first element that is not a NaN (`x != x` only holds for NaNs). **/
+#define FIRST_ORDERED(arr, length, start)                                                   \
+    cds_size start = 0;                                                                     \
+    while (start + 1 < length && arr[start] != arr[start]){                                 \
+        start++;                                                                            \
+    }
+
+#define DEFINE_REDUCE_KERNEL(kernel, suffix, type, cmp)                                     \
+CDS_TARGET_CLONES static void _##kernel##suffix(const type* arr, const cds_size length,     \
+                                                type* out){                                 \
+    FIRST_ORDERED(arr, length, start)                                                       \
+    type acc[LANES(type)];                                                                  \
+    for (cds_size l=0; l<LANES(type); l++){                                                 \
+        acc[l] = arr[start];                                                                \
+    }                                                                                       \
+    cds_size i = start;                                                                     \
+    for (; i + LANES(type) <= length; i += LANES(type)){                                    \
+        for (cds_size l=0; l<LANES(type); l++){                                             \
+            acc[l] = arr[i + l] cmp acc[l] ? arr[i + l] : acc[l];                           \
+        }                                                                                   \
+    }                                                                                       \
+    for (; i<length; i++){                                                                  \
+        acc[0] = arr[i] cmp acc[0] ? arr[i] : acc[0];                                       \
+    }                                                                                       \
+    for (cds_size l=1; l<LANES(type); l++){                                                 \
+        acc[0] = acc[l] cmp acc[0] ? acc[l] : acc[0];                                       \
+    }                                                                                       \
+    *out = acc[0];                                                                          \
+}
+
+#define DEFINE_MIN_KERNEL(enum_, suffix, type, sum_type) DEFINE_REDUCE_KERNEL(min, suffix, type, <)
+#define DEFINE_MAX_KERNEL(enum_, suffix, type, sum_type) DEFINE_REDUCE_KERNEL(max, suffix, type, >)
+
+NUMERIC_TYPES(DEFINE_MIN_KERNEL)
+NUMERIC_TYPES(DEFINE_MAX_KERNEL)
+
+#define DEFINE_SUM_KERNEL(enum_, suffix, type, sum_type)                                    \
+CDS_TARGET_CLONES static void _sum##suffix(const type* arr, const cds_size length,          \
+                                           sum_type* out){                                  \
+    sum_type acc[LANES(sum_type)] = {0};                                                    \
+    cds_size i = 0;                                                                         \
+    for (; i + LANES(sum_type) <= length; i += LANES(sum_type)){                            \
+        for (cds_size l=0; l<LANES(sum_type); l++){                                         \
+            acc[l] += (sum_type) arr[i + l];                                                \
+        }                                                                                   \
+    }                                                                                       \
+    for (; i<length; i++){                                                                  \
+        acc[0] += (sum_type) arr[i];                                                        \
+    }                                                                                       \
+    for (cds_size l=1; l<LANES(sum_type); l++){                                             \
+        acc[0] += acc[l];                                                                   \
+    }                                                                                       \
+    *out = acc[0];                                                                          \
+}
+
+NUMERIC_TYPES(DEFINE_SUM_KERNEL)
+
+/**
+ * The filter writes every element to the output and only advances the output
+ * index when the predicate holds, so the loop has no data dependent branch.
+*/
+#define FILTER_LOOP(type, cmp)                                                              \
+    for (cds_size i=0; i<length; i++){                                                      \
+        type x = arr[i];                                                                    \
+        out[count] = x;                                                                     \
+        count += (x cmp value);                                                             \
+    }                                                                                       \
+    break;
+
+#define DEFINE_FILTER_KERNEL(enum_, suffix, type, sum_type)                                 \
+CDS_TARGET_CLONES static cds_size _filter##suffix(const type* arr, const cds_size length,    \
+                                                  type* out, const enum CompareOp op,       \
+                                                  const type value){                        \
+    cds_size count = 0;                                                                     \
+    switch (op){                                                                            \
+        case CMP_EQ: FILTER_LOOP(type, ==)                                                  \
+        case CMP_NE: FILTER_LOOP(type, !=)                                                  \
+        case CMP_LT: FILTER_LOOP(type, <)                                                   \
+        case CMP_LE: FILTER_LOOP(type, <=)                                                  \
+        case CMP_GT: FILTER_LOOP(type, >)                                                   \
+        case CMP_GE: FILTER_LOOP(type, >=)                                                  \
+    }                                                                                       \
+    return count;                                                                           \
+}
+
+NUMERIC_TYPES(DEFINE_FILTER_KERNEL)
+
+/**
+ * PREFIX SUMS
+ * -----------
+ * Integers are scanned inside SSE2 registers by adding shifted copies of the
+ * register (log2(lanes) steps); the last element of every block is then carried
+ * into the next one. Floating point scans stay sequential to preserve the
+ * order of the additions.
+*/
+
+#define DEFINE_SCALAR_SCAN(suffix, type)                                                    \
+static void _scanScalar##suffix(type* arr, const cds_size length, type carry){              \
+    for (cds_size i=0; i<length; i++){                                                      \
+        carry = (type) (carry + arr[i]);                                                    \
+        arr[i] = carry;                                                                     \
+    }                                                                                       \
+}
+
+DEFINE_SCALAR_SCAN(8, uint8_t)
+DEFINE_SCALAR_SCAN(16, uint16_t)
+DEFINE_SCALAR_SCAN(32, uint32_t)
+DEFINE_SCALAR_SCAN(64, uint64_t)
+DEFINE_SCALAR_SCAN(Float, cds_float)
+DEFINE_SCALAR_SCAN(Double, cds_double)
+
+#ifdef __CDS_X86_SIMD__
+
+#define SCAN_STEP(x, add, bytes) x = add(x, _mm_slli_si128(x, bytes))
+
+#define DEFINE_SSE2_SCAN(bits, set_t, add, SET1, STEPS)                                     \
+static void _scan##bits(uint##bits##_t* arr, const cds_size length){                        \
+    const cds_size lanes = sizeof(__m128i) / sizeof(*arr);                                  \
+    __m128i carry = _mm_setzero_si128();                                                    \
+    cds_size i = 0;                                                                         \
+    for (; i + lanes <= length; i += lanes){                                                \
+        __m128i x = _mm_loadu_si128((const __m128i*) (arr + i));                            \
+        STEPS(x, add);                                                                      \
+        x = add(x, carry);                                                                  \
+        _mm_storeu_si128((__m128i*) (arr + i), x);                                          \
+        carry = SET1((set_t) arr[i + lanes - 1]);                                           \
+    }                                                                                       \
+    _scanScalar##bits(arr + i, length - i, i ? arr[i-1] : 0);                               \
+}
+
+#define STEPS_8(x, add)  SCAN_STEP(x, add, 1); SCAN_STEP(x, add, 2); SCAN_STEP(x, add, 4); \
+                         SCAN_STEP(x, add, 8)
+#define STEPS_16(x, add) SCAN_STEP(x, add, 2); SCAN_STEP(x, add, 4); SCAN_STEP(x, add, 8)
+#define STEPS_32(x, add) SCAN_STEP(x, add, 4); SCAN_STEP(x, add, 8)
+#define STEPS_64(x, add) SCAN_STEP(x, add, 8)
+
+DEFINE_SSE2_SCAN(8, char, _mm_add_epi8, _mm_set1_epi8, STEPS_8)
+DEFINE_SSE2_SCAN(16, short, _mm_add_epi16, _mm_set1_epi16, STEPS_16)
+DEFINE_SSE2_SCAN(32, int, _mm_add_epi32, _mm_set1_epi32, STEPS_32)
+DEFINE_SSE2_SCAN(64, long long, _mm_add_epi64, _mm_set1_epi64x, STEPS_64)
+
+#else
+
+#define DEFINE_PORTABLE_SCAN(bits)                                                          \
+static void _scan##bits(uint##bits##_t* arr, const cds_size length){                        \
+    _scanScalar##bits(arr, length, 0);                                                      \
+}
+
+DEFINE_PORTABLE_SCAN(8)
+DEFINE_PORTABLE_SCAN(16)
+DEFINE_PORTABLE_SCAN(32)
+DEFINE_PORTABLE_SCAN(64)
+
+#endif // __CDS_X86_SIMD__
+
+/**
+ * DISPATCH
+ * --------
+*/
+
+#define CASE_MIN(enum_, suffix, type, sum_type)                                             \
+    case enum_: _min##suffix(arr, length, out); break;
+#define CASE_MAX(enum_, suffix, type, sum_type)                                             \
+    case enum_: _max##suffix(arr, length, out); break;
+#define CASE_SUM(enum_, suffix, type, sum_type)                                             \
+    case enum_: _sum##suffix(arr, length, out); break;
+#define CASE_FILTER(enum_, suffix, type, sum_type)                                          \
+    case enum_: count = _filter##suffix(arr, length, out, op, LOAD_VALUE(value, type)); break;
+
+cds_bool arrMin(const void* const arr, const cds_size length, const enum NumericType type,
+                void* const out){
+    if (!arr || !out || !length){
+        return false;
+    }
+    switch (type){
+        NUMERIC_TYPES(CASE_MIN)
+    }
+    return true;
+}
+
+cds_bool arrMax(const void* const arr, const cds_size length, const enum NumericType type,
+                void* const out){
+    if (!arr || !out || !length){
+        return false;
+    }
+    switch (type){
+        NUMERIC_TYPES(CASE_MAX)
+    }
+    return true;
+}
+
+void arrSum(const void* const arr, const cds_size length, const enum NumericType type,
+            void* const out){
+    if (!out){
+        return;
+    }
+    switch (type){
+        NUMERIC_TYPES(CASE_SUM)
+    }
+}
+
+cds_size arrFilter(const void* const arr, const cds_size length, void* const out,
+                   const enum CompareOp op, const void* const value, const enum NumericType type){
+    if (!arr || !out || !value){
+        return 0;
+    }
+    cds_size count = 0;
+    switch (type){
+        NUMERIC_TYPES(CASE_FILTER)
+    }
+    return count;
+}
+
+void arrPrefixSum(void* const arr, const cds_size length, const enum NumericType type){
+    if (!arr){
+        return;
+    }
+    switch (type){
+        case NUM_INT8:
+        case NUM_UINT8:
+            _scan8(arr, length);
+            break;
+        case NUM_INT16:
+        case NUM_UINT16:
+            _scan16(arr, length);
+            break;
+        case NUM_INT32:
+        case NUM_UINT32:
+            _scan32(arr, length);
+            break;
+        case NUM_INT64:
+        case NUM_UINT64:
+            _scan64(arr, length);
+            break;
+        case NUM_FLOAT:
+            _scanScalarFloat(arr, length, 0);
+            break;
+        case NUM_DOUBLE:
+            _scanScalarDouble(arr, length, 0);
+            break;
+    }
+}
+
+/**
+ * CONTAINERS
+ * ----------
+*/
+
+#define TYPE_MATCHES(container, type) (container && _numericSize(type) == container->data_size)
+
+static cds_size _filterInto(const void* const arr, const cds_size length, const cds_size data_size,
+                            Vector* const dst, const enum CompareOp op, const void* const value,
+                            const enum NumericType type){
+    if (!arr || !value || !TYPE_MATCHES(dst, type) || _numericSize(type) != data_size || dst->read_only){
+        return CDS_NOT_FOUND;
+    }
+    // the source may be `dst` itself (or a view of it), whose buffer the reserve can move.
+    const uintptr_t old_buffer = (uintptr_t) dst->container;
+    const cds_bool aliased = (uintptr_t) arr >= old_buffer
+                             && (uintptr_t) arr < old_buffer + dst->capacity*dst->data_size;
+    // the branchless filter writes one element past the last match.
+    if (!vectorReserve(dst, dst->length + length + 1)){
+        return CDS_NOT_FOUND;
+    }
+    const void* src = aliased ? CDS_BYTE_OFFSET(dst->container, ((uintptr_t) arr - old_buffer)) : arr;
+    cds_size count = arrFilter(src, length, CDS_BYTE_OFFSET(dst->container, dst->length*data_size),
+                               op, value, type);
+    dst->length += count;
+    return count;
+}
+
+cds_size vectorFind(const Vector* const vec, const void* const value){
+    if (!vec){
+        return CDS_NOT_FOUND;
+    }
+    return arrFind(vec->container, vec->length, vec->data_size, value);
+}
+
+cds_size vectorCount(const Vector* const vec, const void* const value){
+    if (!vec){
+        return 0;
+    }
+    return arrCount(vec->container, vec->length, vec->data_size, value);
+}
+
+cds_size vectorFilterInto(const Vector* const src, Vector* const dst, const enum CompareOp op,
+                          const void* const value, const enum NumericType type){
+    if (!src){
+        return CDS_NOT_FOUND;
+    }
+    return _filterInto(src->container, src->length, src->data_size, dst, op, value, type);
+}
+
+cds_bool vectorMin(const Vector* const vec, const enum NumericType type, void* const out){
+    return TYPE_MATCHES(vec, type) && arrMin(vec->container, vec->length, type, out);
+}
+
+cds_bool vectorMax(const Vector* const vec, const enum NumericType type, void* const out){
+    return TYPE_MATCHES(vec, type) && arrMax(vec->container, vec->length, type, out);
+}
+
+cds_bool vectorSum(const Vector* const vec, const enum NumericType type, void* const out){
+    if (!TYPE_MATCHES(vec, type) || !out){
+        return false;
+    }
+    arrSum(vec->container, vec->length, type, out);
+    return true;
+}
+
+cds_bool vectorPrefixSum(Vector* const vec, const enum NumericType type){
+    if (!TYPE_MATCHES(vec, type) || vec->read_only){
+        return false;
+    }
+    arrPrefixSum(vec->container, vec->length, type);
+    return true;
+}
+
+cds_size tupleFind(const Tuple* const tuple, const void* const value){
+    if (!tuple){
+        return CDS_NOT_FOUND;
+    }
+    return arrFind(tuple->container, tuple->length, tuple->data_size, value);
+}
+
+cds_size tupleCount(const Tuple* const tuple, const void* const value){
+    if (!tuple){
+        return 0;
+    }
+    return arrCount(tuple->container, tuple->length, tuple->data_size, value);
+}
+
+cds_size vectorSliceFind(const VectorSlice* const slice, const void* const value){
+    if (!slice){
+        return CDS_NOT_FOUND;
+    }
+    return arrFind(slice->data, slice->length, slice->data_size, value);
+}
+
+cds_size vectorSliceCount(const VectorSlice* const slice, const void* const value){
+    if (!slice){
+        return 0;
+    }
+    return arrCount(slice->data, slice->length, slice->data_size, value);
+}
+
+cds_size tupleSliceFind(const TupleSlice* const slice, const void* const value){
+    if (!slice){
+        return CDS_NOT_FOUND;
+    }
+    return arrFind(slice->data, slice->length, slice->data_size, value);
+}
+
+cds_size tupleSliceCount(const TupleSlice* const slice, const void* const value){
+    if (!slice){
+        return 0;
+    }
+    return arrCount(slice->data, slice->length, slice->data_size, value);
+}
+
+cds_size tupleFilterInto(const Tuple* const src, Vector* const dst, const enum CompareOp op,
+                         const void* const value, const enum NumericType type){
+    if (!src){
+        return CDS_NOT_FOUND;
+    }
+    return _filterInto(src->container, src->length, src->data_size, dst, op, value, type);
+}
+
+cds_bool tupleMin(const Tuple* const tuple, const enum NumericType type, void* const out){
+    return TYPE_MATCHES(tuple, type) && arrMin(tuple->container, tuple->length, type, out);
+}
+
+cds_bool tupleMax(const Tuple* const tuple, const enum NumericType type, void* const out){
+    return TYPE_MATCHES(tuple, type) && arrMax(tuple->container, tuple->length, type, out);
+}
+
+cds_bool tupleSum(const Tuple* const tuple, const enum NumericType type, void* const out){
+    if (!TYPE_MATCHES(tuple, type) || !out){
+        return false;
+    }
+    arrSum(tuple->container, tuple->length, type, out);
+    return true;
+}
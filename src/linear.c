@@ -5,81 +5,114 @@
  * @brief Implementation of the linear API.
 */
 
-#include "../include/linear.h"
+#include "../include/_private_linear.h"
 #include "../include/_private_hash.h"
+#include "../include/segmented_vector.h"
+#include "../include/packed_vector.h"
+#include "../include/_private_memory.h"
+#include "../include/arena.h"
 #include <string.h>
 #include <stdarg.h>
-
-enum ContainerType{
-    CDS_VECTOR,
-    CDS_TUPLE,
-    CDS_SLINKED_LIST,
-    CDS_DLINKED_LIST,
-    CDS_STACKS,
-    CDS_HASH_TABLE,
-    CDS_SET,
-};
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 /** Preprossessors functions for container types */
 
-#define LENGTH(container) (container? container->length: 0)
-
-#define CAPACITY(container) (container? container->capacity: 0)
+#define LENGTH(container) ((container) ? (container)->length : 0)
 
-/**/
-struct Vector{
-    cds_size length;
-    cds_size capacity;
-    cds_size data_size;
-    void* container;
-};
+#define CAPACITY(container) ((container) ? (container)->capacity : 0)
 
-struct Tuple{
-    cds_size length;
-    cds_size data_size;
-    const void* container;
-};
+/* Valid for both vectors and tuples, it is expanded inline by the getters. */
+#define CHECK_INDEX(container, index) ((container) && (index) < (container)->length)
 
+/**
+ * Packs the allocation options of the buffer of a tuple into its header (see
+ * `struct Tuple`); `NULL` options mean the defaults.
+*/
+static void _tupleSetOptions(Tuple* const tuple, const AllocOptions* const options){
+    tuple->alignment = options && options->alignment ? (cds_uchar) (_log2(options->alignment) + 1) : 0;
+    tuple->huge_pages = (cds_uchar) (options ? options->huge_pages : HUGE_PAGES_NONE);
+}
 
-static cds_bool _checkIndex(const void* const container, const enum ContainerType type,
-                            const cds_size index){
-    union {
-        Vector* vec;
-        Tuple* tuple;
-    }instance;
-    cds_bool result = true;
-    switch(type){
-        case CDS_VECTOR:
-        instance.vec = (Vector*) container;
-        if (!instance.vec){
-            result = false;
-        }else if(!instance.vec->length || index >= instance.vec->length){
-            result = false;
-        }
-        break;
-        case CDS_TUPLE:
-        instance.tuple = (Tuple*) container;
-        if (!instance.tuple){
-            result = false;
-        }else if (index >= instance.tuple->length){
-            result = false;
-        }
-        default:
-        break;
-    }
-    return result;
+static cds_size _tupleAlignment(const Tuple* const tuple){
+    return tuple->alignment ? (cds_size) 1 << (tuple->alignment - 1) : 0;
 }
+
 /**
 * VECTOR
 */
 
 /**
- * Constructor for the dynamic array structure (vector). The array is created with
- * capacity determined by min_capacity to be the least power of 2 greater than The
- * min_capacity.
+ * Allocation of the buffer of a vector according to its storage.
 */
-Vector* vectorCreate(const cds_size min_capacity, const cds_size data_size){
-    if (min_capacity <= 0){
+static void* _vectorAllocContainer(const Vector* const vec, const cds_size capacity){
+    switch (vec->storage){
+        case VECTOR_STORAGE_MMAP:
+        // copies of file backed vectors live in anonymous memory.
+        case VECTOR_STORAGE_FILE:
+            return _mapAlloc(capacity * vec->data_size, HUGE_PAGES_NONE != vec->options.huge_pages);
+        case VECTOR_STORAGE_HEAP:
+            break;
+    }
+    return _cdsAlloc(capacity * vec->data_size, &vec->options);
+}
+
+static void _vectorFreeContainer(Vector* const vec){
+    switch (vec->storage){
+        case VECTOR_STORAGE_MMAP:
+            _mapFree(vec->container, vec->capacity * vec->data_size);
+            break;
+        case VECTOR_STORAGE_FILE:
+            _mapFree(vec->container, vec->capacity * vec->data_size);
+            if (!vec->read_only){
+                (void) ftruncate(vec->fd, (off_t) (vec->length * vec->data_size));
+            }
+            (void) close(vec->fd);
+            break;
+        case VECTOR_STORAGE_HEAP:
+            _cdsFree(vec->container, vec->capacity * vec->data_size, &vec->options);
+            break;
+    }
+}
+
+/**
+ * Resizes the buffer of the vector. Mapped buffers are remapped, so their
+ * elements are not copied.
+*/
+static cds_bool _vectorResize(Vector* const vec, const cds_size new_capacity){
+    if (vec->data_size && (cds_size) -1 / vec->data_size < new_capacity){
+        return false;
+    }
+    void* new_container = NULL;
+    switch (vec->storage){
+        case VECTOR_STORAGE_MMAP:
+            new_container = _mapRealloc(vec->container, vec->capacity * vec->data_size,
+                                        new_capacity * vec->data_size);
+            break;
+        case VECTOR_STORAGE_FILE:
+            if (vec->read_only){
+                return false;
+            }
+            new_container = _mapFileResize(vec->container, vec->fd, vec->capacity * vec->data_size,
+                                           new_capacity * vec->data_size);
+            break;
+        case VECTOR_STORAGE_HEAP:
+            new_container = _cdsRealloc(vec->container, vec->capacity * vec->data_size,
+                                        new_capacity * vec->data_size, &vec->options);
+            break;
+    }
+    if (!new_container){
+        return false;
+    }
+    vec->container = new_container;
+    vec->capacity = new_capacity;
+    return true;
+}
+
+static Vector* _vectorCreate(const cds_size min_capacity, const cds_size data_size,
+                             const enum VectorStorage storage, const AllocOptions* const options){
+    if (min_capacity <= 0 || !_allocOptionsValid(options)){
         return (Vector*) NULL;
     }
     Vector* new_vec = (Vector*) malloc(sizeof(Vector));
@@ -87,23 +120,144 @@ Vector* vectorCreate(const cds_size min_capacity, const cds_size data_size){
         return (Vector*) NULL;
     }
     cds_size pow = _log2(min_capacity) + 1;
-    if (pow >= _MAX_POW2_){
+    if (pow >= _MAX_POW2_ || (data_size && (cds_size) -1 / data_size < ((cds_size) 1 << pow))){
         free(new_vec);
         return (Vector*) NULL;
     }
-    cds_size capacity = 1 << pow;
-    void* container = (void*) malloc(capacity * data_size);
+    cds_size capacity = (cds_size) 1 << pow;
+    new_vec->data_size = data_size;
+    new_vec->storage = storage;
+    new_vec->options = options ? *options : (AllocOptions){0, HUGE_PAGES_NONE};
+    new_vec->read_only = false;
+    new_vec->fd = -1;
+    void* container = _vectorAllocContainer(new_vec, capacity);
     if (!container){
         free(new_vec);
         return (Vector*) NULL;
     }
     new_vec->length = 0;
     new_vec->capacity = capacity;
-    new_vec->data_size = data_size;
     new_vec->container = container;
     return new_vec;
 }
 
+/**
+ * Constructor for the dynamic array structure (vector). The array is created with
+ * capacity determined by min_capacity to be the least power of 2 greater than The
+ * min_capacity.
+*/
+Vector* vectorCreate(const cds_size min_capacity, const cds_size data_size){
+    return _vectorCreate(min_capacity, data_size, VECTOR_STORAGE_HEAP, NULL);
+}
+
+Vector* vectorCreateWithOptions(const cds_size min_capacity, const cds_size data_size,
+                                const AllocOptions* const options){
+    return _vectorCreate(min_capacity, data_size, VECTOR_STORAGE_HEAP, options);
+}
+
+Vector* vectorCreateLarge(const cds_size min_capacity, const cds_size data_size,
+                          const cds_bool huge_pages){
+    if (!data_size){
+        return (Vector*) NULL;
+    }
+    AllocOptions options = {0, huge_pages ? HUGE_PAGES_TRANSPARENT : HUGE_PAGES_NONE};
+    return _vectorCreate(min_capacity, data_size, VECTOR_STORAGE_MMAP, &options);
+}
+
+/**
+ * Opens the file according to the mode and retrieves its size.
+*/
+static cds_int _openMappedFile(const cds_char* const path, const enum MappedMode mode,
+                               cds_size* const psize){
+    cds_int flags = O_RDONLY;
+    switch (mode){
+        case MAPPED_READ_ONLY:
+            break;
+        case MAPPED_READ_WRITE:
+            flags = O_RDWR | O_CREAT;
+            break;
+        case MAPPED_TRUNCATE:
+            flags = O_RDWR | O_CREAT | O_TRUNC;
+            break;
+    }
+    cds_int fd = open(path, flags, 0644);
+    if (fd < 0){
+        return -1;
+    }
+    struct stat st;
+    if (0 != fstat(fd, &st)){
+        (void) close(fd);
+        return -1;
+    }
+    *psize = (cds_size) st.st_size;
+    return fd;
+}
+
+Vector* vectorOpenMapped(const cds_char* const path, const cds_size data_size,
+                         const enum MappedMode mode){
+    if (!path || !data_size){
+        return (Vector*) NULL;
+    }
+    cds_size file_size = 0;
+    cds_int fd = _openMappedFile(path, mode, &file_size);
+    if (fd < 0){
+        return (Vector*) NULL;
+    }
+    if (file_size % data_size){
+        (void) close(fd);
+        return (Vector*) NULL;
+    }
+    Vector* new_vec = (Vector*) malloc(sizeof(Vector));
+    if (!new_vec){
+        (void) close(fd);
+        return (Vector*) NULL;
+    }
+    new_vec->length = file_size / data_size;
+    new_vec->data_size = data_size;
+    new_vec->storage = VECTOR_STORAGE_FILE;
+    new_vec->options = (AllocOptions){0, HUGE_PAGES_NONE};
+    new_vec->read_only = MAPPED_READ_ONLY == mode;
+    new_vec->fd = fd;
+    new_vec->capacity = new_vec->length;
+    new_vec->container = NULL;
+    if (new_vec->read_only){
+        new_vec->container = _mapFile(fd, file_size, false);
+    }else{
+        // the file is grown up to the capacity, as any other vector.
+        new_vec->capacity = (cds_size) 1 << (_log2(new_vec->length) + 1);
+        new_vec->container = _mapFileResize(NULL, fd, 0, new_vec->capacity * data_size);
+    }
+    if (!new_vec->container && new_vec->capacity){
+        (void) close(fd);
+        free(new_vec);
+        return (Vector*) NULL;
+    }
+    return new_vec;
+}
+
+cds_bool vectorSync(Vector* const vec){
+    if (!vec || VECTOR_STORAGE_FILE != vec->storage || vec->read_only){
+        return true;
+    }
+    if (!_mapSync(vec->container, vec->length * vec->data_size)){
+        return false;
+    }
+    if (vec->length == vec->capacity){
+        return true;
+    }
+    if (vec->length){
+        return _vectorResize(vec, vec->length);
+    }
+    // an empty file has nothing to map.
+    if (0 != ftruncate(vec->fd, 0)){
+        return false;
+    }
+    _mapFree(vec->container, vec->capacity * vec->data_size);
+    vec->container = NULL;
+    vec->capacity = 0;
+    return true;
+}
+
 Vector* vectorFromArray(const void* arr, const cds_size data_size, const cds_size arr_len){
     Vector* new_vec = vectorCreate(arr_len, data_size);
     if (!new_vec){
@@ -122,7 +276,12 @@ Vector* vectorCopy(const Vector* const vec){
     if (!copy){
         return (Vector*) NULL;
     }
-    void* container = malloc(vec->capacity * vec->data_size);
+    copy->storage = VECTOR_STORAGE_FILE == vec->storage ? VECTOR_STORAGE_MMAP : vec->storage;
+    copy->options = vec->options;
+    copy->read_only = false;
+    copy->fd = -1;
+    copy->data_size = vec->data_size;
+    void* container = _vectorAllocContainer(copy, vec->capacity);
     if (!container){
     free(copy);
         return (Vector*) NULL;
@@ -132,7 +291,6 @@ Vector* vectorCopy(const Vector* const vec){
         (void) memmove(copy->container, vec->container, vec->length*vec->data_size);
     }
     copy->length = vec->length;
-    copy->data_size = vec->data_size;
     copy->capacity = vec->capacity;
     return copy;
 }
@@ -155,12 +313,12 @@ void vectorDelete(Vector* vec){
     if (!vec){
         return;
     }
-    free(vec->container);
+    _vectorFreeContainer(vec);
     free(vec);
 }
 
 const void* vectorGetAt(const Vector* const vec, const size_t index){
-    if (!_checkIndex(vec, CDS_VECTOR, index)){
+    if (!CHECK_INDEX(vec, index)){
         return (void*) NULL;
     }
     void* _data = CDS_BYTE_OFFSET(vec->container, vec->data_size*index);
@@ -171,21 +329,43 @@ const void* vectorGetAt(const Vector* const vec, const size_t index){
  * It expand the array to twice its capacity. 
 */
 static cds_bool _vectorExpand(Vector* vec){
-    cds_size new_capacity = vec->capacity << 1;
+    cds_size new_capacity = vec->capacity ? vec->capacity << 1 : 1;
     if (new_capacity <= vec->capacity){
         return false;
     }
-    void* new_container = (void*) realloc(vec->container, new_capacity * vec->data_size);
-    if (!new_container){
+    return _vectorResize(vec, new_capacity);
+}
+
+cds_bool vectorReserve(Vector* const vec, const cds_size min_capacity){
+    if (!VECTOR_WRITABLE(vec)){
         return false;
     }
-    vec->container = new_container;
-    vec->capacity = new_capacity;
-    return true;
+    if (min_capacity <= vec->capacity){
+        return true;
+    }
+    cds_size pow = _log2(min_capacity - 1) + 1;
+    if (pow >= _MAX_POW2_){
+        return false;
+    }
+    return _vectorResize(vec, (cds_size) 1 << pow);
+}
+
+cds_bool vectorShrinkToFit(Vector* const vec){
+    if (!VECTOR_WRITABLE(vec)){
+        return false;
+    }
+    cds_size new_capacity = vec->length ? vec->length : 1;
+    if (new_capacity == vec->capacity){
+        return true;
+    }
+    return _vectorResize(vec, new_capacity);
 }
 
 /** Push back function for the dynamic array structure */
 cds_bool vectorPrepend(Vector* const vec, void* data){
+    if (!VECTOR_WRITABLE(vec)){
+        return false;
+    }
     if ( ((double) vec->capacity) * _EXPANSION_RATE_CHECK <= (double) vec->length){
         (void) _vectorExpand(vec);
     }
@@ -197,8 +377,8 @@ cds_bool vectorPrepend(Vector* const vec, void* data){
     return true;
 }
 
-void* vectorUpdate(Vector* const vec, void* data, const cds_size index){
-    if (!_checkIndex(vec, CDS_VECTOR, index)){
+void* vectorUpdateAt(Vector* const vec, void* data, const cds_size index){
+    if (!CHECK_INDEX(vec, index) || vec->read_only){
         return (void*) NULL;
     }
     void* _data = (void*) vectorGetAt(vec, index);
@@ -246,28 +426,185 @@ Tuple* vectorToTuple(const Vector* const vec){
     return tuple;
 }
 
+Tuple* vectorIntoTuple(Vector* vec, const cds_bool shrink_to_fit){
+    if (!vec){
+        return (Tuple*) NULL;
+    }
+    Tuple* tuple = (Tuple*) malloc(sizeof(Tuple));
+    if (!tuple){
+        return (Tuple*) NULL;
+    }
+    if (shrink_to_fit && vec->length && vec->length < vec->capacity){
+        // a failed shrink keeps the larger buffer.
+        (void) _vectorResize(vec, vec->length);
+    }
+    switch (vec->storage){
+        case VECTOR_STORAGE_HEAP:
+            tuple->storage = TUPLE_STORAGE_HEAP;
+            break;
+        case VECTOR_STORAGE_MMAP:
+            tuple->storage = TUPLE_STORAGE_MMAP;
+            break;
+        case VECTOR_STORAGE_FILE:
+            // the mapping outlives the file descriptor.
+            if (!vec->read_only){
+                (void) ftruncate(vec->fd, (off_t) (vec->length * vec->data_size));
+            }
+            (void) close(vec->fd);
+            tuple->storage = TUPLE_STORAGE_FILE;
+            break;
+    }
+    tuple->length = vec->length;
+    tuple->data_size = vec->data_size;
+    tuple->container = vec->container;
+    tuple->buffer_size = vec->capacity * vec->data_size;
+    _tupleSetOptions(tuple, &vec->options);
+    free(vec);
+    return tuple;
+}
+
+Tuple* vectorToTupleView(const Vector* const vec){
+    if (!vec){
+        return (Tuple*) NULL;
+    }
+    Tuple* view = (Tuple*) malloc(sizeof(Tuple));
+    if (!view){
+        return (Tuple*) NULL;
+    }
+    view->length = vec->length;
+    view->data_size = vec->data_size;
+    view->container = vec->container;
+    view->buffer_size = 0;
+    view->storage = TUPLE_STORAGE_VIEW;
+    _tupleSetOptions(view, &vec->options);
+    return view;
+}
+
+/**
+ * SLICES
+ * ------
+ * Vector and tuple slices share the range computation.
+*/
+
+/**
+ * Retrieves the first element of the range of a slice, truncating its length
+ * to the `total` elements available.
+*/
+static void* _sliceStart(const void* const data, const cds_size total, const cds_size data_size,
+                         const cds_size start, const cds_size length, cds_size* const plength){
+    if (!data || start >= total){
+        *plength = 0;
+        return NULL;
+    }
+    *plength = length < total - start ? length : total - start;
+    return CDS_BYTE_OFFSET(data, start*data_size);
+}
+
+VectorSlice vectorSlice(const Vector* const vec, const cds_size start, const cds_size length){
+    VectorSlice slice = {NULL, 0, vec ? vec->data_size : 0};
+    if (vec){
+        slice.data = _sliceStart(vec->container, vec->length, vec->data_size, start, length,
+                                 &slice.length);
+    }
+    return slice;
+}
+
+VectorSlice vectorSliceSub(const VectorSlice* const slice, const cds_size start,
+                           const cds_size length){
+    VectorSlice sub = {NULL, 0, slice ? slice->data_size : 0};
+    if (slice){
+        sub.data = _sliceStart(slice->data, slice->length, slice->data_size, start, length,
+                               &sub.length);
+    }
+    return sub;
+}
+
+void* vectorSliceGetAt(const VectorSlice* const slice, const cds_size index){
+    if (!CHECK_INDEX(slice, index)){
+        return NULL;
+    }
+    return CDS_BYTE_OFFSET(slice->data, index*slice->data_size);
+}
+
+TupleSlice tupleSlice(const Tuple* const tuple, const cds_size start, const cds_size length){
+    TupleSlice slice = {NULL, 0, tuple ? tuple->data_size : 0};
+    if (tuple){
+        slice.data = _sliceStart(tuple->container, tuple->length, tuple->data_size, start, length,
+                                 &slice.length);
+    }
+    return slice;
+}
+
+TupleSlice tupleSliceSub(const TupleSlice* const slice, const cds_size start,
+                         const cds_size length){
+    TupleSlice sub = {NULL, 0, slice ? slice->data_size : 0};
+    if (slice){
+        sub.data = _sliceStart(slice->data, slice->length, slice->data_size, start, length,
+                               &sub.length);
+    }
+    return sub;
+}
+const void* tupleSliceGetAt(const TupleSlice* const slice, const cds_size index){
+    if (!CHECK_INDEX(slice, index)){
+        return NULL;
+    }
+    return CDS_BYTE_OFFSET(slice->data, index*slice->data_size);
+}
+
 /**
  * TUPLES
  * ------
 */
 
-Tuple* tupleCreate(const cds_size data_size, const cds_size length, ...){
-    Tuple* new_tuple = (Tuple*) malloc(sizeof(Tuple));
-    if (!new_tuple){
+/**
+ * Allocates a tuple for `length` elements of size `data_size`. With the default
+ * options the elements are stored inline, after the header, so a tuple costs a
+ * single allocation and its elements share the cache lines of the header.
+*/
+static Tuple* _tupleAlloc(const cds_size data_size, const cds_size length,
+                          const AllocOptions* const options){
+    if (!_allocOptionsValid(options)){
         return (Tuple*) NULL;
-    }    
-    void* container = malloc(length * data_size);
-    if (!container){
-        free(new_tuple);
+    }
+    const cds_size bytes = length * data_size;
+    if (length && bytes / length != data_size){
         return (Tuple*) NULL;
     }
-    if (!data_size || 0 == length){
-        new_tuple->data_size = 0;
-        new_tuple->length = 0;
+    Tuple* new_tuple = NULL;
+    if (!options || (!options->alignment && HUGE_PAGES_NONE == options->huge_pages)){
+        new_tuple = (Tuple*) malloc(sizeof(Tuple) + bytes);
+        if (!new_tuple){
+            return (Tuple*) NULL;
+        }
+        new_tuple->storage = TUPLE_STORAGE_INLINE;
+        _tupleSetOptions(new_tuple, (const AllocOptions*) NULL);
+        new_tuple->container = new_tuple->data;
+    }else{
+        new_tuple = (Tuple*) malloc(sizeof(Tuple));
+        if (!new_tuple){
+            return (Tuple*) NULL;
+        }
+        _tupleSetOptions(new_tuple, options);
+        void* container = _cdsAlloc(bytes, options);
+        if (!container){
+            free(new_tuple);
+            return (Tuple*) NULL;
+        }
+        new_tuple->storage = TUPLE_STORAGE_HEAP;
         new_tuple->container = container;
-        return new_tuple;
     }
+    new_tuple->buffer_size = bytes;
     new_tuple->length = 0;
+    new_tuple->data_size = 0;
+    return new_tuple;
+}
+
+Tuple* tupleCreate(const cds_size data_size, const cds_size length, ...){
+    Tuple* new_tuple = _tupleAlloc(data_size, length, NULL);
+    if (!new_tuple || !data_size || 0 == length){
+        return new_tuple;
+    }
+    void* container = (void*) new_tuple->container;
     va_list args;
     va_start(args, length);
     void* data = NULL;
@@ -278,30 +615,75 @@ Tuple* tupleCreate(const cds_size data_size, const cds_size length, ...){
     }
     va_end(args);
     new_tuple->data_size = data_size;
-    new_tuple->container = container;
+    return new_tuple;
+}
+
+Tuple* tupleFromArrayWithOptions(const void* const arr, const cds_size data_size,
+                                 const cds_size arr_len, const AllocOptions* const options){
+    Tuple* new_tuple = _tupleAlloc(data_size, arr ? arr_len : 0, options);
+    if (!new_tuple || !arr || 0 == arr_len){
+        return new_tuple;
+    }
+    (void) memmove((void*) new_tuple->container, arr, arr_len*data_size);
+    new_tuple->length = arr_len;
+    new_tuple->data_size = data_size;
     return new_tuple;
 }
 
 Tuple* tupleFromArray(const void* const arr, const size_t data_size, const size_t arr_len){
-    Tuple* new_tuple = (Tuple*) malloc(sizeof(Tuple));
+    return tupleFromArrayWithOptions(arr, data_size, arr_len, NULL);
+}
+
+Tuple* tupleCreateInArena(Arena* const arena, const void* const arr, const cds_size data_size,
+                          const cds_size length){
+    const cds_size bytes = length * data_size;
+    if (!arena || (length && (!arr || bytes / length != data_size))
+        || bytes > (cds_size) -1 - sizeof(Tuple)){
+        return (Tuple*) NULL;
+    }
+    Tuple* new_tuple = (Tuple*) arenaAlloc(arena, sizeof(Tuple) + bytes);
     if (!new_tuple){
         return (Tuple*) NULL;
-    }    
-    void* container = malloc(arr_len*data_size);
-    if (!container){
-        free(new_tuple);
+    }
+    new_tuple->length = length;
+    new_tuple->data_size = data_size;
+    new_tuple->container = new_tuple->data;
+    new_tuple->buffer_size = bytes;
+    new_tuple->storage = TUPLE_STORAGE_ARENA;
+    _tupleSetOptions(new_tuple, (const AllocOptions*) NULL);
+    if (bytes){
+        (void) memcpy(new_tuple->data, arr, bytes);
+    }
+    return new_tuple;
+}
+
+Tuple* tupleOpenMapped(const cds_char* const path, const cds_size data_size){
+    if (!path || !data_size){
         return (Tuple*) NULL;
     }
-    if (!arr || 0 == arr_len){
-        new_tuple->data_size = 0;
-        new_tuple->length = 0;
-        new_tuple->container = container;
-        return new_tuple;
+    cds_size file_size = 0;
+    cds_int fd = _openMappedFile(path, MAPPED_READ_ONLY, &file_size);
+    if (fd < 0){
+        return (Tuple*) NULL;
     }
-    (void) memmove(container, arr, arr_len*data_size);
-    new_tuple->container = (const void*) container;
-    new_tuple->length = arr_len;
+    // the mapping outlives the file descriptor.
+    const void* container = _mapFile(fd, file_size, false);
+    (void) close(fd);
+    if ((!container && file_size) || file_size % data_size){
+        _mapFree((void*) container, file_size);
+        return (Tuple*) NULL;
+    }
+    Tuple* new_tuple = (Tuple*) malloc(sizeof(Tuple));
+    if (!new_tuple){
+        _mapFree((void*) container, file_size);
+        return (Tuple*) NULL;
+    }
+    new_tuple->length = file_size / data_size;
     new_tuple->data_size = data_size;
+    new_tuple->container = container;
+    new_tuple->buffer_size = file_size;
+    new_tuple->storage = TUPLE_STORAGE_FILE;
+    _tupleSetOptions(new_tuple, (const AllocOptions*) NULL);
     return new_tuple;
 }
 
@@ -309,14 +691,28 @@ void tupleDelete(Tuple* tuple){
     if (!tuple){
         return;
     }
-    if (tuple->container){
-        free((void*) tuple->container);
+    switch (tuple->storage){
+        case TUPLE_STORAGE_ARENA:
+            // released with the arena.
+            return;
+        case TUPLE_STORAGE_INLINE:
+            break;
+        case TUPLE_STORAGE_HEAP:
+            _cdsFree((void*) tuple->container, tuple->buffer_size, &(AllocOptions){_tupleAlignment(tuple),
+                     (enum HugePageHint) tuple->huge_pages});
+            break;
+        case TUPLE_STORAGE_MMAP:
+        case TUPLE_STORAGE_FILE:
+            _mapFree((void*) tuple->container, tuple->buffer_size);
+            break;
+        case TUPLE_STORAGE_VIEW:
+            break;
     }
     free(tuple);
 }
 
 const void* tupleGetAt(const Tuple* const tuple, const cds_size index){
-    if (!_checkIndex(tuple, CDS_TUPLE, index)){
+    if (!CHECK_INDEX(tuple, index)){
         return (void*) NULL;
     }
     const void* data = (const void*) CDS_BYTE_OFFSET(tuple->container, index*tuple->data_size);
@@ -334,25 +730,55 @@ const void* tupleToArr(const Tuple* const tuple){
 Vector* tupleToVector(const Tuple* const tuple){
     return vectorFromArray(tuple->container, tuple->data_size, tuple->length);
 }
+
+Vector* tupleIntoVector(Tuple* tuple){
+    if (!tuple){
+        return (Vector*) NULL;
+    }
+    Vector* vec = NULL;
+    switch (tuple->storage){
+        case TUPLE_STORAGE_HEAP:
+        case TUPLE_STORAGE_MMAP:
+            // vectors cannot expand from a zero capacity.
+            if (tuple->buffer_size && tuple->data_size){
+                vec = (Vector*) malloc(sizeof(Vector));
+            }
+            break;
+        case TUPLE_STORAGE_INLINE:
+        case TUPLE_STORAGE_ARENA:
+        case TUPLE_STORAGE_FILE:
+        case TUPLE_STORAGE_VIEW:
+            break;
+    }
+    if (!vec){
+        vec = tuple->length ? tupleToVector(tuple) : vectorCreate(1, tuple->data_size);
+        if (vec){
+            tupleDelete(tuple);
+        }
+        return vec;
+    }
+    vec->length = tuple->length;
+    vec->data_size = tuple->data_size;
+    vec->capacity = tuple->buffer_size / tuple->data_size;
+    vec->container = (void*) tuple->container;
+    vec->storage = TUPLE_STORAGE_MMAP == tuple->storage ? VECTOR_STORAGE_MMAP : VECTOR_STORAGE_HEAP;
+    vec->options = (AllocOptions){_tupleAlignment(tuple), (enum HugePageHint) tuple->huge_pages};
+    vec->read_only = false;
+    vec->fd = -1;
+    free(tuple);
+    return vec;
+}
 /**
  * SINGLY LINKED LIST
  * -------------------
 */
-typedef struct SLLNode{
-    void* data;
-    struct SLLNode* next;
-}SLLNode;
-
-struct SLList{
-    cds_size data_size;
-    cds_size length;
-    SLLNode* head;
-    SLLNode* tail;
-};
-
 /** Creator function for the singly linked list strucutre */
 
-SLList* sllCreate(const cds_size data_size){
+cds_size sllNodeSize(const cds_size data_size){
+    return sizeof(SLLNode) + data_size;
+}
+
+static SLList* _sllCreate(const cds_size data_size, Pool* const pool, const cds_bool owns_pool){
     SLList* new_list = (SLList*) malloc(sizeof(SLList));
     if (!new_list){
         return (SLList*) NULL;
@@ -361,33 +787,66 @@ SLList* sllCreate(const cds_size data_size){
     new_list->length = 0;
     new_list->head = (SLLNode*) NULL;
     new_list->tail = (SLLNode*) NULL;
+    new_list->pool = pool;
+    new_list->owns_pool = owns_pool;
     return new_list;
 }
 
+SLList* sllCreate(const cds_size data_size){
+    Pool* pool = poolCreate(sllNodeSize(data_size), SLL_NODES_PER_SLAB);
+    if (!pool){
+        return (SLList*) NULL;
+    }
+    SLList* new_list = _sllCreate(data_size, pool, true);
+    if (!new_list){
+        poolDelete(pool);
+    }
+    return new_list;
+}
+
+SLList* sllCreateWithPool(const cds_size data_size, Pool* const pool){
+    if (poolObjectSize(pool) < sllNodeSize(data_size)){
+        return (SLList*) NULL;
+    }
+    return _sllCreate(data_size, pool, false);
+}
+
 void sllDelete(SLList* list){
-    SLLNode* current;
-    while (list->head){
-        current = list->head;
-        list->head = list->head->next;
-        free(current);
+    if (!list){
+        return;
     }
+    // nodes are released in bulk: the whole pool, or the chain back to it.
+    if (list->owns_pool){
+        poolDelete(list->pool);
+    }
+    else{
+        poolFreeChain(list->pool, list->head, list->tail);
+    }
+    free(list);
+}
+
+cds_size sllLength(const SLList* const list){
+    return list ? list->length : 0;
 }
 
-static SLLNode* _sllCreateNode(void* data, SLLNode* const next){
+static SLLNode* _sllCreateNode(SLList* const list, const void* data, SLLNode* const next){
     if (!data){
         return (SLLNode*) NULL;
     }
-    SLLNode* new_node = (SLLNode*) malloc(sizeof(SLLNode));
+    SLLNode* new_node = (SLLNode*) poolAlloc(list->pool);
     if (!new_node){
         return (SLLNode*) NULL;
     }
-    new_node->data = data;
+    memcpy(new_node->data, data, list->data_size);
     new_node->next = next;
     return new_node;
 }
 
-cds_bool sllPrepend(SLList* list, void* data){
-    SLLNode* new_head = _sllCreateNode(data, list->head);
+cds_bool sllPrepend(SLList* list, const void* data){
+    if (!list){
+        return false;
+    }
+    SLLNode* new_head = _sllCreateNode(list, data, list->head);
     if (!new_head){
         return false;
     }
@@ -400,16 +859,37 @@ cds_bool sllPrepend(SLList* list, void* data){
     return true;
 }
 
-cds_bool sllAppend(SLList* list, void* data){
+cds_bool sllAppend(SLList* list, const void* data){
+    if (!list){
+        return false;
+    }
     if (!list->head){
         return sllPrepend(list, data);
     }
-    if (!data){
+    SLLNode* new_tail = _sllCreateNode(list, data, (SLLNode*) NULL);
+    if (!new_tail){
         return false;
     }
-    SLLNode* new_tail = _sllCreateNode(data, (SLLNode*) NULL);
     list->tail->next = new_tail;
     list->tail = new_tail;
+    list->length++;
+    return true;
+}
+
+cds_bool sllPopFront(SLList* list, void* const out){
+    if (!list || !list->head){
+        return false;
+    }
+    SLLNode* old_head = list->head;
+    if (out){
+        memcpy(out, old_head->data, list->data_size);
+    }
+    list->head = old_head->next;
+    if (!list->head){
+        list->tail = (SLLNode*) NULL;
+    }
+    list->length--;
+    poolFree(list->pool, old_head);
     return true;
 }
 
@@ -423,13 +903,15 @@ struct Iter{
     cds_size data_size; // for linear containers
     enum IterableType type;
     const void* container;
+    void* buffer;       // decoded block of packed vectors
+    cds_size offset;    // position in the current node of unrolled lists
 };
 
-#define GET_CONTAINER(ptr_s, type) ((type*) ptr_s)->container
-#define GET_LENGTH(ptr_s, type) ((type*) ptr_s)->length
-#define GET_CAPACITY(ptr_s, type) ((type*) ptr_s)->capacity
-#define GET_SLL_HEAD(ptr_s, type) ((type*) ptr_s)->head
-#define GET_DATA_SIZE(ptr_s, type) ((type*) ptr_s)->data_size
+#define GET_CONTAINER(ptr_s, type) ((type*) (ptr_s))->container
+#define GET_LENGTH(ptr_s, type) ((type*) (ptr_s))->length
+#define GET_CAPACITY(ptr_s, type) ((type*) (ptr_s))->capacity
+#define GET_SLL_HEAD(ptr_s, type) ((type*) (ptr_s))->head
+#define GET_DATA_SIZE(ptr_s, type) ((type*) (ptr_s))->data_size
 
 Iter* iterCreate(const void* const container, const enum IterableType type){
     if (!container){
@@ -439,6 +921,9 @@ Iter* iterCreate(const void* const container, const enum IterableType type){
     if (!new_iter){
         return (Iter*) NULL;
     }
+    new_iter->index_max = 0;
+    new_iter->buffer = NULL;
+    new_iter->offset = 0;
     switch (type){
         case VECTOR:
             new_iter->container = GET_CONTAINER(container, Vector);
@@ -455,6 +940,11 @@ Iter* iterCreate(const void* const container, const enum IterableType type){
             new_iter->index_max = GET_LENGTH(container, SLList);
             new_iter->data_size = GET_DATA_SIZE(container, SLList);
             break;
+        case UNROLLED_LIST:
+            new_iter->container = GET_SLL_HEAD(container, UnrolledList);
+            new_iter->index_max = GET_LENGTH(container, UnrolledList);
+            new_iter->data_size = GET_DATA_SIZE(container, UnrolledList);
+            break;
         case HASH_TABLE:
             new_iter->container = GET_CONTAINER(container, HashTable);
             new_iter->index_max = GET_CAPACITY(container, HashTable);
@@ -465,6 +955,36 @@ Iter* iterCreate(const void* const container, const enum IterableType type){
             new_iter->index_max = GET_CAPACITY(container, Set);
             new_iter->data_size = sizeof(SetEntry);
             break;
+        case SEG_VECTOR:
+            new_iter->container = container;
+            new_iter->index_max = segvecLength((const SegVector*) container);
+            new_iter->data_size = 0;
+            break;
+        case VECTOR_SLICE:
+            new_iter->container = ((const VectorSlice*) container)->data;
+            new_iter->index_max = GET_LENGTH(container, VectorSlice);
+            new_iter->data_size = GET_DATA_SIZE(container, VectorSlice);
+            break;
+        case TUPLE_SLICE:
+            new_iter->container = ((const TupleSlice*) container)->data;
+            new_iter->index_max = GET_LENGTH(container, TupleSlice);
+            new_iter->data_size = GET_DATA_SIZE(container, TupleSlice);
+            break;
+        case PACKED_VECTOR:
+            new_iter->container = container;
+            new_iter->data_size = packvecDataSize((const PackedVector*) container);
+            new_iter->buffer = malloc(PACKED_BLOCK_SIZE * new_iter->data_size);
+            if (new_iter->buffer){
+                new_iter->index_max = packvecDecode((const PackedVector*) container, 0,
+                                                    PACKED_BLOCK_SIZE, new_iter->buffer)
+                                      ? packvecLength((const PackedVector*) container) : 0;
+            }
+            break;
+    }
+    // empty containers have nothing to reference.
+    if (!new_iter->index_max){
+        iterDelete(new_iter);
+        return (Iter*) NULL;
     }
     new_iter->type = type;
     new_iter->index = 0;
@@ -472,6 +992,10 @@ Iter* iterCreate(const void* const container, const enum IterableType type){
 }
 
 void iterDelete(Iter* iter){
+    if (!iter){
+        return;
+    }
+    free(iter->buffer);
     free(iter);
 }
 
@@ -491,6 +1015,29 @@ Iter* iterNext(Iter* iter){
                 return (Iter*) NULL;
             }
             break;
+        case UNROLLED_LIST:
+            iter->index++;
+            if (iter->index_max == iter->index){
+                iterDelete(iter);
+                return (Iter*) NULL;
+            }
+            if (((const ULLNode*) iter->container)->count == ++iter->offset){
+                iter->container = (void*) ((const ULLNode*) iter->container)->next;
+                iter->offset = 0;
+            }
+            break;
+        case PACKED_VECTOR:
+            iter->index++;
+            if (iter->index_max == iter->index){
+                iterDelete(iter);
+                return (Iter*) NULL;
+            }
+            // packed vectors are decoded a block at a time.
+            if (!(iter->index % PACKED_BLOCK_SIZE)){
+                (void) packvecDecode((const PackedVector*) iter->container, iter->index,
+                                     PACKED_BLOCK_SIZE, iter->buffer);
+            }
+            break;
         default:
             iter->index++;
             if (iter->index_max == iter->index){
@@ -511,17 +1058,28 @@ const void* iterGetData(const Iter* const iter){
             data = CDS_BYTE_OFFSET(iter->container, iter->index * iter->data_size);
             break;
         case TUPLE:
+        case VECTOR_SLICE:
+        case TUPLE_SLICE:
             data = CDS_BYTE_OFFSET(iter->container, iter->index * iter->data_size);
             break;
         case SLLIST:
             data = ((SLLNode*) iter->container)->data;
             break;
+        case UNROLLED_LIST:
+            data = CDS_BYTE_OFFSET(((const ULLNode*) iter->container)->data, iter->offset * iter->data_size);
+            break;
         case HASH_TABLE:
             data = ((HTEntry*) CDS_BYTE_OFFSET(iter->container, iter->index * iter->data_size))->key;
             break;
         case SET:
             data = ((SetEntry*) CDS_BYTE_OFFSET(iter->container, iter->index * iter->data_size))->key;
             break;
+        case SEG_VECTOR:
+            data = segvecGetAt((const SegVector*) iter->container, iter->index);
+            break;
+        case PACKED_VECTOR:
+            data = CDS_BYTE_OFFSET(iter->buffer, (iter->index % PACKED_BLOCK_SIZE) * iter->data_size);
+            break;
     }
     return data;
 }
@@ -529,38 +1087,128 @@ const void* iterGetData(const Iter* const iter){
 /**
  * STACK
  * -----
- * @note Stacks will be implemented as a singly linked list.
+ * @note Stacks are implemented on a vector, whose end is the top of the stack.
 */
 
 struct Stack{
-    cds_size length;
-    cds_size data_size;
-    SLLNode* head;
+    Vector* vec;
 };
 
-Stack* stackCreate(cds_size data_size);
+Stack* stackCreate(cds_size data_size){
+    if (!data_size){
+        return (Stack*) NULL;
+    }
+    Stack* new_stack = (Stack*) malloc(sizeof(Stack));
+    if (!new_stack){
+        return (Stack*) NULL;
+    }
+    new_stack->vec = vectorCreate(STACK_DEFAULT_CAPACITY, data_size);
+    if (!new_stack->vec){
+        free(new_stack);
+        return (Stack*) NULL;
+    }
+    return new_stack;
+}
+
+void stackDelete(Stack* stack){
+    if (!stack){
+        return;
+    }
+    vectorDelete(stack->vec);
+    free(stack);
+}
+
+cds_size stackLength(const Stack* const stack){
+    return stack ? stack->vec->length : 0;
+}
+
+cds_bool stackReserve(Stack* const stack, const cds_size min_capacity){
+    return stack ? vectorReserve(stack->vec, min_capacity) : false;
+}
+
+cds_bool stackPushN(Stack* const stack, const void* const data, const cds_size count){
+    if (!stack || !data){
+        return false;
+    }
+    Vector* vec = stack->vec;
+    // the capacity doubles, hence the pushes take amortized constant time.
+    if (vec->length + count < vec->length
+        || (vec->length + count > vec->capacity && !vectorReserve(vec, vec->length + count))){
+        return false;
+    }
+    memcpy(CDS_BYTE_OFFSET(vec->container, (vec->length*vec->data_size)), data, count*vec->data_size);
+    vec->length += count;
+    return true;
+}
+
+cds_bool stackPush(Stack* stack, const void* data){
+    return stackPushN(stack, data, 1);
+}
 
-void stackDelete(Stack* stack);
+cds_size stackPopN(Stack* const stack, void* const out, const cds_size count){
+    if (!stack){
+        return 0;
+    }
+    Vector* vec = stack->vec;
+    const cds_size popped = count < vec->length ? count : vec->length;
+    vec->length -= popped;
+    if (out){
+        memcpy(out, CDS_BYTE_OFFSET(vec->container, (vec->length*vec->data_size)), popped*vec->data_size);
+    }
+    return popped;
+}
 
-cds_bool stackPush(Stack* stack, void* data);
+cds_bool stackPop(Stack* stack, void* const out){
+    return 1 == stackPopN(stack, out, 1);
+}
 
-void* stackPop(Stack* stack);
+void* stackPeek(const Stack* const stack){
+    if (!stack || !stack->vec->length){
+        return NULL;
+    }
+    return CDS_BYTE_OFFSET(stack->vec->container, ((stack->vec->length - 1)*stack->vec->data_size));
+}
 
 /**
  * QUEUES
  * ------
+ * @note Queues are implemented as a singly linked list, pushing at its tail and
+ * popping at its head.
 */
 
 struct Queue{
-    cds_size length;
-    cds_size data_size;
-    SLLNode* tail;
+    SLList* list;
 };
 
-Queue* queueCreate(cds_size data_size);
+Queue* queueCreate(cds_size data_size){
+    Queue* new_queue = (Queue*) malloc(sizeof(Queue));
+    if (!new_queue){
+        return (Queue*) NULL;
+    }
+    new_queue->list = sllCreate(data_size);
+    if (!new_queue->list){
+        free(new_queue);
+        return (Queue*) NULL;
+    }
+    return new_queue;
+}
+
+void queueDelete(Queue* queue){
+    if (!queue){
+        return;
+    }
+    sllDelete(queue->list);
+    free(queue);
+}
 
-void queueDelete(Queue* queue);
+cds_size queueLength(const Queue* const queue){
+    return queue ? queue->list->length : 0;
+}
 
-cds_bool queuePush(Queue* queue);
+cds_bool queuePush(Queue* queue, const void* data){
+    return queue ? sllAppend(queue->list, data) : false;
+}
 
-void* queuePop(Queue* queue);
+cds_bool queuePop(Queue* queue, void* const out){
+    return queue ? sllPopFront(queue->list, out) : false;
+}
@@ -0,0 +1,223 @@
+/*!
+ * @file memory.c
+ * @copyright GNU General Public Licence 3 or Later (GPLv3).
+ * @author Paulo Arruda
+ * @brief Implementation of the memory mapping helpers.
+*/
+
+#ifdef __linux__
+#define _GNU_SOURCE // mremap
+#endif // __linux__
+
+#include <sys/mman.h>
+#include <unistd.h>
+#include "../include/_private_memory.h"
+
+#ifndef MAP_ANONYMOUS
+#define MAP_ANONYMOUS MAP_ANON
+#endif // MAP_ANONYMOUS
+
+cds_size _pageRound(const cds_size bytes){
+    cds_size page = (cds_size) sysconf(_SC_PAGESIZE);
+    // empty buffers still take a page, so that they can be mapped.
+    return bytes ? (bytes + page - 1) & ~(page - 1) : page;
+}
+
+void* _mapAlloc(const cds_size bytes, const cds_bool huge_pages){
+    void* ptr = mmap(NULL, _pageRound(bytes), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+                     -1, 0);
+    if (MAP_FAILED == ptr){
+        return NULL;
+    }
+#ifdef MADV_HUGEPAGE
+    if (huge_pages){
+        (void) madvise(ptr, _pageRound(bytes), MADV_HUGEPAGE);
+    }
+#else
+    (void) huge_pages;
+#endif // MADV_HUGEPAGE
+    return ptr;
+}
+
+void* _mapRealloc(void* const ptr, const cds_size old_bytes, const cds_size new_bytes){
+#ifdef __linux__
+    void* new_ptr = mremap(ptr, _pageRound(old_bytes), _pageRound(new_bytes), MREMAP_MAYMOVE);
+    return MAP_FAILED == new_ptr ? NULL : new_ptr;
+#else
+    void* new_ptr = _mapAlloc(new_bytes, false);
+    if (!new_ptr){
+        return NULL;
+    }
+    (void) memcpy(new_ptr, ptr, old_bytes < new_bytes ? old_bytes : new_bytes);
+    _mapFree(ptr, old_bytes);
+    return new_ptr;
+#endif // __linux__
+}
+
+void _mapFree(void* const ptr, const cds_size bytes){
+    if (ptr){
+        (void) munmap(ptr, _pageRound(bytes));
+    }
+}
+
+void* _mapFile(const cds_int fd, const cds_size bytes, const cds_bool writable){
+    if (!bytes){
+        return NULL;
+    }
+    void* ptr = mmap(NULL, bytes, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+    return MAP_FAILED == ptr ? NULL : ptr;
+}
+
+void* _mapFileResize(void* const ptr, const cds_int fd, const cds_size old_bytes,
+                     const cds_size new_bytes){
+    if (0 != ftruncate(fd, (off_t) new_bytes)){
+        return NULL;
+    }
+    if (!ptr){
+        return _mapFile(fd, new_bytes, true);
+    }
+#ifdef __linux__
+    void* new_ptr = mremap(ptr, _pageRound(old_bytes), _pageRound(new_bytes), MREMAP_MAYMOVE);
+    return MAP_FAILED == new_ptr ? NULL : new_ptr;
+#else
+    void* new_ptr = _mapFile(fd, new_bytes, true);
+    if (new_ptr){
+        _mapFree(ptr, old_bytes);
+    }
+    return new_ptr;
+#endif // __linux__
+}
+
+cds_bool _mapSync(void* const ptr, const cds_size bytes){
+    if (!ptr || !bytes){
+        return true;
+    }
+    return 0 == msync(ptr, _pageRound(bytes), MS_SYNC);
+}
+
+/**
+ * ALLOCATION OPTIONS
+ * ------------------
+*/
+
+/* Explicit huge page mappings are sized in multiples of this. **/
+#define _HUGE_PAGE_SIZE ((cds_size) 2 << 20)
+
+/*
+ * MAP_HUGETLB alone maps pages of the default hugetlb size of the system,
+ * which may be 1 GiB, so the page size is requested explicitly to match the
+ * rounding (and unmapping) above.
+**/
+#if defined(MAP_HUGE_SHIFT) && !defined(MAP_HUGE_2MB)
+#define MAP_HUGE_2MB (21 << MAP_HUGE_SHIFT)
+#endif // MAP_HUGE_SHIFT
+
+#define HUGE_ROUND(bytes) ((bytes) ? ((bytes) + _HUGE_PAGE_SIZE - 1) & ~(_HUGE_PAGE_SIZE - 1) : \
+                                   _HUGE_PAGE_SIZE)
+
+/* Alignment guaranteed by malloc. **/
+#define _MALLOC_ALIGNMENT (2*sizeof(void*))
+
+cds_bool _allocOptionsValid(const AllocOptions* const options){
+    if (!options){
+        return true;
+    }
+    if (options->alignment & (options->alignment - 1)){
+        return false;
+    }
+    if (HUGE_PAGES_NONE != options->huge_pages && options->alignment > (cds_size) sysconf(_SC_PAGESIZE)){
+        return false;
+    }
+    return true;
+}
+
+/* Whether `malloc`/`realloc` are enough for the options. **/
+#define IS_PLAIN(options) (!options || (HUGE_PAGES_NONE == options->huge_pages && \
+                                        options->alignment <= _MALLOC_ALIGNMENT))
+
+static void* _hugeAlloc(const cds_size bytes){
+#if defined(MAP_HUGETLB) && defined(MAP_HUGE_2MB)
+    void* ptr = mmap(NULL, HUGE_ROUND(bytes), PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_HUGE_2MB, -1, 0);
+    if (MAP_FAILED != ptr){
+        return ptr;
+    }
+#endif // MAP_HUGETLB && MAP_HUGE_2MB
+    // no huge pages reserved: let the kernel back the mapping with THP.
+    return _mapAlloc(HUGE_ROUND(bytes), true);
+}
+
+void* _cdsAlloc(const cds_size bytes, const AllocOptions* const options){
+    if (IS_PLAIN(options)){
+        return malloc(bytes);
+    }
+    switch (options->huge_pages){
+        case HUGE_PAGES_TRANSPARENT:
+            return _mapAlloc(bytes, true);
+        case HUGE_PAGES_EXPLICIT:
+            return _hugeAlloc(bytes);
+        case HUGE_PAGES_NONE:
+            break;
+    }
+    void* ptr = NULL;
+    if (0 != posix_memalign(&ptr, options->alignment, bytes ? bytes : 1)){
+        return NULL;
+    }
+    return ptr;
+}
+
+void* _cdsCalloc(const cds_size bytes, const AllocOptions* const options){
+    if (IS_PLAIN(options)){
+        return calloc(1, bytes);
+    }
+    void* ptr = _cdsAlloc(bytes, options);
+    // mappings are already zeroed.
+    if (ptr && HUGE_PAGES_NONE == options->huge_pages){
+        (void) memset(ptr, 0, bytes);
+    }
+    return ptr;
+}
+
+void* _cdsRealloc(void* const ptr, const cds_size old_bytes, const cds_size new_bytes,
+                  const AllocOptions* const options){
+    if (IS_PLAIN(options)){
+        return realloc(ptr, new_bytes);
+    }
+    switch (options->huge_pages){
+        case HUGE_PAGES_TRANSPARENT:
+            return _mapRealloc(ptr, old_bytes, new_bytes);
+        case HUGE_PAGES_EXPLICIT:
+            if (HUGE_ROUND(old_bytes) == HUGE_ROUND(new_bytes)){
+                return ptr;
+            }
+            break;
+        case HUGE_PAGES_NONE:
+            break;
+    }
+    // aligned buffers cannot be realloc'ed without losing the alignment.
+    void* new_ptr = _cdsAlloc(new_bytes, options);
+    if (!new_ptr){
+        return NULL;
+    }
+    (void) memcpy(new_ptr, ptr, old_bytes < new_bytes ? old_bytes : new_bytes);
+    _cdsFree(ptr, old_bytes, options);
+    return new_ptr;
+}
+
+void _cdsFree(void* const ptr, const cds_size bytes, const AllocOptions* const options){
+    if (IS_PLAIN(options)){
+        free(ptr);
+        return;
+    }
+    switch (options->huge_pages){
+        case HUGE_PAGES_TRANSPARENT:
+            _mapFree(ptr, bytes);
+            break;
+        case HUGE_PAGES_EXPLICIT:
+            _mapFree(ptr, HUGE_ROUND(bytes));
+            break;
+        case HUGE_PAGES_NONE:
+            free(ptr);
+            break;
+    }
+}
@@ -0,0 +1,279 @@
+/*!
+ * @file mpmc_queue.c
+ * @copyright GNU General Public Licence 3 or Later (GPLv3).
+ * @author Paulo Arruda
+ * @brief Implementation of the bounded lock-free MPMC queue.
+*/
+
+#include <string.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "../include/mpmc_queue.h"
+#include "../include/_private_memory.h"
+#include "../include/_private_sync.h"
+
+/**
+ * Every slot holds its sequence number followed by the element. A slot at
+ * position `p` (counted from the creation of the queue) is free for the
+ * producer of `p` when its sequence is `p`, and full for the consumer of `p`
+ * when its sequence is `p + 1`; the consumer then sets it to `p + capacity`,
+ * freeing it for the next lap.
+*/
+#define SLOT_HEADER (((sizeof(atomic_size_t) + _Alignof(max_align_t) - 1) / _Alignof(max_align_t)) \
+                     * _Alignof(max_align_t))
+#define SLOT(queue, position) ((queue)->slots + ((position) & (queue)->mask)*(queue)->slot_size)
+#define SLOT_SEQUENCE(queue, position) ((atomic_size_t*) SLOT(queue, position))
+#define SLOT_DATA(queue, position) (SLOT(queue, position) + SLOT_HEADER)
+
+static const AllocOptions _mpmcq_options = {CDS_CACHE_LINE, HUGE_PAGES_NONE};
+
+/**
+ * The producer and consumer counters are written by every operation, hence
+ * each one has a cache line of its own, apart from the read-mostly fields.
+*/
+struct MPMCQueue{
+    _Alignas(CDS_CACHE_LINE) atomic_size_t enqueue_position;
+    _Alignas(CDS_CACHE_LINE) atomic_size_t dequeue_position;
+    _Alignas(CDS_CACHE_LINE) cds_size mask;
+    cds_size data_size;
+    cds_size slot_size;
+    cds_uchar* slots;
+    atomic_uint waiters;        // threads sleeping on `changed`
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+};
+
+MPMCQueue* mpmcqCreate(const cds_size capacity, const cds_size data_size){
+    if (!capacity || !data_size){
+        return (MPMCQueue*) NULL;
+    }
+    cds_size pow = capacity > 2 ? _log2(capacity - 1) + 1 : 1;
+    cds_size slot_size = SLOT_HEADER + ((data_size + _Alignof(max_align_t) - 1) / _Alignof(max_align_t))
+                                       * _Alignof(max_align_t);
+    if (pow >= _MAX_POW2_ || slot_size < data_size || (cds_size) -1 / slot_size < ((cds_size) 1 << pow)){
+        return (MPMCQueue*) NULL;
+    }
+    MPMCQueue* queue = (MPMCQueue*) _cdsAlloc(sizeof(MPMCQueue), &_mpmcq_options);
+    if (!queue){
+        return (MPMCQueue*) NULL;
+    }
+    queue->mask = ((cds_size) 1 << pow) - 1;
+    queue->data_size = data_size;
+    queue->slot_size = slot_size;
+    queue->slots = (cds_uchar*) _cdsAlloc((queue->mask + 1)*slot_size, &_mpmcq_options);
+    if (!queue->slots){
+        _cdsFree(queue, sizeof(MPMCQueue), &_mpmcq_options);
+        return (MPMCQueue*) NULL;
+    }
+    for (cds_size i=0; i<=queue->mask; i++){
+        atomic_init(SLOT_SEQUENCE(queue, i), i);
+    }
+    atomic_init(&queue->enqueue_position, 0);
+    atomic_init(&queue->dequeue_position, 0);
+    atomic_init(&queue->waiters, 0);
+    (void) pthread_mutex_init(&queue->lock, NULL);
+    (void) pthread_cond_init(&queue->changed, NULL);
+    return queue;
+}
+
+void mpmcqDelete(MPMCQueue* queue){
+    if (!queue){
+        return;
+    }
+    (void) pthread_cond_destroy(&queue->changed);
+    (void) pthread_mutex_destroy(&queue->lock);
+    _cdsFree(queue->slots, (queue->mask + 1)*queue->slot_size, &_mpmcq_options);
+    _cdsFree(queue, sizeof(MPMCQueue), &_mpmcq_options);
+}
+
+cds_size mpmcqCapacity(const MPMCQueue* const queue){
+    return queue ? queue->mask + 1 : 0;
+}
+
+cds_size mpmcqLength(const MPMCQueue* const queue){
+    if (!queue){
+        return 0;
+    }
+    // the consumers never pass the producers, so reading them first keeps the difference positive.
+    cds_size dequeued = atomic_load_explicit(&((MPMCQueue*) queue)->dequeue_position, memory_order_relaxed);
+    cds_size enqueued = atomic_load_explicit(&((MPMCQueue*) queue)->enqueue_position, memory_order_relaxed);
+    cds_size length = enqueued - dequeued;
+    return length > queue->mask + 1 ? queue->mask + 1 : length;
+}
+
+/**
+ * Claims up to `max` consecutive positions of `counter` whose slots are ready,
+ * that is, whose sequence is the position plus `lag` (0 for producers and 1
+ * for consumers), with one compare-and-swap. Returns the number of positions
+ * claimed, 0 when the first slot is not ready (the queue is full or empty).
+*/
+static cds_size _mpmcqClaim(MPMCQueue* const queue, atomic_size_t* const counter, const cds_size lag,
+                            const cds_size max, cds_size* const pfirst){
+    cds_size position = atomic_load_explicit(counter, memory_order_relaxed);
+    while (true){
+        cds_size ready = 0;
+        intptr_t diff = 0;
+        for (; ready < max && ready <= queue->mask; ready++){
+            cds_size sequence = atomic_load_explicit(SLOT_SEQUENCE(queue, position + ready), memory_order_acquire);
+            diff = (intptr_t) (sequence - (position + ready + lag));
+            if (diff){
+                break;
+            }
+        }
+        if (!ready){
+            if (diff < 0){
+                return 0;
+            }
+            // another thread claimed the position first.
+            position = atomic_load_explicit(counter, memory_order_relaxed);
+            continue;
+        }
+        if (atomic_compare_exchange_weak_explicit(counter, &position, position + ready,
+                                                  memory_order_relaxed, memory_order_relaxed)){
+            *pfirst = position;
+            return ready;
+        }
+        CDS_CPU_RELAX();
+    }
+}
+
+/**
+ * Wakes the sleeping threads, if any, after the queue changed. The fence pairs
+ * with the one of `_mpmcqSleep`: either the waker sees the new waiter, or the
+ * waiter sees the change and does not sleep.
+*/
+static void _mpmcqWake(MPMCQueue* const queue){
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&queue->waiters, memory_order_relaxed)){
+        (void) pthread_mutex_lock(&queue->lock);
+        (void) pthread_cond_broadcast(&queue->changed);
+        (void) pthread_mutex_unlock(&queue->lock);
+    }
+}
+
+static cds_size _mpmcqPushSome(MPMCQueue* const queue, const void* const data, const cds_size count){
+    cds_size first;
+    cds_size claimed = _mpmcqClaim(queue, &queue->enqueue_position, 0, count, &first);
+    for (cds_size i=0; i<claimed; i++){
+        memcpy(SLOT_DATA(queue, first + i), CDS_BYTE_OFFSET(data, (i*queue->data_size)), queue->data_size);
+        atomic_store_explicit(SLOT_SEQUENCE(queue, first + i), first + i + 1, memory_order_release);
+    }
+    if (claimed){
+        _mpmcqWake(queue);
+    }
+    return claimed;
+}
+
+static cds_size _mpmcqPopSome(MPMCQueue* const queue, void* const out, const cds_size max){
+    cds_size first;
+    cds_size claimed = _mpmcqClaim(queue, &queue->dequeue_position, 1, max, &first);
+    for (cds_size i=0; i<claimed; i++){
+        memcpy(CDS_BYTE_OFFSET(out, (i*queue->data_size)), SLOT_DATA(queue, first + i), queue->data_size);
+        atomic_store_explicit(SLOT_SEQUENCE(queue, first + i), first + i + queue->mask + 1,
+                              memory_order_release);
+    }
+    if (claimed){
+        _mpmcqWake(queue);
+    }
+    return claimed;
+}
+
+/**
+ * Whether the next producer (or consumer) would find its slot not ready.
+*/
+static cds_bool _mpmcqBlocked(MPMCQueue* const queue, const cds_bool push){
+    atomic_size_t* counter = push ? &queue->enqueue_position : &queue->dequeue_position;
+    cds_size position = atomic_load_explicit(counter, memory_order_relaxed);
+    cds_size sequence = atomic_load_explicit(SLOT_SEQUENCE(queue, position), memory_order_acquire);
+    return (intptr_t) (sequence - (position + !push)) < 0;
+}
+
+/**
+ * Waits after a failed attempt: spins and yields for the first attempts, then
+ * sleeps until another thread changes the queue.
+*/
+static void _mpmcqWait(MPMCQueue* const queue, const cds_bool push, cds_size* const round){
+    if (*round < CDS_SPIN_LIMIT + CDS_YIELD_LIMIT){
+        _cdsBackoff(round);
+        return;
+    }
+    (void) pthread_mutex_lock(&queue->lock);
+    (void) atomic_fetch_add(&queue->waiters, 1);
+    atomic_thread_fence(memory_order_seq_cst);
+    if (_mpmcqBlocked(queue, push)){
+        (void) pthread_cond_wait(&queue->changed, &queue->lock);
+    }
+    (void) atomic_fetch_sub(&queue->waiters, 1);
+    (void) pthread_mutex_unlock(&queue->lock);
+}
+
+cds_bool mpmcqTryPush(MPMCQueue* const queue, const void* const data){
+    return queue && data && _mpmcqPushSome(queue, data, 1);
+}
+
+cds_bool mpmcqTryPop(MPMCQueue* const queue, void* const out){
+    return queue && out && _mpmcqPopSome(queue, out, 1);
+}
+
+cds_bool mpmcqPush(MPMCQueue* const queue, const void* const data){
+    return 1 == mpmcqPushN(queue, data, 1);
+}
+
+cds_bool mpmcqPop(MPMCQueue* const queue, void* const out){
+    return 1 == mpmcqPopN(queue, out, 1);
+}
+
+cds_size mpmcqTryPushN(MPMCQueue* const queue, const void* const data, const cds_size count){
+    if (!queue || !data){
+        return 0;
+    }
+    cds_size pushed = 0;
+    for (cds_size claimed=1; claimed && pushed < count; pushed+=claimed){
+        claimed = _mpmcqPushSome(queue, CDS_BYTE_OFFSET(data, (pushed*queue->data_size)), count - pushed);
+    }
+    return pushed;
+}
+
+cds_size mpmcqTryPopN(MPMCQueue* const queue, void* const out, const cds_size max){
+    if (!queue || !out){
+        return 0;
+    }
+    cds_size popped = 0;
+    for (cds_size claimed=1; claimed && popped < max; popped+=claimed){
+        claimed = _mpmcqPopSome(queue, CDS_BYTE_OFFSET(out, (popped*queue->data_size)), max - popped);
+    }
+    return popped;
+}
+
+cds_size mpmcqPushN(MPMCQueue* const queue, const void* const data, const cds_size count){
+    if (!queue || !data){
+        return 0;
+    }
+    cds_size pushed = 0;
+    cds_size round = 0;
+    while (pushed < count){
+        cds_size claimed = _mpmcqPushSome(queue, CDS_BYTE_OFFSET(data, (pushed*queue->data_size)), count - pushed);
+        if (claimed){
+            pushed += claimed;
+            round = 0;
+        }
+        else{
+            _mpmcqWait(queue, true, &round);
+        }
+    }
+    return pushed;
+}
+
+cds_size mpmcqPopN(MPMCQueue* const queue, void* const out, const cds_size max){
+    if (!queue || !out || !max){
+        return 0;
+    }
+    cds_size round = 0;
+    cds_size popped;
+    while (!(popped = mpmcqTryPopN(queue, out, max))){
+        _mpmcqWait(queue, false, &round);
+    }
+    return popped;
+}
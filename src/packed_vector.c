@@ -0,0 +1,393 @@
+/*!
+ * @file packed_vector.c
+ * @copyright GNU General Public Licence 3 or Later (GPLv3).
+ * @author Paulo Arruda
+ * @brief Implementation of the packed vector API.
+*/
+
+#include "../include/packed_vector.h"
+#include "../include/_private_linear.h"
+#include "../include/_private_simd.h"
+
+/**
+ * Values are handled as unsigned 64 bits keys: signed integers are sign
+ * extended and their sign bit flipped, which keeps their order, so the least
+ * value of a block and the differences are computed the same way for every
+ * type.
+*/
+#define SIGN_BIT ((uint64_t) 1 << 63)
+
+/**
+ * Header of a block. `position` holds the offset of the bits of the block (in
+ * words) shifted by 8, the encoding in bit 7 and the width in the low 7 bits.
+*/
+typedef struct PackedBlock{
+    uint64_t reference;     // least value (frame of reference) or first value (delta)
+    uint64_t delta;         // least difference (delta)
+    uint64_t position;
+}PackedBlock;
+
+#define BLOCK_OFFSET(block) ((block)->position >> 8)
+#define BLOCK_IS_DELTA(block) (((block)->position >> 7) & 1)
+#define BLOCK_WIDTH(block) ((unsigned) ((block)->position & 0x7f))
+
+/**
+ * Definition of the packed vector structure. `words` has a trailing word of
+ * padding, so unpacking may always read the word after the one of a value.
+*/
+struct PackedVector{
+    cds_size length;
+    enum NumericType type;
+    cds_size num_blocks;
+    cds_size num_words;
+    PackedBlock* blocks;
+    uint64_t* words;
+};
+
+/**
+ * X-macro listing the integer types: enumeration, C type and whether it is
+ * signed.
+*/
+#define INTEGER_TYPES(X)            \
+    X(NUM_INT8,   int8_t,   true)   \
+    X(NUM_UINT8,  uint8_t,  false)  \
+    X(NUM_INT16,  int16_t,  true)   \
+    X(NUM_UINT16, uint16_t, false)  \
+    X(NUM_INT32,  int32_t,  true)   \
+    X(NUM_UINT32, uint32_t, false)  \
+    X(NUM_INT64,  int64_t,  true)   \
+    X(NUM_UINT64, uint64_t, false)
+
+static cds_bool _isInteger(const enum NumericType type){
+    return NUM_FLOAT != type && NUM_DOUBLE != type;
+}
+
+/**
+ * Converts `n` values of `type` into keys.
+*/
+static void _loadKeys(const void* const arr, const cds_size n, const enum NumericType type,
+                      uint64_t* const keys){
+    switch (type){
+        #define LOAD_CASE(num_type, ctype, is_signed)                                       \
+        case num_type:                                                                      \
+            for (cds_size i=0; i<n; i++){                                                   \
+                ctype x = ((const ctype*) arr)[i];                                          \
+                keys[i] = is_signed ? (uint64_t) (int64_t) x ^ SIGN_BIT : (uint64_t) x;     \
+            }                                                                               \
+            break;
+        INTEGER_TYPES(LOAD_CASE)
+        #undef LOAD_CASE
+        case NUM_FLOAT:
+        case NUM_DOUBLE:
+            break;
+    }
+}
+
+/**
+ * Converts `n` keys back into values of `type`.
+*/
+static void _storeValues(const uint64_t* const keys, const cds_size n, const enum NumericType type,
+                         void* const out){
+    switch (type){
+        #define STORE_CASE(num_type, ctype, is_signed)                                      \
+        case num_type:                                                                      \
+            for (cds_size i=0; i<n; i++){                                                   \
+                ((ctype*) out)[i] = is_signed ? (ctype) (int64_t) (keys[i] ^ SIGN_BIT)      \
+                                              : (ctype) keys[i];                            \
+            }                                                                               \
+            break;
+        INTEGER_TYPES(STORE_CASE)
+        #undef STORE_CASE
+        case NUM_FLOAT:
+        case NUM_DOUBLE:
+            break;
+    }
+}
+
+static inline unsigned _width(const uint64_t x){
+    return x ? (unsigned) (64 - CDS_CLZ64(x)) : 0;
+}
+
+static inline cds_size _blockLength(const PackedVector* const pv, const cds_size block){
+    cds_size first = block*PACKED_BLOCK_SIZE;
+    return pv->length - first < PACKED_BLOCK_SIZE ? pv->length - first : PACKED_BLOCK_SIZE;
+}
+
+/**
+ * BIT PACKING
+ * -----------
+ * Value `j` of a block of width `bits` takes the bits [j*bits, (j + 1)*bits) of
+ * the words of the block, possibly straddling two words.
+*/
+
+static inline void _put(uint64_t* const words, const cds_size pos, const unsigned bits,
+                        const uint64_t value){
+    cds_size w = pos >> 6;
+    unsigned s = pos & 63;
+    words[w] |= value << s;
+    if (s + bits > 64){
+        words[w + 1] |= value >> (64 - s);
+    }
+}
+
+static inline uint64_t _extract(const uint64_t* const words, const cds_size pos, const unsigned bits){
+    cds_size w = pos >> 6;
+    unsigned s = pos & 63;
+    uint64_t value = words[w] >> s;
+    if (s + bits > 64){
+        value |= words[w + 1] << (64 - s);
+    }
+    return bits == 64 ? value : value & (((uint64_t) 1 << bits) - 1);
+}
+
+static void _unpackScalar(const uint64_t* const words, const unsigned bits, const cds_size n,
+                          uint64_t* const out){
+    for (cds_size j=0; j<n; j++){
+        out[j] = _extract(words, j*bits, bits);
+    }
+}
+
+#ifdef __CDS_X86_SIMD__
+/**
+ * Unpacks four values per iteration: their words are gathered, shifted by
+ * per-lane amounts and masked.
+*/
+CDS_TARGET_AVX2 static void _unpackAvx2(const uint64_t* const words, const unsigned bits,
+                                        const cds_size n, uint64_t* const out){
+    const __m256i mask = _mm256_set1_epi64x(bits == 64 ? -1LL : (long long) (((uint64_t) 1 << bits) - 1));
+    const __m256i width = _mm256_set1_epi64x(bits);
+    const __m256i low_bits = _mm256_set1_epi64x(63);
+    const __m256i one = _mm256_set1_epi64x(1);
+    const __m256i sixty_four = _mm256_set1_epi64x(64);
+    __m256i index = _mm256_set_epi64x(3, 2, 1, 0);
+    cds_size j = 0;
+    for (; j + 4 <= n; j+=4){
+        __m256i pos = _mm256_mul_epu32(index, width);
+        __m256i w = _mm256_srli_epi64(pos, 6);
+        __m256i s = _mm256_and_si256(pos, low_bits);
+        __m256i lo = _mm256_i64gather_epi64((const long long*) words, w, 8);
+        __m256i hi = _mm256_i64gather_epi64((const long long*) words, _mm256_add_epi64(w, one), 8);
+        // shifts by 64 (values starting a word) yield 0.
+        __m256i value = _mm256_or_si256(_mm256_srlv_epi64(lo, s),
+                                        _mm256_sllv_epi64(hi, _mm256_sub_epi64(sixty_four, s)));
+        _mm256_storeu_si256((__m256i*) (out + j), _mm256_and_si256(value, mask));
+        index = _mm256_add_epi64(index, _mm256_set1_epi64x(4));
+    }
+    for (; j<n; j++){
+        out[j] = _extract(words, j*bits, bits);
+    }
+}
+#define UNPACK_DISPATCH(words, bits, n, out) \
+    (CDS_HAS_AVX2() ? _unpackAvx2(words, bits, n, out) : _unpackScalar(words, bits, n, out))
+#else
+#define UNPACK_DISPATCH(words, bits, n, out) _unpackScalar(words, bits, n, out)
+#endif // __CDS_X86_SIMD__
+
+/**
+ * Decodes the keys of a block.
+*/
+static void _decodeBlock(const PackedVector* const pv, const cds_size block, uint64_t* const keys){
+    const PackedBlock* header = pv->blocks + block;
+    const cds_size n = _blockLength(pv, block);
+    const unsigned bits = BLOCK_WIDTH(header);
+    if (bits){
+        UNPACK_DISPATCH(pv->words + BLOCK_OFFSET(header), bits, n, keys);
+    }else{
+        (void) memset(keys, 0, n*sizeof(uint64_t));
+    }
+    if (!BLOCK_IS_DELTA(header)){
+        for (cds_size j=0; j<n; j++){
+            keys[j] += header->reference;
+        }
+        return;
+    }
+    uint64_t value = header->reference;
+    for (cds_size j=0; j<n; j++){
+        uint64_t packed = keys[j];
+        keys[j] = value;
+        value += packed + header->delta;
+    }
+}
+
+/**
+ * ENCODING
+ * --------
+ * The headers are computed first, which gives the number of words; the values
+ * are then packed into the zeroed words.
+*/
+
+/**
+ * Computes the header of a block of `n` keys (but its offset).
+*/
+static PackedBlock _blockHeader(const uint64_t* const keys, const cds_size n,
+                                const enum PackedEncoding encoding){
+    uint64_t min = keys[0], max = keys[0];
+    for (cds_size j=1; j<n; j++){
+        min = keys[j] < min ? keys[j] : min;
+        max = keys[j] > max ? keys[j] : max;
+    }
+    unsigned for_bits = _width(max - min);
+    int64_t min_delta = 0, max_delta = 0;
+    for (cds_size j=0; j + 1<n; j++){
+        int64_t delta = (int64_t) (keys[j + 1] - keys[j]);
+        min_delta = !j || delta < min_delta ? delta : min_delta;
+        max_delta = !j || delta > max_delta ? delta : max_delta;
+    }
+    unsigned delta_bits = _width((uint64_t) max_delta - (uint64_t) min_delta);
+    cds_bool use_delta = PACKED_DELTA == encoding || (PACKED_AUTO == encoding && delta_bits < for_bits);
+    if (use_delta){
+        return (PackedBlock){keys[0], (uint64_t) min_delta, 1 << 7 | delta_bits};
+    }
+    return (PackedBlock){min, 0, for_bits};
+}
+
+static void _packBlock(uint64_t* const words, const PackedBlock* const header,
+                       const uint64_t* const keys, const cds_size n){
+    const unsigned bits = BLOCK_WIDTH(header);
+    if (!bits){
+        return;
+    }
+    if (BLOCK_IS_DELTA(header)){
+        for (cds_size j=0; j + 1<n; j++){
+            _put(words, j*bits, bits, keys[j + 1] - keys[j] - header->delta);
+        }
+        return;
+    }
+    for (cds_size j=0; j<n; j++){
+        _put(words, j*bits, bits, keys[j] - header->reference);
+    }
+}
+
+PackedVector* packvecFromArray(const void* const arr, const cds_size length,
+                               const enum NumericType type, const enum PackedEncoding encoding){
+    if ((!arr && length) || !_isInteger(type)){
+        return (PackedVector*) NULL;
+    }
+    PackedVector* pv = (PackedVector*) malloc(sizeof(PackedVector));
+    if (!pv){
+        return (PackedVector*) NULL;
+    }
+    pv->length = length;
+    pv->type = type;
+    pv->num_blocks = (length + PACKED_BLOCK_SIZE - 1) / PACKED_BLOCK_SIZE;
+    pv->blocks = (PackedBlock*) malloc((pv->num_blocks ? pv->num_blocks : 1)*sizeof(PackedBlock));
+    if (!pv->blocks){
+        free(pv);
+        return (PackedVector*) NULL;
+    }
+    const cds_size data_size = _numericSize(type);
+    uint64_t keys[PACKED_BLOCK_SIZE];
+    cds_size num_words = 0;
+    for (cds_size b=0; b<pv->num_blocks; b++){
+        cds_size n = _blockLength(pv, b);
+        _loadKeys(CDS_BYTE_OFFSET(arr, b*PACKED_BLOCK_SIZE*data_size), n, type, keys);
+        pv->blocks[b] = _blockHeader(keys, n, encoding);
+        pv->blocks[b].position |= (uint64_t) num_words << 8;
+        num_words += (n*BLOCK_WIDTH(pv->blocks + b) + 63) / 64;
+    }
+    pv->num_words = num_words + 1;
+    pv->words = (uint64_t*) calloc(pv->num_words, sizeof(uint64_t));
+    if (!pv->words){
+        free(pv->blocks);
+        free(pv);
+        return (PackedVector*) NULL;
+    }
+    for (cds_size b=0; b<pv->num_blocks; b++){
+        cds_size n = _blockLength(pv, b);
+        _loadKeys(CDS_BYTE_OFFSET(arr, b*PACKED_BLOCK_SIZE*data_size), n, type, keys);
+        _packBlock(pv->words + BLOCK_OFFSET(pv->blocks + b), pv->blocks + b, keys, n);
+    }
+    return pv;
+}
+
+PackedVector* packvecFromVector(const Vector* const vec, const enum NumericType type,
+                                const enum PackedEncoding encoding){
+    if (!vec || _numericSize(type) != vec->data_size){
+        return (PackedVector*) NULL;
+    }
+    return packvecFromArray(vec->container, vec->length, type, encoding);
+}
+
+void packvecDelete(PackedVector* pv){
+    if (!pv){
+        return;
+    }
+    free(pv->words);
+    free(pv->blocks);
+    free(pv);
+}
+
+cds_size packvecLength(const PackedVector* const pv){
+    return pv ? pv->length : 0;
+}
+
+cds_size packvecDataSize(const PackedVector* const pv){
+    return pv ? _numericSize(pv->type) : 0;
+}
+
+cds_size packvecMemoryUsage(const PackedVector* const pv){
+    if (!pv){
+        return 0;
+    }
+    return sizeof(PackedVector) + pv->num_blocks*sizeof(PackedBlock) + pv->num_words*sizeof(uint64_t);
+}
+
+/**
+ * DECODING
+ * --------
+*/
+
+cds_bool packvecGet(const PackedVector* const pv, const cds_size index, void* const out){
+    if (!pv || !out || index >= pv->length){
+        return false;
+    }
+    const PackedBlock* header = pv->blocks + index / PACKED_BLOCK_SIZE;
+    const uint64_t* words = pv->words + BLOCK_OFFSET(header);
+    const unsigned bits = BLOCK_WIDTH(header);
+    const cds_size j = index % PACKED_BLOCK_SIZE;
+    uint64_t key = header->reference;
+    if (BLOCK_IS_DELTA(header)){
+        key += j*header->delta;
+        for (cds_size k=0; k<j; k++){
+            key += _extract(words, k*bits, bits);
+        }
+    }else{
+        key += _extract(words, j*bits, bits);
+    }
+    _storeValues(&key, 1, pv->type, out);
+    return true;
+}
+
+cds_size packvecDecode(const PackedVector* const pv, const cds_size start, const cds_size count,
+                       void* const out){
+    if (!pv || !out || start >= pv->length){
+        return 0;
+    }
+    const cds_size total = count < pv->length - start ? count : pv->length - start;
+    const cds_size data_size = _numericSize(pv->type);
+    uint64_t keys[PACKED_BLOCK_SIZE];
+    cds_size done = 0;
+    while (done < total){
+        cds_size index = start + done;
+        cds_size block = index / PACKED_BLOCK_SIZE;
+        cds_size j = index % PACKED_BLOCK_SIZE;
+        cds_size n = _blockLength(pv, block) - j;
+        n = n < total - done ? n : total - done;
+        _decodeBlock(pv, block, keys);
+        _storeValues(keys + j, n, pv->type, CDS_BYTE_OFFSET(out, done*data_size));
+        done += n;
+    }
+    return total;
+}
+
+Vector* packvecToVector(const PackedVector* const pv){
+    if (!pv){
+        return (Vector*) NULL;
+    }
+    Vector* vec = vectorCreate(pv->length ? pv->length : 1, _numericSize(pv->type));
+    if (!vec){
+        return (Vector*) NULL;
+    }
+    vec->length = packvecDecode(pv, 0, pv->length, vec->container);
+    return vec;
+}
@@ -0,0 +1,190 @@
+/*!
+ * @file parallel.c
+ * @copyright GNU General Public Licence 3 or Later (GPLv3).
+ * @author Paulo Arruda
+ * @brief Implementation of the data-parallel operations over vectors.
+*/
+
+#include <string.h>
+#include <stdint.h>
+#include "../include/parallel.h"
+#include "../include/_private_linear.h"
+#include "../include/_private_memory.h"
+
+/**
+ * CHUNKS
+ * ------
+ * Chunks are about a multiple of `CDS_CACHE_LINE / gcd(data_size,
+ * CDS_CACHE_LINE)` elements long, and every chunk but the first starts at the
+ * first element beginning at or after a cache line boundary of the written
+ * buffer, in absolute addresses. Threads then share no cache line when the
+ * buffer is aligned to the elements, and at most one per chunk boundary
+ * otherwise.
+*/
+
+static cds_size _lineUnit(const cds_size data_size){
+    cds_size a = data_size;
+    cds_size b = CDS_CACHE_LINE;
+    while (b){
+        cds_size r = a % b;
+        a = b;
+        b = r;
+    }
+    return CDS_CACHE_LINE / a;
+}
+
+/**
+ * Number of elements per chunk, for elements of `data_size` bytes written to
+ * elements of `out_size` bytes (0 if nothing is written).
+*/
+static cds_size _chunkLength(const cds_size length, const cds_size data_size,
+                             const cds_size out_size, const ThreadPool* const pool){
+    cds_size unit = _lineUnit(data_size);
+    if (out_size && _lineUnit(out_size) > unit){
+        unit = _lineUnit(out_size);
+    }
+    const cds_size tasks = tpoolNumThreads(pool) * PARALLEL_CHUNKS_PER_THREAD;
+    cds_size chunk = (length + tasks - 1) / tasks;
+    const cds_size grain = (PARALLEL_GRAIN + data_size - 1) / data_size;
+    if (chunk < grain){
+        chunk = grain;
+    }
+    return (chunk + unit - 1) / unit * unit;
+}
+
+typedef struct ParallelJob{
+    const void* src;
+    void* dst;
+    cds_size data_size;
+    cds_size out_size;
+    uintptr_t line_base;        // the buffer whose cache lines the chunks follow
+    cds_size line_size;         // and the size of its elements
+    cds_size length;
+    cds_size chunk;
+    void* arg;
+    ForEachFun for_each;
+    MapFun map;
+    FoldFun fold;
+    void* partials;             // reduction accumulators, one per chunk
+    cds_size partial_stride;
+}ParallelJob;
+
+/**
+ * Index of the first element of the chunk `task`, which is the end of the
+ * previous one.
+*/
+static cds_size _chunkBegin(const ParallelJob* const job, const cds_size task){
+    if (!task){
+        return 0;
+    }
+    if (task*job->chunk >= job->length){
+        return job->length;
+    }
+    const uintptr_t start = job->line_base + task*job->chunk*job->line_size;
+    const uintptr_t line = start & ~((uintptr_t) CDS_CACHE_LINE - 1);
+    if (line <= job->line_base){
+        return 0;
+    }
+    return (line - job->line_base + job->line_size - 1) / job->line_size;
+}
+
+#define CHUNK_BOUNDS(job, task, begin, end) \
+    const cds_size begin = _chunkBegin(job, task); \
+    const cds_size end = _chunkBegin(job, (task) + 1)
+
+static void _forEachTask(void* arg, const cds_size task){
+    const ParallelJob* job = (const ParallelJob*) arg;
+    CHUNK_BOUNDS(job, task, begin, end);
+    for (cds_size i=begin; i<end; i++){
+        job->for_each(CDS_BYTE_OFFSET(job->dst, i*job->data_size), i, job->arg);
+    }
+}
+
+static void _mapTask(void* arg, const cds_size task){
+    const ParallelJob* job = (const ParallelJob*) arg;
+    CHUNK_BOUNDS(job, task, begin, end);
+    for (cds_size i=begin; i<end; i++){
+        job->map(CDS_BYTE_OFFSET(job->src, i*job->data_size),
+                 CDS_BYTE_OFFSET(job->dst, i*job->out_size), job->arg);
+    }
+}
+
+static void _reduceTask(void* arg, const cds_size task){
+    const ParallelJob* job = (const ParallelJob*) arg;
+    CHUNK_BOUNDS(job, task, begin, end);
+    void* acc = CDS_BYTE_OFFSET(job->partials, task*job->partial_stride);
+    for (cds_size i=begin; i<end; i++){
+        job->fold(acc, CDS_BYTE_OFFSET(job->src, i*job->data_size), job->arg);
+    }
+}
+
+#define NUM_CHUNKS(job) (((job).length + (job).chunk - 1) / (job).chunk)
+
+cds_bool vectorParallelForEach(Vector* const vec, const ForEachFun fun, void* arg,
+                               ThreadPool* const pool){
+    if (!VECTOR_WRITABLE(vec) || !fun || !vec->data_size){
+        return false;
+    }
+    ThreadPool* _pool = pool ? pool : tpoolDefault();
+    ParallelJob job = {
+        .dst = vec->container, .data_size = vec->data_size, .length = vec->length,
+        .line_base = (uintptr_t) vec->container, .line_size = vec->data_size,
+        .chunk = _chunkLength(vec->length, vec->data_size, 0, _pool), .arg = arg, .for_each = fun,
+    };
+    tpoolRun(_pool, _forEachTask, &job, NUM_CHUNKS(job));
+    return true;
+}
+
+cds_bool vectorParallelMap(const Vector* const src, Vector* const dst, const MapFun fun, void* arg,
+                           ThreadPool* const pool){
+    if (!src || !dst || !fun || !src->data_size || !dst->data_size
+        || !vectorReserve(dst, src->length)){
+        return false;
+    }
+    ThreadPool* _pool = pool ? pool : tpoolDefault();
+    ParallelJob job = {
+        .src = src->container, .dst = dst->container, .data_size = src->data_size,
+        .out_size = dst->data_size, .length = src->length,
+        .line_base = (uintptr_t) dst->container, .line_size = dst->data_size,
+        .chunk = _chunkLength(src->length, src->data_size, dst->data_size, _pool),
+        .arg = arg, .map = fun,
+    };
+    tpoolRun(_pool, _mapTask, &job, NUM_CHUNKS(job));
+    dst->length = src->length;
+    return true;
+}
+
+cds_bool vectorParallelReduce(const Vector* const vec, void* const acc, const cds_size acc_size,
+                              const FoldFun fold, const CombineFun combine, void* arg,
+                              ThreadPool* const pool){
+    if (!vec || !acc || !acc_size || !fold || !combine || !vec->data_size){
+        return false;
+    }
+    ThreadPool* _pool = pool ? pool : tpoolDefault();
+    ParallelJob job = {
+        .src = vec->container, .data_size = vec->data_size, .length = vec->length,
+        .line_base = (uintptr_t) vec->container, .line_size = vec->data_size,
+        .chunk = _chunkLength(vec->length, vec->data_size, 0, _pool), .arg = arg, .fold = fold,
+        // every accumulator has cache lines of its own.
+        .partial_stride = (acc_size + CDS_CACHE_LINE - 1) / CDS_CACHE_LINE * CDS_CACHE_LINE,
+    };
+    const cds_size num_chunks = NUM_CHUNKS(job);
+    if (!num_chunks){
+        return true;
+    }
+    const AllocOptions options = {CDS_CACHE_LINE, HUGE_PAGES_NONE};
+    job.partials = _cdsAlloc(num_chunks * job.partial_stride, &options);
+    if (!job.partials){
+        return false;
+    }
+    for (cds_size i=0; i<num_chunks; i++){
+        (void) memcpy(CDS_BYTE_OFFSET(job.partials, i*job.partial_stride), acc, acc_size);
+    }
+    tpoolRun(_pool, _reduceTask, &job, num_chunks);
+    (void) memcpy(acc, job.partials, acc_size);
+    for (cds_size i=1; i<num_chunks; i++){
+        combine(acc, CDS_BYTE_OFFSET(job.partials, i*job.partial_stride), arg);
+    }
+    _cdsFree(job.partials, num_chunks * job.partial_stride, &options);
+    return true;
+}
@@ -0,0 +1,106 @@
+/*!
+ * @file pool.c
+ * @copyright GNU General Public Licence 3 or Later (GPLv3).
+ * @author Paulo Arruda
+ * @brief Implementation of the pool allocator.
+*/
+
+#include <stddef.h>
+#include "../include/pool.h"
+
+#define POOL_ALIGNMENT _Alignof(max_align_t)
+#define POOL_ROUND(bytes) (((bytes) + POOL_ALIGNMENT - 1) & ~(POOL_ALIGNMENT - 1))
+
+/**
+ * Slabs are chained from the newest to the oldest. The header is padded so
+ * that the objects following it are aligned for any type.
+*/
+typedef struct PoolSlab{
+    struct PoolSlab* previous;
+    _Alignas(max_align_t) cds_uchar data[];
+}PoolSlab;
+
+/**
+ * Free objects are linked through their first pointer.
+*/
+typedef struct FreeObject{
+    struct FreeObject* next;
+}FreeObject;
+
+struct Pool{
+    cds_size object_size;
+    cds_size objects_per_slab;
+    cds_size used;              // objects carved from the current slab
+    PoolSlab* current;
+    FreeObject* free_list;
+};
+
+Pool* poolCreate(const cds_size object_size, const cds_size objects_per_slab){
+    if (!object_size || !objects_per_slab){
+        return (Pool*) NULL;
+    }
+    cds_size size = POOL_ROUND(object_size > sizeof(FreeObject) ? object_size : sizeof(FreeObject));
+    if (size < object_size || (cds_size) -1 / size < objects_per_slab){
+        return (Pool*) NULL;
+    }
+    Pool* new_pool = (Pool*) malloc(sizeof(Pool));
+    if (!new_pool){
+        return (Pool*) NULL;
+    }
+    new_pool->object_size = size;
+    new_pool->objects_per_slab = objects_per_slab;
+    // the first slab is allocated by the first allocation.
+    new_pool->used = objects_per_slab;
+    new_pool->current = (PoolSlab*) NULL;
+    new_pool->free_list = (FreeObject*) NULL;
+    return new_pool;
+}
+
+void poolDelete(Pool* pool){
+    if (!pool){
+        return;
+    }
+    while (pool->current){
+        PoolSlab* previous = pool->current->previous;
+        free(pool->current);
+        pool->current = previous;
+    }
+    free(pool);
+}
+
+void* poolAlloc(Pool* const pool){
+    if (!pool){
+        return NULL;
+    }
+    if (pool->free_list){
+        FreeObject* object = pool->free_list;
+        pool->free_list = object->next;
+        return object;
+    }
+    if (pool->used == pool->objects_per_slab){
+        PoolSlab* slab = (PoolSlab*) malloc(sizeof(PoolSlab) + pool->objects_per_slab*pool->object_size);
+        if (!slab){
+            return NULL;
+        }
+        slab->previous = pool->current;
+        pool->current = slab;
+        pool->used = 0;
+    }
+    return pool->current->data + (pool->used++)*pool->object_size;
+}
+
+void poolFree(Pool* const pool, void* const object){
+    poolFreeChain(pool, object, object);
+}
+
+void poolFreeChain(Pool* const pool, void* const first, void* const last){
+    if (!pool || !first || !last){
+        return;
+    }
+    ((FreeObject*) last)->next = pool->free_list;
+    pool->free_list = (FreeObject*) first;
+}
+
+cds_size poolObjectSize(const Pool* const pool){
+    return pool ? pool->object_size : 0;
+}
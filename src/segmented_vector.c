@@ -0,0 +1,167 @@
+/*!
+ * @file segmented_vector.c
+ * @copyright GNU General Public Licence 3 or Later (GPLv3).
+ * @author Paulo Arruda
+ * @brief Implementation of the segmented vector API.
+*/
+
+#include "../include/segmented_vector.h"
+#include "../include/thread_pool.h"
+
+#define LENGTH(container) ((container) ? (container)->length : 0)
+
+/**
+ * Definition of the segmented vector structure. Since the chunk capacity is a
+ * power of 2, the chunk and the offset of an index are a shift and a mask.
+*/
+struct SegVector{
+    cds_size length;
+    cds_size data_size;
+    cds_size chunk_shift;
+    cds_size num_chunks;        // allocated chunks
+    cds_size index_capacity;    // capacity of the chunk index
+    void** chunks;
+};
+
+SegVector* segvecCreate(const cds_size chunk_capacity, const cds_size data_size){
+    if (!chunk_capacity || !data_size){
+        return (SegVector*) NULL;
+    }
+    cds_size shift = chunk_capacity > 1 ? _log2(chunk_capacity - 1) + 1 : 0;
+    // the bytes of a chunk must fit in a `cds_size`.
+    if (shift >= _MAX_POW2_ || data_size > ((cds_size) -1 >> shift)){
+        return (SegVector*) NULL;
+    }
+    SegVector* new_sv = (SegVector*) malloc(sizeof(SegVector));
+    if (!new_sv){
+        return (SegVector*) NULL;
+    }
+    new_sv->length = 0;
+    new_sv->data_size = data_size;
+    new_sv->chunk_shift = shift;
+    new_sv->num_chunks = 0;
+    new_sv->index_capacity = 0;
+    new_sv->chunks = (void**) NULL;
+    return new_sv;
+}
+
+void segvecDelete(SegVector* sv){
+    if (!sv){
+        return;
+    }
+    for (cds_size i=0; i<sv->num_chunks; i++){
+        free(sv->chunks[i]);
+    }
+    free(sv->chunks);
+    free(sv);
+}
+
+/**
+ * Allocates a new chunk. Only the index of chunks (one pointer per chunk) is
+ * reallocated, never the chunks themselves.
+*/
+static cds_bool _segvecAddChunk(SegVector* sv){
+    if (sv->num_chunks == sv->index_capacity){
+        cds_size new_capacity = sv->index_capacity ? sv->index_capacity << 1 : 8;
+        void** new_index = (void**) realloc(sv->chunks, new_capacity*sizeof(void*));
+        if (!new_index){
+            return false;
+        }
+        sv->chunks = new_index;
+        sv->index_capacity = new_capacity;
+    }
+    void* chunk = malloc(sv->data_size << sv->chunk_shift);
+    if (!chunk){
+        return false;
+    }
+    sv->chunks[sv->num_chunks++] = chunk;
+    return true;
+}
+
+static inline void* _segvecAt(const SegVector* const sv, const cds_size index){
+    cds_size offset = index & (((cds_size) 1 << sv->chunk_shift) - 1);
+    return CDS_BYTE_OFFSET(sv->chunks[index >> sv->chunk_shift], offset*sv->data_size);
+}
+
+cds_bool segvecAppend(SegVector* const sv, const void* const data){
+    if (!sv || !data){
+        return false;
+    }
+    if (sv->length >> sv->chunk_shift == sv->num_chunks && !_segvecAddChunk(sv)){
+        return false;
+    }
+    (void) memcpy(_segvecAt(sv, sv->length), data, sv->data_size);
+    sv->length++;
+    return true;
+}
+
+cds_bool segvecPopBack(SegVector* const sv){
+    if (!sv || !sv->length){
+        return false;
+    }
+    sv->length--;
+    return true;
+}
+
+void* segvecGetAt(const SegVector* const sv, const cds_size index){
+    if (!sv || index >= sv->length){
+        return NULL;
+    }
+    return _segvecAt(sv, index);
+}
+
+cds_size segvecLength(const SegVector* const sv){
+    return LENGTH(sv);
+}
+
+cds_size segvecChunkCapacity(const SegVector* const sv){
+    return sv ? (cds_size) 1 << sv->chunk_shift : 0;
+}
+
+cds_size segvecNumChunks(const SegVector* const sv){
+    if (!sv){
+        return 0;
+    }
+    cds_size capacity = (cds_size) 1 << sv->chunk_shift;
+    return (sv->length + capacity - 1) >> sv->chunk_shift;
+}
+
+void* segvecChunk(const SegVector* const sv, const cds_size chunk, cds_size* const plength){
+    if (chunk >= segvecNumChunks(sv)){
+        return NULL;
+    }
+    if (plength){
+        cds_size first = chunk << sv->chunk_shift;
+        cds_size capacity = (cds_size) 1 << sv->chunk_shift;
+        *plength = sv->length - first < capacity ? sv->length - first : capacity;
+    }
+    return sv->chunks[chunk];
+}
+
+/**
+ * PARALLEL ITERATION
+ * ------------------
+ * Every chunk is a task of the default thread pool, whose threads take the
+ * next unprocessed chunk from a shared counter.
+*/
+
+typedef struct ChunkJob{
+    const SegVector* sv;
+    SegVectorChunkFun fun;
+    void* arg;
+}ChunkJob;
+
+static void _chunkTask(void* arg, const cds_size chunk){
+    const ChunkJob* job = (const ChunkJob*) arg;
+    cds_size length = 0;
+    void* data = segvecChunk(job->sv, chunk, &length);
+    job->fun(data, length, chunk << job->sv->chunk_shift, job->arg);
+}
+
+void segvecParallelForEachChunk(const SegVector* const sv, const SegVectorChunkFun fun, void* arg){
+    if (!sv || !fun){
+        return;
+    }
+    ChunkJob job = {.sv = sv, .fun = fun, .arg = arg};
+    tpoolRun(tpoolDefault(), _chunkTask, &job, segvecNumChunks(sv));
+}
@@ -0,0 +1,596 @@
+/*!
+ * @file serialize.c
+ * @copyright GNU General Public Licence 3 or Later (GPLv3).
+ * @author Paulo Arruda
+ * @brief Implementation of the serialization API.
+*/
+
+#include <errno.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include "../include/serialize.h"
+#include "../include/_private_linear.h"
+#include "../include/_private_hash.h"
+
+/**
+ * STREAMS
+ * -------
+ * File descriptor streams own a buffer of `STREAM_CHUNK_SIZE` bytes: pending
+ * writes are kept in [0, tail) and unread bytes in [head, tail). Buffer streams
+ * use the user buffer and `head` as their cursor.
+*/
+
+struct Stream{
+    cds_int fd;             // -1 for buffer streams
+    cds_uchar* buffer;
+    cds_size capacity;
+    cds_size head;
+    cds_size tail;
+    cds_size position;
+    cds_bool writing;       // whether the buffered bytes are pending writes
+};
+
+Stream* streamFromFd(const cds_int fd){
+    if (fd < 0){
+        return (Stream*) NULL;
+    }
+    Stream* new_stream = (Stream*) malloc(sizeof(Stream) + STREAM_CHUNK_SIZE);
+    if (!new_stream){
+        return (Stream*) NULL;
+    }
+    new_stream->fd = fd;
+    new_stream->buffer = (cds_uchar*) (new_stream + 1);
+    new_stream->capacity = STREAM_CHUNK_SIZE;
+    new_stream->head = 0;
+    new_stream->tail = 0;
+    new_stream->position = 0;
+    new_stream->writing = false;
+    return new_stream;
+}
+
+Stream* streamFromBuffer(void* const buffer, const cds_size size){
+    if (!buffer){
+        return (Stream*) NULL;
+    }
+    Stream* new_stream = (Stream*) malloc(sizeof(Stream));
+    if (!new_stream){
+        return (Stream*) NULL;
+    }
+    new_stream->fd = -1;
+    new_stream->buffer = (cds_uchar*) buffer;
+    new_stream->capacity = size;
+    new_stream->head = 0;
+    new_stream->tail = size;
+    new_stream->position = 0;
+    new_stream->writing = false;
+    return new_stream;
+}
+
+cds_bool streamDelete(Stream* stream){
+    if (!stream){
+        return true;
+    }
+    cds_bool flushed = streamFlush(stream);
+    free(stream);
+    return flushed;
+}
+
+/**
+ * Writes all the bytes to the file descriptor, retrying partial writes.
+*/
+static cds_bool _writeAll(const cds_int fd, const void* data, cds_size size){
+    const cds_uchar* bytes = (const cds_uchar*) data;
+    while (size){
+        ssize_t written = write(fd, bytes, size);
+        if (written < 0){
+            if (EINTR == errno){
+                continue;
+            }
+            return false;
+        }
+        bytes += written;
+        size -= (cds_size) written;
+    }
+    return true;
+}
+
+/**
+ * Reads from the file descriptor once, returning 0 at its end or on errors.
+*/
+static cds_size _readOnce(const cds_int fd, void* const data, const cds_size size){
+    ssize_t count;
+    do{
+        count = read(fd, data, size);
+    }while (count < 0 && EINTR == errno);
+    return count > 0 ? (cds_size) count : 0;
+}
+
+cds_bool streamFlush(Stream* const stream){
+    if (!stream || stream->fd < 0 || !stream->writing){
+        // buffer streams and readers have nothing to flush.
+        return true;
+    }
+    cds_bool result = _writeAll(stream->fd, stream->buffer, stream->tail);
+    stream->tail = 0;
+    return result;
+}
+
+cds_bool streamWrite(Stream* const stream, const void* const data, const cds_size size){
+    if (!stream || (!data && size)){
+        return false;
+    }
+    if (stream->fd < 0){
+        if (size > stream->capacity - stream->head){
+            return false;
+        }
+        (void) memcpy(stream->buffer + stream->head, data, size);
+        stream->head += size;
+    }else if (size <= stream->capacity - stream->tail){
+        stream->writing = true;
+        (void) memcpy(stream->buffer + stream->tail, data, size);
+        stream->tail += size;
+    }else{
+        if (!streamFlush(stream)){
+            return false;
+        }
+        // large writes (e.g. the elements of a vector) bypass the buffer.
+        if (size >= stream->capacity){
+            if (!_writeAll(stream->fd, data, size)){
+                return false;
+            }
+        }else{
+            (void) memcpy(stream->buffer, data, size);
+            stream->tail = size;
+            stream->writing = true;
+        }
+    }
+    stream->position += size;
+    return true;
+}
+
+cds_size streamRead(Stream* const stream, void* const data, const cds_size size){
+    if (!stream || !data){
+        return 0;
+    }
+    cds_uchar* out = (cds_uchar*) data;
+    cds_size count = 0;
+    while (count < size){
+        if (stream->head < stream->tail){
+            cds_size available = stream->tail - stream->head;
+            cds_size n = available < size - count ? available : size - count;
+            (void) memcpy(out + count, stream->buffer + stream->head, n);
+            stream->head += n;
+            count += n;
+            continue;
+        }
+        if (stream->fd < 0){
+            break;
+        }
+        cds_size n = 0;
+        if (size - count >= stream->capacity){
+            // large reads bypass the buffer.
+            n = _readOnce(stream->fd, out + count, size - count);
+            count += n;
+        }else{
+            n = _readOnce(stream->fd, stream->buffer, stream->capacity);
+            stream->head = 0;
+            stream->tail = n;
+        }
+        if (!n){
+            break;
+        }
+    }
+    stream->position += count;
+    return count;
+}
+
+cds_size streamPosition(const Stream* const stream){
+    return stream ? stream->position : 0;
+}
+
+/**
+ * FORMAT
+ * ------
+ * Headers are the magic bytes, the kind of the container (one byte), the
+ * version and the flags (two bytes each), followed by 64 bits sizes.
+*/
+
+enum SerialKind{
+    SERIAL_VECTOR = 1,
+    SERIAL_TUPLE,
+    SERIAL_SLLIST,
+    SERIAL_HASH_TABLE,
+    SERIAL_SET,
+};
+
+#define SERIAL_MAGIC "CDS"
+#define SERIAL_HEADER_SIZE 8
+#define SERIAL_FLAG_BIG_ENDIAN 0x1
+
+static cds_bool _hostIsBigEndian(void){
+    const uint16_t probe = 1;
+    return 0 == *(const cds_uchar*) &probe;
+}
+
+static cds_bool _writeU64(Stream* const stream, const uint64_t value){
+    cds_uchar bytes[8];
+    for (cds_size i=0; i<8; i++){
+        bytes[i] = (cds_uchar) (value >> (8*i));
+    }
+    return streamWrite(stream, bytes, 8);
+}
+
+static cds_bool _readU64(Stream* const stream, uint64_t* const pvalue){
+    cds_uchar bytes[8];
+    if (8 != streamRead(stream, bytes, 8)){
+        return false;
+    }
+    uint64_t value = 0;
+    for (cds_size i=0; i<8; i++){
+        value |= (uint64_t) bytes[i] << (8*i);
+    }
+    *pvalue = value;
+    return true;
+}
+
+/**
+ * Reads a size, rejecting the ones that do not fit in a `cds_size`.
+*/
+static cds_bool _readSize(Stream* const stream, cds_size* const psize){
+    uint64_t value;
+    if (!_readU64(stream, &value) || value > (uint64_t) SIZE_MAX){
+        return false;
+    }
+    *psize = (cds_size) value;
+    return true;
+}
+
+static cds_bool _writeHeader(Stream* const stream, const enum SerialKind kind){
+    const cds_uint16 flags = _hostIsBigEndian() ? SERIAL_FLAG_BIG_ENDIAN : 0;
+    cds_uchar header[SERIAL_HEADER_SIZE] = {
+        SERIAL_MAGIC[0], SERIAL_MAGIC[1], SERIAL_MAGIC[2], (cds_uchar) kind,
+        CDS_SERIAL_VERSION & 0xFF, CDS_SERIAL_VERSION >> 8, flags & 0xFF, flags >> 8,
+    };
+    return streamWrite(stream, header, SERIAL_HEADER_SIZE);
+}
+
+/**
+ * Reads a header, returning the kind of the container or 0 if the header is
+ * not valid for this library.
+*/
+static cds_uchar _readHeader(Stream* const stream){
+    cds_uchar header[SERIAL_HEADER_SIZE];
+    if (SERIAL_HEADER_SIZE != streamRead(stream, header, SERIAL_HEADER_SIZE)
+        || 0 != memcmp(header, SERIAL_MAGIC, 3)){
+        return 0;
+    }
+    const cds_uint16 version = (cds_uint16) (header[4] | header[5] << 8);
+    const cds_uint16 flags = (cds_uint16) (header[6] | header[7] << 8);
+    const cds_uint16 host = _hostIsBigEndian() ? SERIAL_FLAG_BIG_ENDIAN : 0;
+    if (version > CDS_SERIAL_VERSION || (flags & SERIAL_FLAG_BIG_ENDIAN) != host){
+        return 0;
+    }
+    return header[3];
+}
+
+/**
+ * Writes a header followed by a plain array of elements.
+*/
+static cds_bool _writeArray(Stream* const stream, const enum SerialKind kind, const void* const arr,
+                            const cds_size data_size, const cds_size length){
+    return _writeHeader(stream, kind) && _writeU64(stream, data_size) && _writeU64(stream, length)
+           && streamWrite(stream, arr, length * data_size);
+}
+
+/**
+ * Reads the sizes of a plain array, rejecting the ones whose bytes overflow.
+*/
+static cds_bool _readArraySizes(Stream* const stream, cds_size* const pdata_size,
+                                cds_size* const plength){
+    if (!_readSize(stream, pdata_size) || !_readSize(stream, plength)){
+        return false;
+    }
+    return !*plength || (*pdata_size * *plength) / *plength == *pdata_size;
+}
+
+/**
+ * VECTORS AND TUPLES
+ * ------------------
+*/
+
+cds_bool vectorWrite(const Vector* const vec, Stream* const stream){
+    if (!vec || !stream){
+        return false;
+    }
+    return _writeArray(stream, SERIAL_VECTOR, vec->container, vec->data_size, vec->length);
+}
+
+/**
+ * The length in the header is not trusted for the allocation: the buffer
+ * starts at (at most) `STREAM_CHUNK_SIZE` bytes and doubles while the elements
+ * keep coming, so a corrupt length fails at the end of the stream after
+ * allocating at most twice the bytes it holds.
+*/
+Vector* vectorRead(Stream* const stream){
+    const cds_uchar kind = _readHeader(stream);
+    cds_size data_size = 0;
+    cds_size length = 0;
+    if ((SERIAL_VECTOR != kind && SERIAL_TUPLE != kind)
+        || !_readArraySizes(stream, &data_size, &length) || (!data_size && length)){
+        return (Vector*) NULL;
+    }
+    const cds_size chunk = data_size < STREAM_CHUNK_SIZE ? STREAM_CHUNK_SIZE / data_size : 1;
+    Vector* vec = vectorCreate(length < chunk ? (length ? length : 1) : chunk, data_size);
+    if (!vec){
+        return (Vector*) NULL;
+    }
+    while (vec->length < length){
+        if (vec->length == vec->capacity
+            && !vectorReserve(vec, length - vec->length < vec->capacity ? length : 2*vec->capacity)){
+            vectorDelete(vec);
+            return (Vector*) NULL;
+        }
+        const cds_size count = (length - vec->length < vec->capacity - vec->length ? length : vec->capacity)
+                               - vec->length;
+        void* free_space = CDS_BYTE_OFFSET(vec->container, (vec->length * data_size));
+        if (count * data_size != streamRead(stream, free_space, count * data_size)){
+            vectorDelete(vec);
+            return (Vector*) NULL;
+        }
+        vec->length += count;
+    }
+    return vec;
+}
+
+cds_size vectorAppendFromStream(Vector* const vec, Stream* const stream){
+    if (!VECTOR_WRITABLE(vec) || !stream || !vec->data_size){
+        return CDS_NOT_FOUND;
+    }
+    const cds_size first = vec->length;
+    cds_size partial = 0;   // bytes of an element split between reads
+    for (;;){
+        if (vec->length == vec->capacity && !vectorReserve(vec, vec->capacity + 1)){
+            return CDS_NOT_FOUND;
+        }
+        cds_uchar* free_space = (cds_uchar*) CDS_BYTE_OFFSET(vec->container, vec->length * vec->data_size);
+        const cds_size room = (vec->capacity - vec->length) * vec->data_size - partial;
+        const cds_size n = streamRead(stream, free_space + partial, room);
+        partial += n;
+        vec->length += partial / vec->data_size;
+        partial %= vec->data_size;
+        if (n < room){
+            break;
+        }
+    }
+    return partial ? CDS_NOT_FOUND : vec->length - first;
+}
+
+cds_bool tupleWrite(const Tuple* const tuple, Stream* const stream){
+    if (!tuple || !stream){
+        return false;
+    }
+    return _writeArray(stream, SERIAL_TUPLE, tuple->container, tuple->data_size, tuple->length);
+}
+
+Tuple* tupleRead(Stream* const stream){
+    // the tuple takes over the buffer the elements were read into.
+    Vector* vec = vectorRead(stream);
+    if (!vec){
+        return (Tuple*) NULL;
+    }
+    Tuple* tuple = vectorIntoTuple(vec, true);
+    if (!tuple){
+        vectorDelete(vec);
+    }
+    return tuple;
+}
+
+/**
+ * SINGLY LINKED LISTS
+ * -------------------
+*/
+
+cds_bool sllWrite(const SLList* const list, Stream* const stream){
+    if (!list || !stream || !_writeHeader(stream, SERIAL_SLLIST)
+        || !_writeU64(stream, list->data_size) || !_writeU64(stream, list->length)){
+        return false;
+    }
+    for (const SLLNode* node=list->head; node; node=node->next){
+        if (!streamWrite(stream, node->data, list->data_size)){
+            return false;
+        }
+    }
+    return true;
+}
+
+SLList* sllRead(Stream* const stream){
+    cds_size data_size = 0;
+    cds_size length = 0;
+    if (SERIAL_SLLIST != _readHeader(stream) || !_readArraySizes(stream, &data_size, &length)
+        || (!data_size && length)){
+        return (SLList*) NULL;
+    }
+    SLList* list = sllCreate(data_size);
+    // the nodes copy their data, so one element is read at a time.
+    cds_uchar* element = (cds_uchar*) malloc(data_size ? data_size : 1);
+    if (!list || !element){
+        sllDelete(list);
+        free(element);
+        return (SLList*) NULL;
+    }
+    for (cds_size i=0; i<length; i++){
+        if (data_size != streamRead(stream, element, data_size) || !sllAppend(list, element)){
+            sllDelete(list);
+            free(element);
+            return (SLList*) NULL;
+        }
+    }
+    free(element);
+    return list;
+}
+
+/**
+ * HASH TABLES AND SETS
+ * --------------------
+ * Keys are written as their size and bytes, except tuple keys which are
+ * written as their data size, length and elements.
+*/
+
+#define IS_TUPLE_KEY(key_type) (STR_TUPLE_KEY == (key_type) || INT_TUPLE_KEY == (key_type) \
+                                || UINT_TUPLE_KEY == (key_type))
+
+static cds_bool _writeKey(Stream* const stream, const KeyType key_type, const void* const key,
+                          const cds_size key_size){
+    if (IS_TUPLE_KEY(key_type)){
+        const Tuple* tuple = (const Tuple*) key;
+        return _writeU64(stream, tuple->data_size) && _writeU64(stream, tuple->length)
+               && streamWrite(stream, tuple->container, tuple->length * tuple->data_size);
+    }
+    const cds_size size = STR_KEY == key_type ? strlen((const cds_char*) key) + 1 : key_size;
+    return _writeU64(stream, size) && streamWrite(stream, key, size);
+}
+
+/**
+ * Reads `size` bytes into the arena.
+*/
+static void* _readBlob(Stream* const stream, Arena* const arena, const cds_size size){
+    void* blob = arenaAlloc(arena, size);
+    if (!blob || size != streamRead(stream, blob, size)){
+        return NULL;
+    }
+    return blob;
+}
+
+static const void* _readKey(Stream* const stream, const KeyType key_type, Arena* const arena,
+                            cds_size* const pkey_size){
+    if (IS_TUPLE_KEY(key_type)){
+        cds_size data_size = 0;
+        cds_size length = 0;
+        if (!_readArraySizes(stream, &data_size, &length)){
+            return NULL;
+        }
+        const void* elements = _readBlob(stream, arena, length * data_size);
+        *pkey_size = sizeof(Tuple*);
+        return elements ? tupleCreateInArena(arena, elements, data_size, length) : NULL;
+    }
+    if (!_readSize(stream, pkey_size) || !*pkey_size){
+        return NULL;
+    }
+    const cds_char* key = (const cds_char*) _readBlob(stream, arena, *pkey_size);
+    if (key && STR_KEY == key_type && '\0' != key[*pkey_size - 1]){
+        return NULL;
+    }
+    return key;
+}
+
+static cds_bool _readKeyType(Stream* const stream, KeyType* const pkey_type){
+    uint64_t key_type;
+    if (!_readU64(stream, &key_type) || key_type > UINT_TUPLE_KEY){
+        return false;
+    }
+    *pkey_type = (KeyType) key_type;
+    return true;
+}
+
+cds_bool htWrite(const HashTable* const ht, Stream* const stream){
+    if (!ht || !stream || !_writeHeader(stream, SERIAL_HASH_TABLE)
+        || !_writeU64(stream, (uint64_t) ht->key_type) || !_writeU64(stream, ht->length)){
+        return false;
+    }
+    for (cds_size i=0; i<ht->capacity; i++){
+        const HTEntry* entry = &ht->container[i];
+        if (!entry->key){
+            continue;
+        }
+        if (!_writeKey(stream, ht->key_type, entry->key, entry->key_size)
+            || !_writeU64(stream, entry->data_size)
+            || !streamWrite(stream, entry->data, entry->data_size)){
+            return false;
+        }
+    }
+    return true;
+}
+
+HashTable* htRead(Stream* const stream, const HashFunction hash_fun, Arena* const arena){
+    KeyType key_type;
+    cds_size length = 0;
+    if (!hash_fun || !arena || SERIAL_HASH_TABLE != _readHeader(stream)
+        || !_readKeyType(stream, &key_type) || !_readSize(stream, &length)){
+        return (HashTable*) NULL;
+    }
+    // as for vectors, the length is not trusted for the allocation: past
+    // `STREAM_CHUNK_SIZE` bytes of entries the table expands as they arrive.
+    const cds_size budget = STREAM_CHUNK_SIZE / sizeof(HTEntry);
+    HashTable* ht = htCreate(hash_fun, length < budget / 2 ? 2 * length + 1 : budget, key_type);
+    if (!ht){
+        return (HashTable*) NULL;
+    }
+    for (cds_size i=0; i<length; i++){
+        cds_size key_size = 0;
+        cds_size data_size = 0;
+        const void* key = _readKey(stream, key_type, arena, &key_size);
+        const void* data = NULL;
+        if (key && _readSize(stream, &data_size)){
+            data = _readBlob(stream, arena, data_size);
+        }
+        if (!data || !htSet(ht, key, key_size, data, data_size)){
+            htDelete(ht);
+            return (HashTable*) NULL;
+        }
+    }
+    return ht;
+}
+
+cds_bool setWrite(const Set* const set, Stream* const stream){
+    if (!set || !stream){
+        return false;
+    }
+    cds_size length = 0;
+    for (cds_size i=0; i<set->capacity; i++){
+        length += NULL != set->container[i].key;
+    }
+    if (!_writeHeader(stream, SERIAL_SET) || !_writeU64(stream, (uint64_t) set->key_type)
+        || !_writeU64(stream, length)){
+        return false;
+    }
+    for (cds_size i=0; i<set->capacity; i++){
+        const SetEntry* entry = &set->container[i];
+        if (entry->key && !_writeKey(stream, set->key_type, entry->key, entry->key_size)){
+            return false;
+        }
+    }
+    return true;
+}
+
+Set* setRead(Stream* const stream, const HashFunction hash_fun, Arena* const arena){
+    KeyType key_type;
+    cds_size length = 0;
+    if (!hash_fun || !arena || SERIAL_SET != _readHeader(stream)
+        || !_readKeyType(stream, &key_type) || !_readSize(stream, &length)){
+        return (Set*) NULL;
+    }
+    // sets do not expand, so the keys are read first (into a vector growing
+    // as they arrive, since the length is not trusted) and the set is created
+    // with room for all of them.
+    const cds_size budget = STREAM_CHUNK_SIZE / sizeof(SetEntry);
+    Vector* entries = vectorCreate(length < budget ? (length ? length : 1) : budget, sizeof(SetEntry));
+    if (!entries){
+        return (Set*) NULL;
+    }
+    for (cds_size i=0; i<length; i++){
+        SetEntry entry = {.is_tombstone=false};
+        entry.key = _readKey(stream, key_type, arena, &entry.key_size);
+        if (!entry.key || !vectorPrepend(entries, &entry)){
+            vectorDelete(entries);
+            return (Set*) NULL;
+        }
+    }
+    Set* set = setCreate(2 * length + 1, hash_fun, key_type);
+    for (cds_size i=0; set && i<length; i++){
+        const SetEntry* entry = (const SetEntry*) vectorGetAt(entries, i);
+        (void) setInsert(set, entry->key, entry->key_size);
+    }
+    vectorDelete(entries);
+    return set;
+}
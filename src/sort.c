@@ -0,0 +1,464 @@
+/*!
+ * @file sort.c
+ * @copyright GNU General Public Licence 3 or Later (GPLv3).
+ * @author Paulo Arruda
+ * @brief Implementation of the sort API.
+*/
+
+#include "../include/sort.h"
+#include "../include/thread_pool.h"
+#include "../include/_private_linear.h"
+
+/**
+ * Runs of at most this many elements are sorted by insertion before merging.
+*/
+#define _INSERTION_RUN 16
+
+#define ELEM(base, i, size) CDS_BYTE_OFFSET(base, (i)*(size))
+
+/**
+ * SEQUENTIAL MERGE SORT
+ * ---------------------
+*/
+
+static void _insertionSort(void* base, const cds_size length, const cds_size size,
+                           const TComparisonFun compare, void* swap){
+    for (cds_size i=1; i<length; i++){
+        if (compare(ELEM(base, i-1, size), ELEM(base, i, size)) <= 0){
+            continue;
+        }
+        cds_size j = i;
+        (void) memcpy(swap, ELEM(base, i, size), size);
+        while (j > 0 && compare(ELEM(base, j-1, size), swap) > 0){
+            j--;
+        }
+        (void) memmove(ELEM(base, j+1, size), ELEM(base, j, size), (i - j)*size);
+        (void) memcpy(ELEM(base, j, size), swap, size);
+    }
+}
+
+/**
+ * Stable merge of the sorted runs `a` and `b` into `dst`.
+*/
+static void _merge(const void* a, cds_size na, const void* b, cds_size nb, void* dst,
+                   const cds_size size, const TComparisonFun compare){
+    cds_byte* out = (cds_byte*) dst;
+    const cds_byte* pa = (const cds_byte*) a;
+    const cds_byte* pb = (const cds_byte*) b;
+    while (na && nb){
+        if (compare(pb, pa) < 0){
+            (void) memcpy(out, pb, size);
+            pb += size;
+            nb--;
+        }else{
+            (void) memcpy(out, pa, size);
+            pa += size;
+            na--;
+        }
+        out += size;
+    }
+    (void) memcpy(out, pa, na*size);
+    (void) memcpy(out + na*size, pb, nb*size);
+}
+
+/**
+ * Bottom-up merge sort of `base` using `tmp` (of the same length) as the
+ * auxiliary buffer. The result is always left in `base`.
+*/
+static void _mergeSort(void* base, void* tmp, const cds_size length, const cds_size size,
+                       const TComparisonFun compare){
+    for (cds_size i=0; i<length; i+=_INSERTION_RUN){
+        cds_size run = length - i < _INSERTION_RUN ? length - i : _INSERTION_RUN;
+        _insertionSort(ELEM(base, i, size), run, size, compare, tmp);
+    }
+    void* src = base;
+    void* dst = tmp;
+    for (cds_size width=_INSERTION_RUN; width<length; width<<=1){
+        for (cds_size i=0; i<length; i+=2*width){
+            cds_size na = length - i < width ? length - i : width;
+            cds_size nb = length - i - na < width ? length - i - na : width;
+            _merge(ELEM(src, i, size), na, ELEM(src, i + na, size), nb, ELEM(dst, i, size),
+                   size, compare);
+        }
+        void* swap = src;
+        src = dst;
+        dst = swap;
+    }
+    if (src != base){
+        (void) memcpy(base, src, length*size);
+    }
+}
+
+/**
+ * PARALLEL MERGE SORT
+ * -------------------
+ * The array is split into a power of two number of chunks, one per thread,
+ * which are sorted independently. The chunks are then merged pairwise in
+ * rounds; every merge of a round is split along the merge path so that all
+ * threads keep working until the last round.
+*/
+
+typedef struct SortTask{
+    void* src;
+    void* dst;
+    cds_size size;
+    TComparisonFun compare;
+    // chunk sorting
+    cds_size begin;
+    cds_size length;
+    // merging
+    cds_size a_begin, a_length;
+    cds_size b_begin, b_length;
+    cds_size out_begin;
+}SortTask;
+
+static cds_size _sortNumThreads(const cds_size length){
+    cds_size threads = _numThreads();
+    if (SORT_MAX_THREADS > 0 && threads > (cds_size) SORT_MAX_THREADS){
+        threads = SORT_MAX_THREADS;
+    }
+    while (threads > 1 && length / threads < SORT_PARALLEL_THRESHOLD / 2){
+        threads--;
+    }
+    // round down to a power of two
+    return (cds_size) 1 << _log2(threads);
+}
+
+static void _sortChunkTask(void* arg, const cds_size t){
+    const SortTask* task = (const SortTask*) arg + t;
+    _mergeSort(ELEM(task->src, task->begin, task->size), ELEM(task->dst, task->begin, task->size),
+               task->length, task->size, task->compare);
+}
+
+static void _mergeTask(void* arg, const cds_size t){
+    const SortTask* task = (const SortTask*) arg + t;
+    _merge(ELEM(task->src, task->a_begin, task->size), task->a_length,
+           ELEM(task->src, task->b_begin, task->size), task->b_length,
+           ELEM(task->dst, task->out_begin, task->size), task->size, task->compare);
+}
+
+/**
+ * Number of elements of `a` among the first `diag` elements of the stable
+ * merge of `a` and `b`.
+*/
+static cds_size _mergePathSplit(const void* a, const cds_size na, const void* b, const cds_size nb,
+                                const cds_size diag, const cds_size size,
+                                const TComparisonFun compare){
+    cds_size lo = diag > nb ? diag - nb : 0;
+    cds_size hi = diag < na ? diag : na;
+    while (lo < hi){
+        cds_size mid = lo + (hi - lo) / 2;
+        if (compare(ELEM(a, mid, size), ELEM(b, diag - mid - 1, size)) <= 0){
+            lo = mid + 1;
+        }else{
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+static void _parallelMergeSort(void* base, void* tmp, const cds_size length, const cds_size size,
+                               const TComparisonFun compare, const cds_size num_threads){
+    SortTask tasks[num_threads];
+    cds_size chunk = length / num_threads;
+    for (cds_size t=0; t<num_threads; t++){
+        tasks[t] = (SortTask){
+            .src = base, .dst = tmp, .size = size, .compare = compare,
+            .begin = t*chunk,
+            .length = t+1 == num_threads ? length - t*chunk : chunk,
+        };
+    }
+    tpoolRun(tpoolDefault(), _sortChunkTask, tasks, num_threads);
+    void* src = base;
+    void* dst = tmp;
+    for (cds_size runs=num_threads; runs>1; runs>>=1){
+        // every pair of runs is merged by `num_threads / (runs/2)` threads.
+        cds_size per_merge = num_threads / (runs >> 1);
+        cds_size run_chunks = num_threads / runs;
+        cds_size t = 0;
+        for (cds_size r=0; r<runs; r+=2){
+            cds_size a_begin = r*run_chunks*chunk;
+            cds_size b_begin = (r+1)*run_chunks*chunk;
+            cds_size b_end = r+2 == runs ? length : (r+2)*run_chunks*chunk;
+            cds_size na = b_begin - a_begin;
+            cds_size nb = b_end - b_begin;
+            const void* a = ELEM(src, a_begin, size);
+            const void* b = ELEM(src, b_begin, size);
+            cds_size prev_diag = 0;
+            cds_size prev_split = 0;
+            for (cds_size p=1; p<=per_merge; p++, t++){
+                cds_size diag = p == per_merge ? na + nb : (na + nb) / per_merge * p;
+                cds_size split = _mergePathSplit(a, na, b, nb, diag, size, compare);
+                tasks[t] = (SortTask){
+                    .src = src, .dst = dst, .size = size, .compare = compare,
+                    .a_begin = a_begin + prev_split, .a_length = split - prev_split,
+                    .b_begin = b_begin + (prev_diag - prev_split),
+                    .b_length = (diag - split) - (prev_diag - prev_split),
+                    .out_begin = a_begin + prev_diag,
+                };
+                prev_diag = diag;
+                prev_split = split;
+            }
+        }
+        tpoolRun(tpoolDefault(), _mergeTask, tasks, num_threads);
+        void* swap = src;
+        src = dst;
+        dst = swap;
+    }
+    if (src != base){
+        (void) memcpy(base, src, length*size);
+    }
+}
+
+/**
+ * RADIX SORT
+ * ----------
+ * Signed and floating point keys are mapped into unsigned integers with the
+ * same ordering before sorting and mapped back afterwards. The histograms of
+ * all digits are computed in a single pass, and passes whose digit is the same
+ * for every key are skipped.
+*/
+
+#define _RADIX_BITS 8
+#define _RADIX_BUCKETS (1 << _RADIX_BITS)
+
+#define DEFINE_RADIX_SORT(width)                                                            \
+static cds_bool _radixSortU##width(cds_uint##width* data, cds_uint##width* tmp,             \
+                                   const cds_size length){                                 \
+    enum { num_digits = width / _RADIX_BITS };                                             \
+    cds_size (*counts)[_RADIX_BUCKETS] = calloc(num_digits, sizeof(*counts));              \
+    if (!counts){                                                                           \
+        return false;                                                                       \
+    }                                                                                       \
+    for (cds_size i=0; i<length; i++){                                                      \
+        cds_uint##width key = data[i];                                                      \
+        for (cds_size d=0; d<num_digits; d++){                                              \
+            counts[d][(key >> (d*_RADIX_BITS)) & (_RADIX_BUCKETS - 1)]++;                   \
+        }                                                                                   \
+    }                                                                                       \
+    cds_uint##width* src = data;                                                            \
+    cds_uint##width* dst = tmp;                                                             \
+    for (cds_size d=0; d<num_digits; d++){                                                  \
+        cds_size shift = d*_RADIX_BITS;                                                     \
+        if (counts[d][(src[0] >> shift) & (_RADIX_BUCKETS - 1)] == length){                 \
+            continue;                                                                       \
+        }                                                                                   \
+        cds_size offset = 0;                                                                \
+        for (cds_size b=0; b<_RADIX_BUCKETS; b++){                                          \
+            cds_size count = counts[d][b];                                                  \
+            counts[d][b] = offset;                                                          \
+            offset += count;                                                                \
+        }                                                                                   \
+        for (cds_size i=0; i<length; i++){                                                  \
+            dst[counts[d][(src[i] >> shift) & (_RADIX_BUCKETS - 1)]++] = src[i];            \
+        }                                                                                   \
+        cds_uint##width* swap = src;                                                        \
+        src = dst;                                                                          \
+        dst = swap;                                                                         \
+    }                                                                                       \
+    if (src != data){                                                                       \
+        (void) memcpy(data, src, length*sizeof(*data));                                     \
+    }                                                                                       \
+    free(counts);                                                                           \
+    return true;                                                                            \
+}
+
+DEFINE_RADIX_SORT(8)
+DEFINE_RADIX_SORT(16)
+DEFINE_RADIX_SORT(32)
+DEFINE_RADIX_SORT(64)
+
+#define SIGN_BIT(width) ((cds_uint##width) 1 << (width - 1))
+
+#define DEFINE_SIGNED_MAPPING(width)                                                        \
+static void _flipSign##width(cds_uint##width* data, const cds_size length){                 \
+    for (cds_size i=0; i<length; i++){                                                      \
+        data[i] ^= SIGN_BIT(width);                                                         \
+    }                                                                                       \
+}
+
+#define DEFINE_FLOAT_MAPPING(width)                                                         \
+static void _floatToKey##width(cds_uint##width* data, const cds_size length){               \
+    for (cds_size i=0; i<length; i++){                                                      \
+        cds_uint##width mask = (cds_uint##width) -(data[i] >> (width - 1)) | SIGN_BIT(width);\
+        data[i] ^= mask;                                                                    \
+    }                                                                                       \
+}                                                                                           \
+static void _keyToFloat##width(cds_uint##width* data, const cds_size length){               \
+    for (cds_size i=0; i<length; i++){                                                      \
+        cds_uint##width mask = ((data[i] >> (width - 1)) - 1) | SIGN_BIT(width);            \
+        data[i] ^= mask;                                                                    \
+    }                                                                                       \
+}
+
+DEFINE_SIGNED_MAPPING(8)
+DEFINE_SIGNED_MAPPING(16)
+DEFINE_SIGNED_MAPPING(32)
+DEFINE_SIGNED_MAPPING(64)
+DEFINE_FLOAT_MAPPING(32)
+DEFINE_FLOAT_MAPPING(64)
+
+cds_bool arrSortNumeric(void* const arr, const cds_size length, const enum NumericType type){
+    if (!arr){
+        return false;
+    }
+    if (length < 2){
+        return true;
+    }
+    const cds_size size = _numericSize(type);
+    void* tmp = malloc(length*size);
+    if (!tmp){
+        return false;
+    }
+    // the keys are mapped back even if the sort failed, leaving the array as it was.
+    cds_bool sorted = false;
+    switch (type){
+        case NUM_UINT8:
+            sorted = _radixSortU8(arr, tmp, length);
+            break;
+        case NUM_INT8:
+            _flipSign8(arr, length);
+            sorted = _radixSortU8(arr, tmp, length);
+            _flipSign8(arr, length);
+            break;
+        case NUM_UINT16:
+            sorted = _radixSortU16(arr, tmp, length);
+            break;
+        case NUM_INT16:
+            _flipSign16(arr, length);
+            sorted = _radixSortU16(arr, tmp, length);
+            _flipSign16(arr, length);
+            break;
+        case NUM_UINT32:
+            sorted = _radixSortU32(arr, tmp, length);
+            break;
+        case NUM_INT32:
+            _flipSign32(arr, length);
+            sorted = _radixSortU32(arr, tmp, length);
+            _flipSign32(arr, length);
+            break;
+        case NUM_FLOAT:
+            _floatToKey32(arr, length);
+            sorted = _radixSortU32(arr, tmp, length);
+            _keyToFloat32(arr, length);
+            break;
+        case NUM_UINT64:
+            sorted = _radixSortU64(arr, tmp, length);
+            break;
+        case NUM_INT64:
+            _flipSign64(arr, length);
+            sorted = _radixSortU64(arr, tmp, length);
+            _flipSign64(arr, length);
+            break;
+        case NUM_DOUBLE:
+            _floatToKey64(arr, length);
+            sorted = _radixSortU64(arr, tmp, length);
+            _keyToFloat64(arr, length);
+            break;
+    }
+    free(tmp);
+    return sorted;
+}
+
+cds_bool arrSort(void* const arr, const cds_size length, const cds_size data_size,
+                 const TComparisonFun compare){
+    if (!arr || !compare || !data_size){
+        return false;
+    }
+    if (length < 2){
+        return true;
+    }
+    if (compare == intOrderComp && sizeof(cds_int) == data_size){
+        return arrSortNumeric(arr, length, sizeof(cds_int) == 4 ? NUM_INT32 : NUM_INT64);
+    }
+    void* tmp = malloc(length*data_size);
+    if (!tmp){
+        return false;
+    }
+    cds_size num_threads = _sortNumThreads(length);
+    if (num_threads > 1){
+        _parallelMergeSort(arr, tmp, length, data_size, compare, num_threads);
+    }else{
+        _mergeSort(arr, tmp, length, data_size, compare);
+    }
+    free(tmp);
+    return true;
+}
+
+/**
+ * CONTAINERS
+ * ----------
+*/
+
+cds_bool vectorSort(Vector* const vec, const TComparisonFun compare){
+    if (!VECTOR_WRITABLE(vec)){
+        return false;
+    }
+    return arrSort(vec->container, vec->length, vec->data_size, compare);
+}
+
+cds_bool vectorSortNumeric(Vector* const vec, const enum NumericType type){
+    if (!VECTOR_WRITABLE(vec) || _numericSize(type) != vec->data_size){
+        return false;
+    }
+    return arrSortNumeric(vec->container, vec->length, type);
+}
+
+cds_bool vectorSliceSort(const VectorSlice* const slice, const TComparisonFun compare){
+    if (!slice){
+        return false;
+    }
+    return arrSort(slice->data, slice->length, slice->data_size, compare);
+}
+
+cds_bool vectorSliceSortNumeric(const VectorSlice* const slice, const enum NumericType type){
+    if (!slice || _numericSize(type) != slice->data_size){
+        return false;
+    }
+    return arrSortNumeric(slice->data, slice->length, type);
+}
+
+Tuple* tupleSorted(const Tuple* const tuple, const TComparisonFun compare){
+    if (!tuple || !compare){
+        return (Tuple*) NULL;
+    }
+    Tuple* sorted = tupleFromArray(tuple->container, tuple->data_size, tuple->length);
+    if (!sorted){
+        return (Tuple*) NULL;
+    }
+    if (!arrSort((void*) sorted->container, sorted->length, sorted->data_size, compare)){
+        tupleDelete(sorted);
+        return (Tuple*) NULL;
+    }
+    return sorted;
+}
+
+Tuple* tupleSliceSorted(const TupleSlice* const slice, const TComparisonFun compare){
+    if (!slice || !compare){
+        return (Tuple*) NULL;
+    }
+    Tuple* sorted = tupleFromArray(slice->data, slice->data_size, slice->length);
+    if (!sorted){
+        return (Tuple*) NULL;
+    }
+    if (sorted->length && !arrSort((void*) sorted->container, sorted->length, sorted->data_size, compare)){
+        tupleDelete(sorted);
+        return (Tuple*) NULL;
+    }
+    return sorted;
+}
+
+Tuple* tupleSortedNumeric(const Tuple* const tuple, const enum NumericType type){
+    if (!tuple || _numericSize(type) != tuple->data_size){
+        return (Tuple*) NULL;
+    }
+    Tuple* sorted = tupleFromArray(tuple->container, tuple->data_size, tuple->length);
+    if (!sorted){
+        return (Tuple*) NULL;
+    }
+    if (!arrSortNumeric((void*) sorted->container, sorted->length, type)){
+        tupleDelete(sorted);
+        return (Tuple*) NULL;
+    }
+    return sorted;
+}
@@ -0,0 +1,314 @@
+/*!
+ * @file spsc_ring.c
+ * @copyright GNU General Public Licence 3 or Later (GPLv3).
+ * @author Paulo Arruda
+ * @brief Implementation of the SPSC ring buffer.
+*/
+
+#include <string.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "../include/spsc_ring.h"
+#include "../include/_private_memory.h"
+
+#define SPSC_MAGIC 0x43445353505343ULL // "CDSSPSC"
+
+/**
+ * Shared part of the ring, at the beginning of its buffer so that it can be
+ * mapped by several processes. The producer writes only `tail` and the
+ * consumer only `head`, each on a cache line of its own.
+*/
+typedef struct SPSCHeader{
+    _Alignas(CDS_CACHE_LINE) atomic_size_t head;    // next position to read
+    _Alignas(CDS_CACHE_LINE) atomic_size_t tail;    // next position to write
+    _Alignas(CDS_CACHE_LINE) uint64_t magic;
+    cds_size capacity;
+    cds_size data_size;
+}SPSCHeader;
+
+enum SPSCStorage{
+    SPSC_STORAGE_HEAP,
+    SPSC_STORAGE_SHARED,    // anonymous or file shared mapping
+};
+
+/**
+ * Process local part of the ring. The cached positions are written by one side
+ * each, so they are kept apart from each other and from the read-only fields.
+*/
+struct SPSCRing{
+    _Alignas(CDS_CACHE_LINE) cds_size cached_head;  // the producer's copy of `head`
+    _Alignas(CDS_CACHE_LINE) cds_size cached_tail;  // the consumer's copy of `tail`
+    _Alignas(CDS_CACHE_LINE) SPSCHeader* header;
+    cds_uchar* data;
+    cds_size mask;
+    cds_size data_size;
+    cds_size bytes;         // of the buffer, header included
+    enum SPSCStorage storage;
+};
+
+static const AllocOptions _spsc_options = {CDS_CACHE_LINE, HUGE_PAGES_NONE};
+
+/**
+ * Computes the capacity and the buffer size of a ring, or returns `false` if
+ * the parameters are invalid.
+*/
+static cds_bool _spscSizes(const cds_size capacity, const cds_size data_size, cds_size* const pcapacity,
+                           cds_size* const pbytes){
+    if (!capacity || !data_size){
+        return false;
+    }
+    cds_size pow = capacity > 1 ? _log2(capacity - 1) + 1 : 0;
+    if (pow >= _MAX_POW2_ || ((cds_size) -1 - sizeof(SPSCHeader)) / data_size < ((cds_size) 1 << pow)){
+        return false;
+    }
+    *pcapacity = (cds_size) 1 << pow;
+    *pbytes = sizeof(SPSCHeader) + *pcapacity * data_size;
+    return true;
+}
+
+static SPSCRing* _spscAttach(void* const buffer, const cds_size bytes, const enum SPSCStorage storage){
+    SPSCRing* ring = (SPSCRing*) _cdsAlloc(sizeof(SPSCRing), &_spsc_options);
+    if (!ring){
+        return (SPSCRing*) NULL;
+    }
+    ring->header = (SPSCHeader*) buffer;
+    ring->data = (cds_uchar*) buffer + sizeof(SPSCHeader);
+    ring->mask = ring->header->capacity - 1;
+    ring->data_size = ring->header->data_size;
+    ring->bytes = bytes;
+    ring->storage = storage;
+    ring->cached_head = atomic_load_explicit(&ring->header->head, memory_order_acquire);
+    ring->cached_tail = atomic_load_explicit(&ring->header->tail, memory_order_acquire);
+    return ring;
+}
+
+static void _spscInitHeader(SPSCHeader* const header, const cds_size capacity, const cds_size data_size){
+    atomic_init(&header->head, 0);
+    atomic_init(&header->tail, 0);
+    header->magic = SPSC_MAGIC;
+    header->capacity = capacity;
+    header->data_size = data_size;
+}
+
+static void _spscFreeBuffer(void* const buffer, const cds_size bytes, const enum SPSCStorage storage){
+    if (SPSC_STORAGE_HEAP == storage){
+        _cdsFree(buffer, bytes, &_spsc_options);
+    }
+    else{
+        (void) munmap(buffer, bytes);
+    }
+}
+
+SPSCRing* spscCreate(const cds_size capacity, const cds_size data_size){
+    cds_size rounded, bytes;
+    if (!_spscSizes(capacity, data_size, &rounded, &bytes)){
+        return (SPSCRing*) NULL;
+    }
+    void* buffer = _cdsAlloc(bytes, &_spsc_options);
+    if (!buffer){
+        return (SPSCRing*) NULL;
+    }
+    _spscInitHeader((SPSCHeader*) buffer, rounded, data_size);
+    SPSCRing* ring = _spscAttach(buffer, bytes, SPSC_STORAGE_HEAP);
+    if (!ring){
+        _spscFreeBuffer(buffer, bytes, SPSC_STORAGE_HEAP);
+    }
+    return ring;
+}
+
+SPSCRing* spscCreateShared(const cds_size capacity, const cds_size data_size){
+    cds_size rounded, bytes;
+    if (!_spscSizes(capacity, data_size, &rounded, &bytes)){
+        return (SPSCRing*) NULL;
+    }
+    void* buffer = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED == buffer){
+        return (SPSCRing*) NULL;
+    }
+    _spscInitHeader((SPSCHeader*) buffer, rounded, data_size);
+    SPSCRing* ring = _spscAttach(buffer, bytes, SPSC_STORAGE_SHARED);
+    if (!ring){
+        _spscFreeBuffer(buffer, bytes, SPSC_STORAGE_SHARED);
+    }
+    return ring;
+}
+
+SPSCRing* spscCreateFromFd(const cds_int fd, const cds_size capacity, const cds_size data_size){
+    cds_size rounded, bytes;
+    if (fd < 0 || !_spscSizes(capacity, data_size, &rounded, &bytes)){
+        return (SPSCRing*) NULL;
+    }
+    void* buffer = _mapFileResize(NULL, fd, 0, bytes);
+    if (!buffer){
+        return (SPSCRing*) NULL;
+    }
+    _spscInitHeader((SPSCHeader*) buffer, rounded, data_size);
+    SPSCRing* ring = _spscAttach(buffer, bytes, SPSC_STORAGE_SHARED);
+    if (!ring){
+        _spscFreeBuffer(buffer, bytes, SPSC_STORAGE_SHARED);
+    }
+    return ring;
+}
+
+SPSCRing* spscOpenFd(const cds_int fd){
+    struct stat st;
+    if (fd < 0 || 0 != fstat(fd, &st) || (cds_size) st.st_size < sizeof(SPSCHeader)){
+        return (SPSCRing*) NULL;
+    }
+    const cds_size bytes = (cds_size) st.st_size;
+    void* buffer = _mapFile(fd, bytes, true);
+    if (!buffer){
+        return (SPSCRing*) NULL;
+    }
+    // the file must hold a ring whose sizes match its own size.
+    const SPSCHeader* header = (const SPSCHeader*) buffer;
+    cds_size rounded, expected;
+    if (SPSC_MAGIC != header->magic || !_spscSizes(header->capacity, header->data_size, &rounded, &expected)
+        || rounded != header->capacity || expected != bytes){
+        _spscFreeBuffer(buffer, bytes, SPSC_STORAGE_SHARED);
+        return (SPSCRing*) NULL;
+    }
+    SPSCRing* ring = _spscAttach(buffer, bytes, SPSC_STORAGE_SHARED);
+    if (!ring){
+        _spscFreeBuffer(buffer, bytes, SPSC_STORAGE_SHARED);
+    }
+    return ring;
+}
+
+void spscDelete(SPSCRing* ring){
+    if (!ring){
+        return;
+    }
+    _spscFreeBuffer(ring->header, ring->bytes, ring->storage);
+    _cdsFree(ring, sizeof(SPSCRing), &_spsc_options);
+}
+
+cds_size spscCapacity(const SPSCRing* const ring){
+    return ring ? ring->mask + 1 : 0;
+}
+
+cds_size spscLength(const SPSCRing* const ring){
+    if (!ring){
+        return 0;
+    }
+    cds_size head = atomic_load_explicit(&ring->header->head, memory_order_acquire);
+    cds_size tail = atomic_load_explicit(&ring->header->tail, memory_order_acquire);
+    return tail - head;
+}
+
+/**
+ * PRODUCER
+ * --------
+ * The producer owns `tail`, so it reads it relaxed, and reloads `head` only
+ * when its copy does not leave `count` free slots.
+*/
+
+static cds_size _spscFree(SPSCRing* const ring, const cds_size tail, const cds_size count){
+    cds_size free_slots = ring->mask + 1 - (tail - ring->cached_head);
+    if (free_slots < count){
+        ring->cached_head = atomic_load_explicit(&ring->header->head, memory_order_acquire);
+        free_slots = ring->mask + 1 - (tail - ring->cached_head);
+    }
+    return free_slots;
+}
+
+void* spscReserve(SPSCRing* const ring, const cds_size count, cds_size* const pgranted){
+    if (!ring || !pgranted){
+        return NULL;
+    }
+    const cds_size tail = atomic_load_explicit(&ring->header->tail, memory_order_relaxed);
+    const cds_size free_slots = _spscFree(ring, tail, count);
+    const cds_size contiguous = ring->mask + 1 - (tail & ring->mask);
+    cds_size granted = count < free_slots ? count : free_slots;
+    granted = granted < contiguous ? granted : contiguous;
+    *pgranted = granted;
+    return granted ? ring->data + (tail & ring->mask)*ring->data_size : NULL;
+}
+
+void spscCommit(SPSCRing* const ring, const cds_size count){
+    if (!ring || !count){
+        return;
+    }
+    const cds_size tail = atomic_load_explicit(&ring->header->tail, memory_order_relaxed);
+    atomic_store_explicit(&ring->header->tail, tail + count, memory_order_release);
+}
+
+cds_size spscPushN(SPSCRing* const ring, const void* const data, const cds_size count){
+    if (!ring || !data){
+        return 0;
+    }
+    const cds_size tail = atomic_load_explicit(&ring->header->tail, memory_order_relaxed);
+    const cds_size free_slots = _spscFree(ring, tail, count);
+    const cds_size pushed = count < free_slots ? count : free_slots;
+    // the elements are copied in (at most) two pieces, before and after the wrap.
+    const cds_size first = (tail & ring->mask) + pushed > ring->mask + 1 ? ring->mask + 1 - (tail & ring->mask) : pushed;
+    memcpy(ring->data + (tail & ring->mask)*ring->data_size, data, first*ring->data_size);
+    memcpy(ring->data, (const cds_uchar*) data + first*ring->data_size, (pushed - first)*ring->data_size);
+    if (pushed){
+        atomic_store_explicit(&ring->header->tail, tail + pushed, memory_order_release);
+    }
+    return pushed;
+}
+
+cds_bool spscTryPush(SPSCRing* const ring, const void* const data){
+    return 1 == spscPushN(ring, data, 1);
+}
+
+/**
+ * CONSUMER
+ * --------
+ * Symmetrically, the consumer owns `head` and reloads `tail` only when its copy
+ * does not show `count` elements.
+*/
+
+static cds_size _spscAvailable(SPSCRing* const ring, const cds_size head, const cds_size count){
+    cds_size available = ring->cached_tail - head;
+    if (available < count){
+        ring->cached_tail = atomic_load_explicit(&ring->header->tail, memory_order_acquire);
+        available = ring->cached_tail - head;
+    }
+    return available;
+}
+
+const void* spscPeek(SPSCRing* const ring, const cds_size max, cds_size* const pavailable){
+    if (!ring || !pavailable){
+        return NULL;
+    }
+    const cds_size head = atomic_load_explicit(&ring->header->head, memory_order_relaxed);
+    const cds_size available = _spscAvailable(ring, head, max);
+    const cds_size contiguous = ring->mask + 1 - (head & ring->mask);
+    cds_size granted = max < available ? max : available;
+    granted = granted < contiguous ? granted : contiguous;
+    *pavailable = granted;
+    return granted ? ring->data + (head & ring->mask)*ring->data_size : NULL;
+}
+
+void spscRelease(SPSCRing* const ring, const cds_size count){
+    if (!ring || !count){
+        return;
+    }
+    const cds_size head = atomic_load_explicit(&ring->header->head, memory_order_relaxed);
+    atomic_store_explicit(&ring->header->head, head + count, memory_order_release);
+}
+
+cds_size spscPopN(SPSCRing* const ring, void* const out, const cds_size max){
+    if (!ring || !out){
+        return 0;
+    }
+    const cds_size head = atomic_load_explicit(&ring->header->head, memory_order_relaxed);
+    const cds_size available = _spscAvailable(ring, head, max);
+    const cds_size popped = max < available ? max : available;
+    const cds_size first = (head & ring->mask) + popped > ring->mask + 1 ? ring->mask + 1 - (head & ring->mask) : popped;
+    memcpy(out, ring->data + (head & ring->mask)*ring->data_size, first*ring->data_size);
+    memcpy((cds_uchar*) out + first*ring->data_size, ring->data, (popped - first)*ring->data_size);
+    if (popped){
+        atomic_store_explicit(&ring->header->head, head + popped, memory_order_release);
+    }
+    return popped;
+}
+
+cds_bool spscTryPop(SPSCRing* const ring, void* const out){
+    return 1 == spscPopN(ring, out, 1);
+}
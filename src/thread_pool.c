@@ -0,0 +1,352 @@
+/*!
+ * @file thread_pool.c
+ * @copyright GNU General Public Licence 3 or Later (GPLv3).
+ * @author Paulo Arruda
+ * @brief Implementation of the thread pool.
+*/
+
+#include <stdint.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "../include/thread_pool.h"
+#include "../include/pool.h"
+#include "../include/ws_deque.h"
+#include "../include/_private_sync.h"
+
+/**
+ * Definition of the thread pool structure. Workers sleep on `wake` until the
+ * generation changes, run the tasks of the job and report to `done`.
+*/
+struct ThreadPool{
+    pthread_mutex_t run_lock;   // serializes the jobs
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    pthread_cond_t done;
+    pthread_t* workers;
+    cds_size num_workers;
+    cds_size generation;
+    cds_size active;            // workers still running the current job
+    cds_bool stop;
+    // current job
+    PoolTaskFun fun;
+    void* arg;
+    cds_size num_tasks;
+    atomic_size_t next;
+    // fork/join tasks, one deque per thread
+    WSDeque** deques;
+    cds_size num_deques;
+};
+
+/**
+ * A fork/join task is released by the thread that forked it, once `done` is
+ * set by the thread that ran it.
+*/
+struct ForkJoinTask{
+    ForkJoinFun fun;
+    void* arg;
+    atomic_bool done;
+};
+
+/**
+ * A fork/join computation runs as a job of one task per thread: the first one
+ * runs the root, the others steal until the root returns.
+*/
+typedef struct ForkJoinJob{
+    ThreadPool* pool;
+    ForkJoinFun fun;
+    void* arg;
+    atomic_bool done;
+}ForkJoinJob;
+
+/* Whether the thread is running a task, in which case nested jobs run inline. **/
+static _Thread_local cds_bool _in_task = false;
+
+/* The deque of the thread while it runs a fork/join computation, and its pool. **/
+static _Thread_local WSDeque* _fj_deque = (WSDeque*) NULL;
+static _Thread_local ThreadPool* _fj_pool = (ThreadPool*) NULL;
+
+/* The tasks forked by the thread are allocated from a pool of its own. **/
+static _Thread_local Pool* _fj_tasks = (Pool*) NULL;
+
+static void _runTasks(ThreadPool* const pool){
+    cds_size task;
+    while ((task = atomic_fetch_add(&pool->next, 1)) < pool->num_tasks){
+        pool->fun(pool->arg, task);
+    }
+}
+
+static void* _worker(void* arg){
+    ThreadPool* pool = (ThreadPool*) arg;
+    _in_task = true;
+    // jobs submitted before the worker started are not missed.
+    cds_size seen = 0;
+    (void) pthread_mutex_lock(&pool->lock);
+    for (;;){
+        while (!pool->stop && seen == pool->generation){
+            (void) pthread_cond_wait(&pool->wake, &pool->lock);
+        }
+        if (pool->stop){
+            break;
+        }
+        seen = pool->generation;
+        (void) pthread_mutex_unlock(&pool->lock);
+        _runTasks(pool);
+        (void) pthread_mutex_lock(&pool->lock);
+        if (0 == --pool->active){
+            (void) pthread_cond_signal(&pool->done);
+        }
+    }
+    (void) pthread_mutex_unlock(&pool->lock);
+    poolDelete(_fj_tasks);
+    return NULL;
+}
+
+/**
+ * Stops and joins the first `num_workers` workers.
+*/
+static void _stopWorkers(ThreadPool* const pool, const cds_size num_workers){
+    (void) pthread_mutex_lock(&pool->lock);
+    pool->stop = true;
+    (void) pthread_cond_broadcast(&pool->wake);
+    (void) pthread_mutex_unlock(&pool->lock);
+    for (cds_size i=0; i<num_workers; i++){
+        (void) pthread_join(pool->workers[i], NULL);
+    }
+}
+
+ThreadPool* tpoolCreate(const cds_size num_threads){
+    const cds_size threads = num_threads ? num_threads : _numThreads();
+    ThreadPool* pool = (ThreadPool*) malloc(sizeof(ThreadPool));
+    if (!pool){
+        return (ThreadPool*) NULL;
+    }
+    pool->num_workers = threads - 1;
+    pool->workers = (pthread_t*) malloc((pool->num_workers ? pool->num_workers : 1) * sizeof(pthread_t));
+    if (!pool->workers){
+        free(pool);
+        return (ThreadPool*) NULL;
+    }
+    (void) pthread_mutex_init(&pool->run_lock, NULL);
+    (void) pthread_mutex_init(&pool->lock, NULL);
+    (void) pthread_cond_init(&pool->wake, NULL);
+    (void) pthread_cond_init(&pool->done, NULL);
+    pool->generation = 0;
+    pool->active = 0;
+    pool->stop = false;
+    pool->fun = (PoolTaskFun) NULL;
+    pool->arg = NULL;
+    pool->num_tasks = 0;
+    atomic_init(&pool->next, 0);
+    pool->num_deques = threads;
+    pool->deques = (WSDeque**) calloc(threads, sizeof(WSDeque*));
+    for (cds_size i=0; pool->deques && i<threads; i++){
+        if (!(pool->deques[i] = wsdequeCreate(0))){
+            pool->num_workers = 0;
+            tpoolDelete(pool);
+            return (ThreadPool*) NULL;
+        }
+    }
+    if (!pool->deques){
+        pool->num_workers = 0;
+        tpoolDelete(pool);
+        return (ThreadPool*) NULL;
+    }
+    for (cds_size i=0; i<pool->num_workers; i++){
+        if (0 != pthread_create(&pool->workers[i], NULL, _worker, pool)){
+            _stopWorkers(pool, i);
+            pool->num_workers = 0;
+            tpoolDelete(pool);
+            return (ThreadPool*) NULL;
+        }
+    }
+    return pool;
+}
+
+void tpoolDelete(ThreadPool* pool){
+    if (!pool){
+        return;
+    }
+    if (!pool->stop){
+        _stopWorkers(pool, pool->num_workers);
+    }
+    (void) pthread_cond_destroy(&pool->done);
+    (void) pthread_cond_destroy(&pool->wake);
+    (void) pthread_mutex_destroy(&pool->lock);
+    (void) pthread_mutex_destroy(&pool->run_lock);
+    for (cds_size i=0; pool->deques && i<pool->num_deques; i++){
+        wsdequeDelete(pool->deques[i]);
+    }
+    free(pool->deques);
+    free(pool->workers);
+    free(pool);
+}
+
+static ThreadPool* _default_pool = (ThreadPool*) NULL;
+static pthread_once_t _default_once = PTHREAD_ONCE_INIT;
+
+static void _createDefaultPool(void){
+    _default_pool = tpoolCreate(0);
+}
+
+ThreadPool* tpoolDefault(void){
+    (void) pthread_once(&_default_once, _createDefaultPool);
+    return _default_pool;
+}
+
+cds_size tpoolNumThreads(const ThreadPool* const pool){
+    return pool ? pool->num_workers + 1 : 1;
+}
+
+void tpoolRun(ThreadPool* pool, const PoolTaskFun fun, void* arg, const cds_size num_tasks){
+    if (!fun || !num_tasks){
+        return;
+    }
+    if (!pool){
+        pool = tpoolDefault();
+    }
+    if (!pool || !pool->num_workers || 1 == num_tasks || _in_task){
+        for (cds_size task=0; task<num_tasks; task++){
+            fun(arg, task);
+        }
+        return;
+    }
+    (void) pthread_mutex_lock(&pool->run_lock);
+    (void) pthread_mutex_lock(&pool->lock);
+    pool->fun = fun;
+    pool->arg = arg;
+    pool->num_tasks = num_tasks;
+    atomic_store(&pool->next, 0);
+    pool->active = pool->num_workers;
+    pool->generation++;
+    (void) pthread_cond_broadcast(&pool->wake);
+    (void) pthread_mutex_unlock(&pool->lock);
+    // the calling thread works as well.
+    _in_task = true;
+    _runTasks(pool);
+    _in_task = false;
+    (void) pthread_mutex_lock(&pool->lock);
+    while (pool->active){
+        (void) pthread_cond_wait(&pool->done, &pool->lock);
+    }
+    (void) pthread_mutex_unlock(&pool->lock);
+    (void) pthread_mutex_unlock(&pool->run_lock);
+}
+
+/**
+ * FORK/JOIN
+ * ---------
+*/
+
+static void _fjRun(ForkJoinTask* const task){
+    task->fun(task->arg);
+    atomic_store_explicit(&task->done, true, memory_order_release);
+}
+
+static _Thread_local uint32_t _fj_seed = 0;
+
+/**
+ * Tries to steal a task from the deque of another thread, starting from a
+ * random victim, and runs it. Returns whether a task ran.
+*/
+static cds_bool _fjStealAndRun(ThreadPool* const pool){
+    uint32_t x = _fj_seed ? _fj_seed : (uint32_t) (uintptr_t) &_fj_seed | 1;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    _fj_seed = x;
+    for (cds_size i=0; i<pool->num_deques; i++){
+        WSDeque* victim = pool->deques[(x + i) % pool->num_deques];
+        ForkJoinTask* task;
+        if (victim != _fj_deque && (task = (ForkJoinTask*) wsdequeSteal(victim))){
+            _fjRun(task);
+            return true;
+        }
+    }
+    return false;
+}
+
+static void _forkJoinTask(void* arg, const cds_size index){
+    ForkJoinJob* job = (ForkJoinJob*) arg;
+    _fj_deque = job->pool->deques[index];
+    _fj_pool = job->pool;
+    if (!index){
+        job->fun(job->arg);
+        atomic_store_explicit(&job->done, true, memory_order_release);
+    }
+    else{
+        cds_size round = 0;
+        while (!atomic_load_explicit(&job->done, memory_order_acquire)){
+            if (_fjStealAndRun(job->pool)){
+                round = 0;
+            }
+            else{
+                _cdsBackoff(&round);
+            }
+        }
+    }
+    _fj_deque = (WSDeque*) NULL;
+    _fj_pool = (ThreadPool*) NULL;
+}
+
+void tpoolForkJoin(ThreadPool* pool, const ForkJoinFun fun, void* arg){
+    if (!fun){
+        return;
+    }
+    if (!pool){
+        pool = tpoolDefault();
+    }
+    // nested computations join the current one, or run inline within the tasks of `tpoolRun`.
+    if (!pool || !pool->num_workers || _fj_deque || _in_task){
+        fun(arg);
+        return;
+    }
+    ForkJoinJob job = {.pool = pool, .fun = fun, .arg = arg};
+    atomic_init(&job.done, false);
+    tpoolRun(pool, _forkJoinTask, &job, pool->num_deques);
+    // every task was joined, so the pool of the calling thread is empty.
+    poolDelete(_fj_tasks);
+    _fj_tasks = (Pool*) NULL;
+}
+
+ForkJoinTask* tpoolFork(const ForkJoinFun fun, void* arg){
+    if (!fun){
+        return (ForkJoinTask*) NULL;
+    }
+    if (_fj_deque && !_fj_tasks){
+        _fj_tasks = poolCreate(sizeof(ForkJoinTask), FORK_JOIN_TASKS_PER_SLAB);
+    }
+    ForkJoinTask* task = _fj_deque ? (ForkJoinTask*) poolAlloc(_fj_tasks) : (ForkJoinTask*) NULL;
+    if (task){
+        task->fun = fun;
+        task->arg = arg;
+        atomic_init(&task->done, false);
+        if (wsdequePush(_fj_deque, task)){
+            return task;
+        }
+        poolFree(_fj_tasks, task);
+    }
+    fun(arg);
+    return (ForkJoinTask*) NULL;
+}
+
+void tpoolJoin(ForkJoinTask* const task){
+    if (!task){
+        return;
+    }
+    cds_size round = 0;
+    while (!atomic_load_explicit(&task->done, memory_order_acquire)){
+        // the own deque holds the task unless it was stolen, and the tasks forked after it.
+        ForkJoinTask* other = (ForkJoinTask*) wsdequePop(_fj_deque);
+        if (other){
+            _fjRun(other);
+            round = 0;
+        }
+        else if (_fjStealAndRun(_fj_pool)){
+            round = 0;
+        }
+        else{
+            _cdsBackoff(&round);
+        }
+    }
+    poolFree(_fj_tasks, task);
+}
@@ -0,0 +1,234 @@
+/*!
+ * @file unrolled_list.c
+ * @copyright GNU General Public Licence 3 or Later (GPLv3).
+ * @author Paulo Arruda
+ * @brief Implementation of the unrolled linked list.
+*/
+
+#include <string.h>
+#include "../include/_private_linear.h"
+
+/**
+ * The nodes are allocated from a pool owned by the list, `ULL_NODES_PER_SLAB`
+ * nodes at a time.
+*/
+#define ULL_NODES_PER_SLAB 64
+#define ULL_ELEMENT(list, node, i) ((node)->data + (i)*(list)->data_size)
+
+UnrolledList* ullCreate(const cds_size data_size){
+    if (!data_size){
+        return (UnrolledList*) NULL;
+    }
+    UnrolledList* new_list = (UnrolledList*) malloc(sizeof(UnrolledList));
+    if (!new_list){
+        return (UnrolledList*) NULL;
+    }
+    cds_size node_capacity = (ULL_NODE_SIZE - sizeof(ULLNode)) / data_size;
+    new_list->node_capacity = node_capacity < ULL_MIN_NODE_CAPACITY ? ULL_MIN_NODE_CAPACITY : node_capacity;
+    new_list->pool = poolCreate(sizeof(ULLNode) + new_list->node_capacity*data_size, ULL_NODES_PER_SLAB);
+    if (!new_list->pool){
+        free(new_list);
+        return (UnrolledList*) NULL;
+    }
+    new_list->data_size = data_size;
+    new_list->length = 0;
+    new_list->head = (ULLNode*) NULL;
+    new_list->tail = (ULLNode*) NULL;
+    return new_list;
+}
+
+void ullDelete(UnrolledList* list){
+    if (!list){
+        return;
+    }
+    poolDelete(list->pool);
+    free(list);
+}
+
+cds_size ullLength(const UnrolledList* const list){
+    return list ? list->length : 0;
+}
+
+cds_size ullNodeCapacity(const UnrolledList* const list){
+    return list ? list->node_capacity : 0;
+}
+
+static ULLNode* _ullCreateNode(UnrolledList* const list, ULLNode* const next){
+    ULLNode* new_node = (ULLNode*) poolAlloc(list->pool);
+    if (!new_node){
+        return (ULLNode*) NULL;
+    }
+    new_node->next = next;
+    new_node->count = 0;
+    return new_node;
+}
+
+/**
+ * Finds the node holding the element at `*pindex`, which must be in range, and
+ * replaces `*pindex` by the position of the element in the node. The walk takes
+ * one step per node; `pprev`, if not `NULL`, receives the preceding node.
+*/
+static ULLNode* _ullLocate(const UnrolledList* const list, cds_size* const pindex, ULLNode** const pprev){
+    cds_size index = *pindex;
+    // elements of the last node are reached directly, unless the predecessor is needed.
+    if (!pprev && index >= list->length - list->tail->count){
+        *pindex = index - (list->length - list->tail->count);
+        return list->tail;
+    }
+    ULLNode* prev = (ULLNode*) NULL;
+    ULLNode* node = list->head;
+    while (index >= node->count){
+        index -= node->count;
+        prev = node;
+        node = node->next;
+    }
+    if (pprev){
+        *pprev = prev;
+    }
+    *pindex = index;
+    return node;
+}
+
+cds_bool ullAppend(UnrolledList* list, const void* data){
+    if (!list || !data){
+        return false;
+    }
+    if (!list->tail || list->node_capacity == list->tail->count){
+        ULLNode* new_tail = _ullCreateNode(list, (ULLNode*) NULL);
+        if (!new_tail){
+            return false;
+        }
+        if (list->tail){
+            list->tail->next = new_tail;
+        }
+        else{
+            list->head = new_tail;
+        }
+        list->tail = new_tail;
+    }
+    memcpy(ULL_ELEMENT(list, list->tail, list->tail->count), data, list->data_size);
+    list->tail->count++;
+    list->length++;
+    return true;
+}
+
+cds_bool ullPrepend(UnrolledList* list, const void* data){
+    if (!list || !data){
+        return false;
+    }
+    // a full head is not split: the element goes to a new head of its own.
+    if (!list->head || list->node_capacity == list->head->count){
+        ULLNode* new_head = _ullCreateNode(list, list->head);
+        if (!new_head){
+            return false;
+        }
+        if (!list->head){
+            list->tail = new_head;
+        }
+        list->head = new_head;
+    }
+    // the elements of a node start at its beginning, so they shift up by one.
+    ULLNode* head = list->head;
+    memmove(ULL_ELEMENT(list, head, 1), head->data, head->count*list->data_size);
+    memcpy(head->data, data, list->data_size);
+    head->count++;
+    list->length++;
+    return true;
+}
+
+cds_bool ullInsert(UnrolledList* list, const cds_size index, const void* data){
+    if (!list || !data || index > list->length){
+        return false;
+    }
+    if (index == list->length){
+        return ullAppend(list, data);
+    }
+    cds_size position = index;
+    ULLNode* node = _ullLocate(list, &position, (ULLNode**) NULL);
+    if (list->node_capacity == node->count){
+        // splits the node, moving its upper half to a new successor.
+        ULLNode* new_node = _ullCreateNode(list, node->next);
+        if (!new_node){
+            return false;
+        }
+        const cds_size half = list->node_capacity / 2;
+        new_node->count = node->count - half;
+        memcpy(new_node->data, ULL_ELEMENT(list, node, half), new_node->count*list->data_size);
+        node->count = half;
+        node->next = new_node;
+        if (list->tail == node){
+            list->tail = new_node;
+        }
+        if (position > half){
+            node = new_node;
+            position -= half;
+        }
+    }
+    memmove(ULL_ELEMENT(list, node, position + 1), ULL_ELEMENT(list, node, position),
+            (node->count - position)*list->data_size);
+    memcpy(ULL_ELEMENT(list, node, position), data, list->data_size);
+    node->count++;
+    list->length++;
+    return true;
+}
+
+cds_bool ullRemove(UnrolledList* list, const cds_size index, void* const out){
+    if (!list || index >= list->length){
+        return false;
+    }
+    cds_size position = index;
+    ULLNode* prev = (ULLNode*) NULL;
+    ULLNode* node = _ullLocate(list, &position, &prev);
+    if (out){
+        memcpy(out, ULL_ELEMENT(list, node, position), list->data_size);
+    }
+    node->count--;
+    memmove(ULL_ELEMENT(list, node, position), ULL_ELEMENT(list, node, position + 1),
+            (node->count - position)*list->data_size);
+    list->length--;
+    if (!node->count){
+        if (prev){
+            prev->next = node->next;
+        }
+        else{
+            list->head = node->next;
+        }
+        if (list->tail == node){
+            list->tail = prev;
+        }
+        poolFree(list->pool, node);
+        return true;
+    }
+    ULLNode* next = node->next;
+    if (!next || node->count >= list->node_capacity / 2){
+        return true;
+    }
+    if (node->count + next->count <= list->node_capacity){
+        // merges the successor into the node.
+        memcpy(ULL_ELEMENT(list, node, node->count), next->data, next->count*list->data_size);
+        node->count += next->count;
+        node->next = next->next;
+        if (list->tail == next){
+            list->tail = node;
+        }
+        poolFree(list->pool, next);
+    }
+    else{
+        // balances both nodes, which leaves them at least half full.
+        const cds_size moved = (next->count - node->count) / 2;
+        memcpy(ULL_ELEMENT(list, node, node->count), next->data, moved*list->data_size);
+        memmove(next->data, ULL_ELEMENT(list, next, moved), (next->count - moved)*list->data_size);
+        node->count += moved;
+        next->count -= moved;
+    }
+    return true;
+}
+
+void* ullGetAt(const UnrolledList* const list, const cds_size index){
+    if (!list || index >= list->length){
+        return NULL;
+    }
+    cds_size position = index;
+    ULLNode* node = _ullLocate(list, &position, (ULLNode**) NULL);
+    return ULL_ELEMENT(list, node, position);
+}
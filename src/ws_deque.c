@@ -0,0 +1,175 @@
+/*!
+ * @file ws_deque.c
+ * @copyright GNU General Public Licence 3 or Later (GPLv3).
+ * @author Paulo Arruda
+ * @brief Implementation of the work-stealing deque.
+*/
+
+#include <stdint.h>
+#include <stdatomic.h>
+#include "../include/ws_deque.h"
+#include "../include/_private_memory.h"
+
+/**
+ * Ring of `mask + 1` pointers. The slots are atomic because a thief may read a
+ * slot that the owner rewrites after another thief took it; the thief then
+ * fails its compare-and-swap and drops the value.
+*/
+typedef struct WSBuffer{
+    cds_size mask;
+    struct WSBuffer* retired;   // the buffer it replaced
+    _Atomic(void*) items[];
+}WSBuffer;
+
+/**
+ * `top` is written by the thieves and `bottom` by the owner, so each one has a
+ * cache line of its own. The positions only grow (and are compared as signed
+ * differences), so `bottom - top` is the length.
+*/
+struct WSDeque{
+    _Alignas(CDS_CACHE_LINE) atomic_size_t top;
+    _Alignas(CDS_CACHE_LINE) atomic_size_t bottom;
+    _Alignas(CDS_CACHE_LINE) _Atomic(WSBuffer*) buffer;
+};
+
+static const AllocOptions _wsdeque_options = {CDS_CACHE_LINE, HUGE_PAGES_NONE};
+
+#define SLOT(buffer, position) (&(buffer)->items[(position) & (buffer)->mask])
+
+static WSBuffer* _wsbufferCreate(const cds_size size){
+    if (((cds_size) -1 - sizeof(WSBuffer)) / sizeof(void*) < size){
+        return (WSBuffer*) NULL;
+    }
+    WSBuffer* buffer = (WSBuffer*) malloc(sizeof(WSBuffer) + size*sizeof(void*));
+    if (buffer){
+        buffer->mask = size - 1;
+        buffer->retired = (WSBuffer*) NULL;
+    }
+    return buffer;
+}
+
+WSDeque* wsdequeCreate(const cds_size capacity){
+    const cds_size initial = capacity ? capacity : WSDEQUE_DEFAULT_CAPACITY;
+    const cds_size pow = initial > 2 ? _log2(initial - 1) + 1 : 1;
+    if (pow >= _MAX_POW2_){
+        return (WSDeque*) NULL;
+    }
+    WSDeque* deque = (WSDeque*) _cdsAlloc(sizeof(WSDeque), &_wsdeque_options);
+    if (!deque){
+        return (WSDeque*) NULL;
+    }
+    WSBuffer* buffer = _wsbufferCreate((cds_size) 1 << pow);
+    if (!buffer){
+        _cdsFree(deque, sizeof(WSDeque), &_wsdeque_options);
+        return (WSDeque*) NULL;
+    }
+    atomic_init(&deque->top, 0);
+    atomic_init(&deque->bottom, 0);
+    atomic_init(&deque->buffer, buffer);
+    return deque;
+}
+
+void wsdequeDelete(WSDeque* deque){
+    if (!deque){
+        return;
+    }
+    WSBuffer* buffer = atomic_load_explicit(&deque->buffer, memory_order_relaxed);
+    while (buffer){
+        WSBuffer* retired = buffer->retired;
+        free(buffer);
+        buffer = retired;
+    }
+    _cdsFree(deque, sizeof(WSDeque), &_wsdeque_options);
+}
+
+cds_size wsdequeLength(const WSDeque* const deque){
+    if (!deque){
+        return 0;
+    }
+    WSDeque* _deque = (WSDeque*) deque;
+    const cds_size top = atomic_load_explicit(&_deque->top, memory_order_relaxed);
+    const cds_size bottom = atomic_load_explicit(&_deque->bottom, memory_order_relaxed);
+    return (intptr_t) (bottom - top) > 0 ? bottom - top : 0;
+}
+
+/**
+ * Doubles the buffer, copying the elements in `[top, bottom)`.
+*/
+static WSBuffer* _wsdequeGrow(WSDeque* const deque, WSBuffer* const buffer, const cds_size top,
+                              const cds_size bottom){
+    if (buffer->mask + 1 > (cds_size) -1 / 2){
+        return (WSBuffer*) NULL;
+    }
+    WSBuffer* grown = _wsbufferCreate(2*(buffer->mask + 1));
+    if (!grown){
+        return (WSBuffer*) NULL;
+    }
+    for (cds_size i=top; i!=bottom; i++){
+        atomic_store_explicit(SLOT(grown, i), atomic_load_explicit(SLOT(buffer, i), memory_order_relaxed),
+                              memory_order_relaxed);
+    }
+    grown->retired = buffer;
+    atomic_store_explicit(&deque->buffer, grown, memory_order_release);
+    return grown;
+}
+
+cds_bool wsdequePush(WSDeque* const deque, void* const item){
+    if (!deque || !item){
+        return false;
+    }
+    const cds_size bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+    const cds_size top = atomic_load_explicit(&deque->top, memory_order_acquire);
+    WSBuffer* buffer = atomic_load_explicit(&deque->buffer, memory_order_relaxed);
+    if (bottom - top > buffer->mask && !(buffer = _wsdequeGrow(deque, buffer, top, bottom))){
+        return false;
+    }
+    atomic_store_explicit(SLOT(buffer, bottom), item, memory_order_relaxed);
+    // publishes the element (and what it points to) to the thieves.
+    atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_release);
+    return true;
+}
+
+void* wsdequePop(WSDeque* const deque){
+    if (!deque){
+        return NULL;
+    }
+    const cds_size bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed) - 1;
+    WSBuffer* buffer = atomic_load_explicit(&deque->buffer, memory_order_relaxed);
+    atomic_store_explicit(&deque->bottom, bottom, memory_order_relaxed);
+    // the thieves must see the reservation before the owner reads the top.
+    atomic_thread_fence(memory_order_seq_cst);
+    cds_size top = atomic_load_explicit(&deque->top, memory_order_relaxed);
+    if ((intptr_t) (bottom - top) < 0){
+        atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+        return NULL;
+    }
+    void* item = atomic_load_explicit(SLOT(buffer, bottom), memory_order_relaxed);
+    if (bottom == top){
+        // the last element goes to whoever moves the top first.
+        if (!atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1, memory_order_seq_cst,
+                                                     memory_order_relaxed)){
+            item = NULL;
+        }
+        atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+    }
+    return item;
+}
+
+void* wsdequeSteal(WSDeque* const deque){
+    if (!deque){
+        return NULL;
+    }
+    cds_size top = atomic_load_explicit(&deque->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    const cds_size bottom = atomic_load_explicit(&deque->bottom, memory_order_acquire);
+    if ((intptr_t) (bottom - top) <= 0){
+        return NULL;
+    }
+    WSBuffer* buffer = atomic_load_explicit(&deque->buffer, memory_order_acquire);
+    void* item = atomic_load_explicit(SLOT(buffer, top), memory_order_relaxed);
+    if (!atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1, memory_order_seq_cst,
+                                                 memory_order_relaxed)){
+        return NULL;
+    }
+    return item;
+}
@@ -0,0 +1,76 @@
+/*!
+ * @file test_arena.c
+ * @author Paulo Arruda
+ * @copyright GPL v3 or later.
+ * @brief Testing the arena allocator and the tuples allocated from it.
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <criterion/criterion.h>
+#include "../include/arena.h"
+#include "../include/linear.h"
+
+#define BLOCK_SIZE 256
+#define NUM_TUPLES 1000
+
+Arena* arena = (Arena*) NULL;
+
+void arenaSetup(void){
+    arena = arenaCreate(BLOCK_SIZE);
+    cr_assert(arena, "arenaCreate should return a not NULL arena");
+}
+
+void arenaTeardown(void){
+    arenaDelete(arena);
+    arena = (Arena*) NULL;
+}
+
+TestSuite(arena, .init=arenaSetup, .fini=arenaTeardown);
+
+Test(arena, arena_alloc){
+    cr_expect(!arenaCreate(0));
+    cr_expect(!arenaCreate((cds_size) -1 - 8), "The rounded block size overflows.");
+    cr_expect(!arenaAlloc(arena, (cds_size) -1 - 32), "The block header overflows.");
+    cr_expect(0 == arenaUsed(arena));
+    for (cds_size i=1; i<100; i++){
+        cds_uchar* ptr = (cds_uchar*) arenaAlloc(arena, i);
+        cr_assert(ptr);
+        cr_expect(0 == (uintptr_t) ptr % _Alignof(max_align_t));
+        (void) memset(ptr, 0xAB, i);
+    }
+    cds_uchar* large = (cds_uchar*) arenaAlloc(arena, 16*BLOCK_SIZE);
+    cr_assert(large, "Oversized allocations should get a block of their own.");
+    (void) memset(large, 0, 16*BLOCK_SIZE);
+    cr_expect(arenaUsed(arena) >= 16*BLOCK_SIZE);
+    arenaReset(arena);
+    cr_expect(0 == arenaUsed(arena));
+    cr_expect(arenaAlloc(arena, 8));
+}
+
+Test(arena, arena_tuples){
+    Tuple* tuples[NUM_TUPLES];
+    for (cds_intkey i=0; i<NUM_TUPLES; i++){
+        const cds_intkey key[2] = {i, -i};
+        tuples[i] = tupleCreateInArena(arena, key, sizeof(cds_intkey), 2);
+        cr_assert(tuples[i]);
+    }
+    for (cds_intkey i=0; i<NUM_TUPLES; i++){
+        cr_expect(2 == tupleLength(tuples[i]));
+        cr_expect(i == *(const cds_intkey*) tupleGetAt(tuples[i], 0));
+        cr_expect(-i == *(const cds_intkey*) tupleGetAt(tuples[i], 1));
+    }
+    HashTable* ht = htCreate(fnv1aHash, 2*NUM_TUPLES, INT_TUPLE_KEY);
+    cr_assert(ht);
+    for (cds_size i=0; i<NUM_TUPLES; i++){
+        cr_assert(htSet(ht, tuples[i], sizeof(Tuple*), &tuples[i], sizeof(Tuple*)));
+    }
+    const cds_intkey probe[2] = {42, -42};
+    Tuple* key = tupleFromArray(probe, sizeof(cds_intkey), 2);
+    cr_expect(htSearch(ht, key), "Tuples from arenas should work as composite keys.");
+    tupleDelete(key);
+    htDelete(ht);
+    tupleDelete(tuples[0]);
+    cr_expect(0 == *(const cds_intkey*) tupleGetAt(tuples[0], 0), "tupleDelete should not release arena tuples.");
+    cr_expect(!tupleCreateInArena((Arena*) NULL, probe, sizeof(cds_intkey), 2));
+}
@@ -0,0 +1,157 @@
+/*!
+ * @file test_bitset.c
+ * @author Paulo Arruda
+ * @copyright GPL v3 or later.
+ * @brief Testing the bitset API.
+*/
+
+#include <time.h>
+#include <criterion/criterion.h>
+#include "../include/bitset.h"
+
+#define LENGTH 100003
+
+Bitset* bs = (Bitset*) NULL;
+cds_bool* reference = (cds_bool*) NULL;
+
+void bitsetSetup(void){
+    bs = bitsetCreate(LENGTH);
+    cr_assert(bs, "bitsetCreate should return a not NULL bitset");
+    reference = (cds_bool*) calloc(LENGTH, sizeof(cds_bool));
+    srand(time(0));
+    for (cds_size i=0; i<LENGTH; i++){
+        if (rand() % 3 == 0){
+            reference[i] = true;
+            cr_assert(bitsetSet(bs, i));
+        }
+    }
+}
+
+void bitsetTeardown(void){
+    bitsetDelete(bs);
+    bs = (Bitset*) NULL;
+    free(reference);
+    reference = (cds_bool*) NULL;
+}
+
+TestSuite(bitset, .init=bitsetSetup, .fini=bitsetTeardown);
+
+Test(bitset, single_bits){
+    cr_expect(LENGTH == bitsetLength(bs));
+    cr_expect(LENGTH <= bitsetCapacity(bs));
+    cds_size count = 0;
+    for (cds_size i=0; i<LENGTH; i++){
+        cr_assert(reference[i] == bitsetTest(bs, i));
+        count += reference[i];
+    }
+    cr_expect(count == bitsetCount(bs));
+    cr_expect(!bitsetSet(bs, LENGTH) && !bitsetTest(bs, LENGTH), "Out of range bits should be rejected.");
+    cr_assert(bitsetClear(bs, 7) && !bitsetTest(bs, 7));
+    cr_assert(bitsetFlip(bs, 7) && bitsetTest(bs, 7));
+    cr_assert(bitsetFlip(bs, 7) && !bitsetTest(bs, 7));
+    bitsetSetAll(bs);
+    cr_expect(LENGTH == bitsetCount(bs), "Setting all bits should not touch the bits after the length.");
+    bitsetClearAll(bs);
+    cr_expect(0 == bitsetCount(bs) && CDS_NOT_FOUND == bitsetNextSet(bs, 0));
+}
+
+Test(bitset, rank_select_next){
+    cds_size rank = 0;
+    for (cds_size i=0; i<LENGTH; i++){
+        cr_assert(rank == bitsetRank(bs, i));
+        if (reference[i]){
+            cr_assert(i == bitsetSelect(bs, rank));
+            rank++;
+        }
+    }
+    cr_expect(rank == bitsetRank(bs, LENGTH));
+    cr_expect(CDS_NOT_FOUND == bitsetSelect(bs, rank));
+    cds_size visited = 0;
+    cds_size previous = 0;
+    for (cds_size i=bitsetNextSet(bs, 0); i!=CDS_NOT_FOUND; i=bitsetNextSet(bs, i + 1)){
+        cr_assert(reference[i]);
+        for (cds_size j=(visited ? previous + 1 : 0); j<i; j++){
+            cr_assert(!reference[j]);
+        }
+        previous = i;
+        visited++;
+    }
+    cr_expect(rank == visited);
+    for (cds_size i=0; i<LENGTH; i+=97){
+        cds_size next = bitsetNextClear(bs, i);
+        cr_assert(next < LENGTH && !reference[next]);
+        for (cds_size j=i; j<next; j++){
+            cr_assert(reference[j]);
+        }
+    }
+    bitsetSetAll(bs);
+    cr_expect(CDS_NOT_FOUND == bitsetNextClear(bs, 0), "Bits after the length should not be found.");
+}
+
+Test(bitset, bulk_operations){
+    Bitset* other = bitsetCreate(LENGTH);
+    cds_bool* other_reference = (cds_bool*) calloc(LENGTH, sizeof(cds_bool));
+    for (cds_size i=0; i<LENGTH; i++){
+        if (rand() % 2){
+            other_reference[i] = true;
+            cr_assert(bitsetSet(other, i));
+        }
+    }
+    Bitset* results[4] = {bitsetCopy(bs), bitsetCopy(bs), bitsetCopy(bs), bitsetCopy(bs)};
+    cr_assert(bitsetAnd(results[0], other) && bitsetOr(results[1], other));
+    cr_assert(bitsetXor(results[2], other) && bitsetAndNot(results[3], other));
+    for (cds_size i=0; i<LENGTH; i++){
+        cds_bool a = reference[i], b = other_reference[i];
+        cr_assert((a && b) == bitsetTest(results[0], i));
+        cr_assert((a || b) == bitsetTest(results[1], i));
+        cr_assert((a != b) == bitsetTest(results[2], i));
+        cr_assert((a && !b) == bitsetTest(results[3], i));
+    }
+    cds_size count = bitsetCount(bs);
+    bitsetNot(bs);
+    cr_expect(LENGTH - count == bitsetCount(bs));
+    Bitset* shorter = bitsetCreate(LENGTH - 1);
+    cr_expect(!bitsetAnd(bs, shorter), "Bitsets of different lengths should be rejected.");
+    bitsetDelete(shorter);
+    for (cds_size k=0; k<4; k++){
+        bitsetDelete(results[k]);
+    }
+    bitsetDelete(other);
+    free(other_reference);
+}
+
+Test(bitset, resizing_and_conversions){
+    Bitset* grown = bitsetCreate(0);
+    cr_assert(grown);
+    for (cds_size i=0; i<LENGTH; i++){
+        cr_assert(bitsetAppend(grown, reference[i]));
+    }
+    cr_expect(LENGTH == bitsetLength(grown));
+    cr_expect(bitsetCount(bs) == bitsetCount(grown));
+    cr_assert(bitsetResize(grown, 70));
+    cds_size count = 0;
+    for (cds_size i=0; i<70; i++){
+        count += reference[i];
+    }
+    cr_expect(count == bitsetCount(grown), "Shrinking should drop the bits after the length.");
+    cr_assert(bitsetResize(grown, 1000));
+    cr_expect(count == bitsetCount(grown), "Growing should add cleared bits.");
+    bitsetDelete(grown);
+
+    Vector* bools = vectorFromArray(reference, sizeof(cds_bool), LENGTH);
+    Bitset* converted = bitsetFromVector(bools);
+    cr_assert(converted);
+    Bitset* diff = bitsetCopy(converted);
+    cr_assert(bitsetXor(diff, bs));
+    cr_expect(0 == bitsetCount(diff));
+    Vector* indices = vectorCreate(1, sizeof(cds_size));
+    cr_expect(bitsetCount(bs) == bitsetToIndices(bs, indices));
+    for (cds_size i=0; i<vectorLength(indices); i++){
+        cr_assert(i == bitsetRank(bs, *(const cds_size*) vectorGetAt(indices, i)));
+    }
+    cr_expect(CDS_NOT_FOUND == bitsetToIndices(bs, bools));
+    vectorDelete(indices);
+    vectorDelete(bools);
+    bitsetDelete(diff);
+    bitsetDelete(converted);
+}
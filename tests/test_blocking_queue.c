@@ -0,0 +1,142 @@
+/*!
+ * @file test_blocking_queue.c
+ * @author Paulo Arruda
+ * @copyright GPL v3 or later.
+ * @brief Testing the blocking queue.
+*/
+
+#include <pthread.h>
+#include <criterion/criterion.h>
+#include "../include/blocking_queue.h"
+
+#define NUM_PRODUCERS 4
+#define NUM_CONSUMERS 4
+#define MESSAGES 100000
+#define BATCH 64
+
+Test(blocking_queue, bounded){
+    cr_expect(!bqueueCreate(8, 0));
+    BlockingQueue* queue = bqueueCreate(100, sizeof(cds_int));
+    cr_assert(queue);
+    cr_expect(100 == bqueueCapacity(queue));
+    cds_int value, batch[BATCH];
+    cr_expect(!bqueuePop(queue, &value, 0));
+    cr_expect(!bqueuePop(queue, &value, 10), "The pop should time out.");
+    for (cds_int i=0; i<100; i++){
+        cr_assert(bqueuePush(queue, &i, 0));
+    }
+    cr_expect(!bqueuePush(queue, &value, 0), "The queue should be full.");
+    cr_expect(!bqueuePush(queue, &value, 10), "The push should time out.");
+    cr_expect(100 == bqueueLength(queue));
+    // the batches wrap around the end of the buffer.
+    cds_int expected = 0;
+    for (cds_int round=0; round<10; round++){
+        cds_size n = bqueuePopBatch(queue, batch, BATCH, 0);
+        cr_assert(BATCH == n);
+        for (cds_size i=0; i<n; i++){
+            cr_assert(expected++ == batch[i]);
+        }
+        for (cds_size i=0; i<n; i++){
+            batch[i] = expected + 100 - BATCH + (cds_int) i;
+        }
+        cr_assert(n == bqueuePushN(queue, batch, n, 0));
+    }
+    cr_expect(100 == bqueuePopBatch(queue, (cds_int[200]){0}, 200, 0));
+    cr_expect(0 == bqueueLength(queue));
+    bqueueDelete(queue);
+}
+
+Test(blocking_queue, unbounded){
+    BlockingQueue* queue = bqueueCreate(0, sizeof(cds_int));
+    cr_assert(queue);
+    cr_expect(0 == bqueueCapacity(queue));
+    cds_int value;
+    // grow while the elements wrap around.
+    for (cds_int i=0; i<BQUEUE_DEFAULT_CAPACITY/2; i++){
+        cr_assert(bqueuePush(queue, &i, 0));
+        cr_assert(bqueuePop(queue, &value, 0));
+    }
+    for (cds_int i=0; i<10000; i++){
+        cr_assert(bqueuePush(queue, &i, 0));
+    }
+    cr_expect(10000 == bqueueLength(queue));
+    for (cds_int i=0; i<10000; i++){
+        cr_assert(bqueuePop(queue, &value, 0));
+        cr_assert(i == value);
+    }
+    bqueueClose(queue);
+    cr_expect(bqueueIsClosed(queue));
+    cr_expect(!bqueuePush(queue, &value, 0));
+    cr_expect(!bqueuePop(queue, &value, BQUEUE_FOREVER), "A closed empty queue should not wait.");
+    bqueueDelete(queue);
+}
+
+typedef struct {
+    BlockingQueue* queue;
+    cds_int first;
+} Producer;
+
+static void* produce(void* arg){
+    Producer* producer = (Producer*) arg;
+    for (cds_int i=0; i<MESSAGES; i++){
+        cds_int value = producer->first + i;
+        if (!bqueuePush(producer->queue, &value, BQUEUE_FOREVER)){
+            return (void*) 1;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Consumers sleep on the empty queue and wake to take whole batches, until the
+ * queue is closed and drained.
+*/
+static void* consume(void* arg){
+    BlockingQueue* queue = (BlockingQueue*) arg;
+    cds_long* sum = (cds_long*) calloc(1, sizeof(cds_long));
+    cds_int batch[BATCH];
+    for (cds_size n; (n = bqueuePopBatch(queue, batch, BATCH, BQUEUE_FOREVER)); ){
+        for (cds_size i=0; i<n; i++){
+            *sum += batch[i];
+        }
+    }
+    return sum;
+}
+
+static void producersConsumers(const cds_size capacity){
+    BlockingQueue* queue = bqueueCreate(capacity, sizeof(cds_int));
+    cr_assert(queue);
+    pthread_t producers[NUM_PRODUCERS], consumers[NUM_CONSUMERS];
+    Producer jobs[NUM_PRODUCERS];
+    for (cds_size i=0; i<NUM_CONSUMERS; i++){
+        cr_assert(0 == pthread_create(&consumers[i], NULL, consume, queue));
+    }
+    for (cds_size i=0; i<NUM_PRODUCERS; i++){
+        jobs[i] = (Producer){queue, (cds_int) i*MESSAGES};
+        cr_assert(0 == pthread_create(&producers[i], NULL, produce, &jobs[i]));
+    }
+    for (cds_size i=0; i<NUM_PRODUCERS; i++){
+        void* failed;
+        (void) pthread_join(producers[i], &failed);
+        cr_expect(!failed);
+    }
+    bqueueClose(queue);
+    cds_long sum = 0;
+    for (cds_size i=0; i<NUM_CONSUMERS; i++){
+        void* partial;
+        (void) pthread_join(consumers[i], &partial);
+        sum += *(cds_long*) partial;
+        free(partial);
+    }
+    const cds_long total = (cds_long) NUM_PRODUCERS*MESSAGES;
+    cr_expect(total*(total - 1)/2 == sum, "Every message should be consumed exactly once.");
+    bqueueDelete(queue);
+}
+
+Test(blocking_queue, bounded_threads){
+    producersConsumers(16);
+}
+
+Test(blocking_queue, unbounded_threads){
+    producersConsumers(0);
+}
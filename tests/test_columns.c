@@ -0,0 +1,124 @@
+/*!
+ * @file test_columns.c
+ * @author Paulo Arruda
+ * @copyright GPL v3 or later.
+ * @brief Testing the columns API.
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <criterion/criterion.h>
+#include "../include/columns.h"
+#include "../include/kernels.h"
+
+#define LENGTH 10000
+
+typedef struct Row{
+    cds_char tag;
+    cds_double price;
+    cds_int32 quantity;
+    cds_char name[13];
+}Row;
+
+static const cds_size sizes[] = {sizeof(cds_char), sizeof(cds_double), sizeof(cds_int32), 13};
+static const cds_size offsets[] = {offsetof(Row, tag), offsetof(Row, price), offsetof(Row, quantity),
+                                   offsetof(Row, name)};
+
+Columns* cols = (Columns*) NULL;
+
+static Row makeRow(const cds_size i){
+    Row row = {(cds_char) ('a' + i % 26), 0.25*(cds_double) i, (cds_int32) i - 5000, {0}};
+    (void) snprintf(row.name, sizeof(row.name), "row%zu", i);
+    return row;
+}
+
+void columnsSetup(void){
+    cols = columnsCreate(16, 4, sizes);
+    cr_assert(cols, "columnsCreate should return a not NULL container");
+}
+
+void columnsTeardown(void){
+    columnsDelete(cols);
+    cols = (Columns*) NULL;
+}
+
+TestSuite(columns, .init=columnsSetup, .fini=columnsTeardown);
+
+Test(columns, append_and_get_rows){
+    cr_expect(4 == columnsNumColumns(cols));
+    cr_expect(0 == columnsLength(cols));
+    Row* records = (Row*) malloc(LENGTH*sizeof(Row));
+    for (cds_size i=0; i<LENGTH; i++){
+        records[i] = makeRow(i);
+    }
+    cr_assert(columnsAppendRecords(cols, records, LENGTH/2, sizeof(Row), offsets));
+    for (cds_size i=LENGTH/2; i<LENGTH; i++){
+        cr_assert(columnsAppendRow(cols, (const void*[]){&records[i].tag, &records[i].price,
+                                                         &records[i].quantity, records[i].name}));
+    }
+    cr_expect(LENGTH == columnsLength(cols));
+    for (cds_size c=0; c<4; c++){
+        cr_expect(0 == (uintptr_t) columnsData(cols, c) % CDS_CACHE_LINE, "Columns should be cache aligned.");
+        cr_expect(LENGTH == vectorLength(columnsColumn(cols, c)));
+    }
+    const cds_double* prices = COLUMN_DATA(cols, cds_double, 1);
+    for (cds_size i=0; i<LENGTH; i++){
+        Row row = {0};
+        cr_assert(columnsGetRow(cols, i, (void*[]){&row.tag, &row.price, &row.quantity, row.name}));
+        cr_assert(records[i].tag == row.tag && records[i].price == row.price);
+        cr_assert(records[i].quantity == row.quantity && !strcmp(records[i].name, row.name));
+        cr_assert(records[i].price == prices[i]);
+    }
+    cds_int32 quantity = 0;
+    cr_expect(columnsGetRow(cols, 3, (void*[]){NULL, NULL, &quantity, NULL}) && -4997 == quantity);
+    cr_expect(!columnsGetRow(cols, LENGTH, (void*[]){NULL, NULL, NULL, NULL}));
+    cr_expect(!columnsAppendRecords(cols, records, 1, offsetof(Row, name), offsets),
+              "Fields exceeding the record should be rejected.");
+    cr_expect(LENGTH == columnsLength(cols));
+    cr_expect(!columnsColumn(cols, 4) && !columnsData(cols, 4));
+    free(records);
+}
+
+Test(columns, kernels_on_columns){
+    for (cds_size i=0; i<LENGTH; i++){
+        Row row = makeRow(i);
+        cr_assert(columnsAppendRecords(cols, &row, 1, sizeof(Row), offsets));
+    }
+    cds_int64 sum = 0;
+    cr_assert(vectorSum(columnsColumn(cols, 2), NUM_INT32, &sum));
+    cr_expect((cds_int64) LENGTH*(LENGTH - 1)/2 - 5000*(cds_int64) LENGTH == sum);
+    VectorSlice slice = columnsSlice(cols, 1, 100, 10);
+    cr_expect(10 == slice.length && 25.0 == *(cds_double*) vectorSliceGetAt(&slice, 0));
+}
+
+Test(columns, gather){
+    for (cds_size i=0; i<LENGTH; i++){
+        Row row = makeRow(i);
+        cr_assert(columnsAppendRecords(cols, &row, 1, sizeof(Row), offsets));
+    }
+    Vector* indices = vectorCreate(LENGTH, sizeof(cds_size));
+    for (cds_size i=0; i<LENGTH; i+=3){
+        cds_size index = LENGTH - 1 - i;
+        cr_assert(vectorPrepend(indices, &index) && vectorPrepend(indices, &index));
+    }
+    Columns* gathered = columnsGather(cols, indices);
+    cr_assert(gathered);
+    cr_expect(vectorLength(indices) == columnsLength(gathered));
+    for (cds_size i=0; i<columnsLength(gathered); i++){
+        Row expected = makeRow(*(const cds_size*) vectorGetAt(indices, i));
+        Row row = {0};
+        cr_assert(columnsGetRow(gathered, i, (void*[]){&row.tag, &row.price, &row.quantity, row.name}));
+        cr_assert(expected.tag == row.tag && expected.price == row.price);
+        cr_assert(expected.quantity == row.quantity && !strcmp(expected.name, row.name));
+    }
+    columnsDelete(gathered);
+    cds_size out_of_range = LENGTH;
+    cr_assert(vectorPrepend(indices, &out_of_range));
+    cr_expect(!columnsGather(cols, indices));
+    vectorDelete(indices);
+    Vector* empty = vectorCreate(1, sizeof(cds_size));
+    gathered = columnsGather(cols, empty);
+    cr_expect(gathered && 0 == columnsLength(gathered));
+    columnsDelete(gathered);
+    vectorDelete(empty);
+}
@@ -0,0 +1,105 @@
+/*!
+ * @file test_concurrent_stack.c
+ * @author Paulo Arruda
+ * @copyright GPL v3 or later.
+ * @brief Testing the lock-free stack.
+*/
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <criterion/criterion.h>
+#include "../include/concurrent_stack.h"
+
+#define NUM_THREADS 8
+#define NUM_BUFFERS 16
+#define ROUNDS 100000
+
+Test(concurrent_stack, single_thread){
+    cr_expect(!cstackCreate(0, sizeof(cds_int)));
+    cr_expect(!cstackCreate(8, 0));
+    ConcurrentStack* stack = cstackCreate(100, sizeof(cds_int));
+    cr_assert(stack);
+    cr_expect(100 == cstackCapacity(stack));
+    cr_expect(cstackIsEmpty(stack));
+    cds_int value;
+    cr_expect(!cstackPop(stack, &value));
+    for (cds_int i=0; i<100; i++){
+        cr_assert(cstackPush(stack, &i));
+    }
+    cr_expect(!cstackPush(stack, &value), "The stack should be full.");
+    for (cds_int i=99; i>=50; i--){
+        cr_assert(cstackPop(stack, &value));
+        cr_assert(i == value);
+    }
+    // the freed nodes go back to the pool.
+    for (cds_int i=0; i<50; i++){
+        cr_assert(cstackPush(stack, &(cds_int){-i}));
+    }
+    for (cds_int i=49; i>=0; i--){
+        cr_assert(cstackPop(stack, &value));
+        cr_assert(-i == value);
+    }
+    cr_expect(!cstackIsEmpty(stack));
+    cstackDelete(stack);
+}
+
+typedef struct {
+    ConcurrentStack* stack;
+    atomic_int* owners;     // one flag per buffer
+    atomic_size_t* errors;
+} Shared;
+
+/**
+ * The stack is a free list of buffer identifiers: a thread owns a buffer from
+ * the pop to the push, so any identifier popped twice (a lost ABA race) shows
+ * up as a buffer with two owners.
+*/
+static void* useBuffers(void* arg){
+    Shared* shared = (Shared*) arg;
+    cds_size ids[2];
+    for (cds_size i=0; i<ROUNDS; i++){
+        cds_size held = 0;
+        for (; held<2 && cstackPop(shared->stack, &ids[held]); held++){
+            if (0 != atomic_exchange(&shared->owners[ids[held]], 1)){
+                (void) atomic_fetch_add(shared->errors, 1);
+            }
+        }
+        while (held--){
+            atomic_store(&shared->owners[ids[held]], 0);
+            if (!cstackPush(shared->stack, &ids[held])){
+                (void) atomic_fetch_add(shared->errors, 1);
+            }
+        }
+    }
+    return NULL;
+}
+
+Test(concurrent_stack, free_list){
+    ConcurrentStack* stack = cstackCreate(NUM_BUFFERS, sizeof(cds_size));
+    cr_assert(stack);
+    atomic_int owners[NUM_BUFFERS];
+    for (cds_size i=0; i<NUM_BUFFERS; i++){
+        atomic_init(&owners[i], 0);
+        cr_assert(cstackPush(stack, &i));
+    }
+    atomic_size_t errors;
+    atomic_init(&errors, 0);
+    Shared shared = {stack, owners, &errors};
+    pthread_t threads[NUM_THREADS];
+    for (cds_size i=0; i<NUM_THREADS; i++){
+        cr_assert(0 == pthread_create(&threads[i], NULL, useBuffers, &shared));
+    }
+    for (cds_size i=0; i<NUM_THREADS; i++){
+        (void) pthread_join(threads[i], NULL);
+    }
+    cr_expect(0 == atomic_load(&errors), "No buffer should have two owners.");
+    // every buffer is back exactly once.
+    cds_size id, count = 0, sum = 0;
+    while (cstackPop(stack, &id)){
+        count++;
+        sum += id;
+    }
+    cr_expect(NUM_BUFFERS == count);
+    cr_expect(NUM_BUFFERS*(NUM_BUFFERS - 1)/2 == sum);
+    cstackDelete(stack);
+}
@@ -0,0 +1,143 @@
+/*!
+ * @file test_flat_map.c
+ * @author Paulo Arruda
+ * @copyright GPL v3 or later.
+ * @brief Testing the flat map and flat set API.
+*/
+
+#include <time.h>
+#include <criterion/criterion.h>
+#include "../include/flat_map.h"
+
+#define LENGTH 5000
+#define KEY_RANGE 2000
+
+static cds_int8 longOrderComp(const void* const x, const void* const y){
+    cds_long _x = *(const cds_long*) x;
+    cds_long _y = *(const cds_long*) y;
+    return (_x > _y) - (_x < _y);
+}
+
+TestSuite(flat_map);
+
+Test(flat_map, from_vectors_keeps_last_value){
+    Vector* keys = vectorCreate(LENGTH, sizeof(cds_long));
+    Vector* values = vectorCreate(LENGTH, sizeof(cds_int));
+    cds_int last[KEY_RANGE];
+    for (cds_int k=0; k<KEY_RANGE; k++){
+        last[k] = -1;
+    }
+    srand(time(0));
+    for (cds_int i=0; i<LENGTH; i++){
+        cds_long key = rand() % KEY_RANGE;
+        last[key] = i;
+        cr_assert(vectorPrepend(keys, &key) && vectorPrepend(values, &i));
+    }
+    FlatMap* map = flatmapFromVectors(keys, values, longOrderComp);
+    cr_assert(map);
+    cds_size length = 0;
+    for (cds_long k=0; k<KEY_RANGE; k++){
+        const cds_int* value = (const cds_int*) flatmapGet(map, &k);
+        if (last[k] < 0){
+            cr_assert(!value && !flatmapContains(map, &k));
+            continue;
+        }
+        cr_assert(value && last[k] == *value, "Duplicated keys should keep the last value.");
+        cr_assert(k == *(const cds_long*) flatmapKeyAt(map, length));
+        length++;
+    }
+    cr_expect(length == flatmapLength(map));
+    flatmapDelete(map);
+    Vector* empty = vectorCreate(1, sizeof(cds_int));
+    cr_expect(!flatmapFromVectors(keys, empty, longOrderComp), "The vectors should have the same length.");
+    map = flatmapFromVectors(empty, empty, intOrderComp);
+    cr_expect(map && 0 == flatmapLength(map));
+    flatmapDelete(map);
+    vectorDelete(empty);
+    vectorDelete(keys);
+    vectorDelete(values);
+}
+
+Test(flat_map, insert_update_remove){
+    FlatMap* map = flatmapCreate(sizeof(cds_long), sizeof(cds_double), longOrderComp);
+    cr_assert(map);
+    for (cds_long k=LENGTH - 1; k>=0; k--){
+        cr_assert(flatmapInsert(map, &(cds_long){2*k}, &(cds_double){0.5*(cds_double) k}));
+    }
+    cr_expect(LENGTH == flatmapLength(map));
+    cr_assert(flatmapInsert(map, &(cds_long){10}, &(cds_double){-1.0}));
+    cr_expect(LENGTH == flatmapLength(map), "Inserting a stored key should update its value.");
+    cr_expect(-1.0 == *(cds_double*) flatmapGet(map, &(cds_long){10}));
+    for (cds_long k=0; k<LENGTH; k+=2){
+        cr_assert(flatmapRemove(map, &(cds_long){2*k}));
+    }
+    cr_expect(!flatmapRemove(map, &(cds_long){0}));
+    cr_expect(!flatmapRemove(map, &(cds_long){1}));
+    cr_expect(LENGTH/2 == flatmapLength(map));
+    for (cds_size i=0; i<flatmapLength(map); i++){
+        cds_long key = *(const cds_long*) flatmapKeyAt(map, i);
+        cr_assert(4*(cds_long) i + 2 == key);
+        cds_double value = 10 == key ? -1.0 : 0.5*(cds_double) (key/2);
+        cr_assert(value == *(cds_double*) flatmapValueAt(map, i));
+    }
+    cr_expect(!flatmapKeyAt(map, flatmapLength(map)));
+    cr_assert(flatmapShrinkToFit(map));
+    flatmapDelete(map);
+}
+
+Test(flat_map, bounds_and_ranges){
+    FlatMap* map = flatmapCreate(sizeof(cds_long), sizeof(cds_long), longOrderComp);
+    cr_assert(map);
+    cr_expect(0 == flatmapLowerBound(map, &(cds_long){3}));
+    cr_expect(0 == flatmapRange(map, NULL, NULL, NULL, NULL));
+    // keys 0, 10, ..., 990.
+    for (cds_long k=0; k<100; k++){
+        cr_assert(flatmapInsert(map, &(cds_long){10*k}, &k));
+    }
+    cr_expect(0 == flatmapLowerBound(map, &(cds_long){-5}));
+    cr_expect(1 == flatmapLowerBound(map, &(cds_long){10}));
+    cr_expect(2 == flatmapUpperBound(map, &(cds_long){10}));
+    cr_expect(2 == flatmapLowerBound(map, &(cds_long){11}));
+    cr_expect(100 == flatmapLowerBound(map, &(cds_long){991}));
+    cr_expect(100 == flatmapUpperBound(map, &(cds_long){990}));
+    VectorSlice keys, values;
+    cds_size length = flatmapRange(map, &(cds_long){25}, &(cds_long){70}, &keys, &values);
+    cr_expect(4 == length && 4 == keys.length && 4 == values.length);
+    for (cds_size i=0; i<length; i++){
+        cr_expect(30 + 10*(cds_long) i == *(cds_long*) vectorSliceGetAt(&keys, i));
+        cr_expect(3 + (cds_long) i == *(cds_long*) vectorSliceGetAt(&values, i));
+    }
+    cr_expect(95 == flatmapRange(map, &(cds_long){50}, NULL, &keys, NULL));
+    cr_expect(5 == flatmapRange(map, NULL, &(cds_long){50}, NULL, NULL));
+    cr_expect(0 == flatmapRange(map, &(cds_long){70}, &(cds_long){25}, &keys, NULL));
+    cr_expect(0 == keys.length);
+    flatmapDelete(map);
+}
+
+Test(flat_map, flat_set){
+    Vector* keys = vectorCreate(LENGTH, sizeof(cds_int));
+    for (cds_int i=0; i<LENGTH; i++){
+        cds_int key = (i*7919) % 1000;
+        cr_assert(vectorPrepend(keys, &key));
+    }
+    FlatSet* set = flatsetFromVector(keys, intOrderComp);
+    cr_assert(set);
+    cr_expect(1000 == flatsetLength(set));
+    for (cds_int k=0; k<1000; k++){
+        cr_assert(flatsetContains(set, &k));
+        cr_assert(k == *(const cds_int*) flatsetKeyAt(set, (cds_size) k));
+    }
+    cr_expect(!flatsetContains(set, &(cds_int){1000}));
+    cr_assert(flatsetInsert(set, &(cds_int){-1}));
+    cr_assert(flatsetInsert(set, &(cds_int){-1}));
+    cr_expect(1001 == flatsetLength(set));
+    cr_expect(0 == flatsetLowerBound(set, &(cds_int){-1}));
+    cr_assert(flatsetRemove(set, &(cds_int){500}));
+    cr_expect(!flatsetContains(set, &(cds_int){500}));
+    VectorSlice range;
+    cr_expect(9 == flatsetRange(set, &(cds_int){495}, &(cds_int){505}, &range));
+    cr_expect(504 == *(cds_int*) vectorSliceGetAt(&range, 8));
+    cr_assert(flatsetShrinkToFit(set));
+    flatsetDelete(set);
+    vectorDelete(keys);
+}
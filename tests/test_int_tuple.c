@@ -40,3 +40,28 @@ Test(tuple_int, tuple_basics){
         cr_expect(i == *(cds_size*) data);
     }
 }
+
+Test(tuple_int, tuple_aligned){
+    cds_size arr[LENGTH];
+    for (cds_size i=0; i<LENGTH; i++){
+        arr[i] = i;
+    }
+    Tuple* aligned = tupleFromArrayWithOptions(arr, DATA_SIZE, LENGTH,
+                                               &(AllocOptions){32, HUGE_PAGES_EXPLICIT});
+    cr_assert(aligned);
+    cr_expect(0 == (uintptr_t) tupleGetAt(aligned, 0) % 32);
+    for (cds_size i=0; i<LENGTH; i++){
+        cr_assert(i == *(const cds_size*) tupleGetAt(aligned, i));
+    }
+    tupleDelete(aligned);
+    // the vector taking over the buffer keeps its alignment when it grows.
+    aligned = tupleFromArrayWithOptions(arr, DATA_SIZE, LENGTH, &(AllocOptions){128, HUGE_PAGES_NONE});
+    cr_assert(aligned);
+    Vector* vec = tupleIntoVector(aligned);
+    cr_assert(vec);
+    for (cds_size i=0; i<10*LENGTH; i++){
+        cr_assert(vectorPrepend(vec, &i));
+    }
+    cr_expect(0 == (uintptr_t) vectorGetAt(vec, 0) % 128);
+    vectorDelete(vec);
+}
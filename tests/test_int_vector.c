@@ -7,8 +7,12 @@
 
 #include <time.h>
 #include <string.h>
+#include <unistd.h>
 #include <criterion/criterion.h>
 #include "../include/linear.h"
+#include "../include/linear_inline.h"
+#include "../include/kernels.h"
+#include "../include/sort.h"
 
 /****************  INT VECTOR TESTS ***************/
 
@@ -112,6 +116,24 @@ Test(vector_int, pushing_with_expansion){
     }
 }
 
+/*
+ * Testing the release of the spare capacity.
+*/
+Test(vector_int, shrink_to_fit){
+    cr_assert(vectorShrinkToFit(v));
+    cr_expect(1 == vectorCapacity(v), "Empty vectors should keep a capacity of 1.");
+    for (cds_size i=0; i<100; i++){
+        cr_assert(vectorPrepend(v, &i));
+    }
+    cr_assert(vectorShrinkToFit(v));
+    cr_expect(100 == vectorCapacity(v));
+    cr_assert(vectorPrepend(v, &(cds_size){100}));
+    for (cds_size i=0; i<=100; i++){
+        cr_expect(i == *(const cds_size*) vectorGetAt(v, i));
+    }
+    cr_expect(!vectorShrinkToFit(NULL));
+}
+
 /*
  * Testing simple push back operation with expansion and data retrieving with iterators.
 */
@@ -162,3 +184,173 @@ Test(vector_int, vector2tuple){
     }
 }
 
+Test(vector_int, vector_into_tuple){
+    Vector* vec = vectorCreate(MIN_CAPACITY, DATA_SIZE);
+    cr_assert(vec);
+    for (cds_size i=0; i<MIN_CAPACITY; i++){
+        cr_assert(vectorPrepend(vec, &(cds_size){i}), "Expected pushing operation to succeed.");
+    }
+    Tuple* view = vectorToTupleView(vec);
+    cr_assert(view);
+    cr_expect(vectorGetAt(vec, 0) == tupleGetAt(view, 0), "Views should borrow the buffer.");
+    tupleDelete(view);
+    const void* buffer = vectorToArr(vec);
+    const cds_size capacity = vectorCapacity(vec);
+    Tuple* t = vectorIntoTuple(vec, false);
+    cr_assert(t);
+    cr_expect(buffer == tupleGetAt(t, 0), "The buffer should be taken over.");
+    cr_expect(MIN_CAPACITY == tupleLength(t));
+    Vector* back = tupleIntoVector(t);
+    cr_assert(back);
+    cr_expect(buffer == vectorToArr(back));
+    cr_expect(capacity == vectorCapacity(back), "The spare capacity should be kept.");
+    cr_assert(vectorPrepend(back, &(cds_size){MIN_CAPACITY}));
+    t = vectorIntoTuple(back, true);
+    cr_assert(t);
+    for (cds_size i=0; i<=MIN_CAPACITY; i++){
+        cr_assert(i == *(const cds_size*) tupleGetAt(t, i));
+    }
+    tupleDelete(t);
+    Vector* large = vectorCreateLarge(MIN_CAPACITY, DATA_SIZE, false);
+    cr_assert(vectorPrepend(large, &(cds_size){7}));
+    t = vectorIntoTuple(large, true);
+    cr_assert(t);
+    large = tupleIntoVector(t);
+    cr_assert(large);
+    for (cds_size i=0; i<4*INIT_CAPACITY; i++){
+        cr_assert(vectorPrepend(large, &(cds_size){i}), "Expected pushing operation to succeed.");
+    }
+    cr_expect(7 == *(const cds_size*) vectorGetAt(large, 0));
+    vectorDelete(large);
+}
+
+Test(vector_int, vector_slices){
+    for (cds_size i=0; i<INIT_CAPACITY; i++){
+        cr_expect(vectorPrepend(v, &(cds_size){i}), "Expected pushing operation to succeed.");
+    }
+    VectorSlice window = vectorSlice(v, 100, 50);
+    cr_expect(50 == window.length);
+    cr_expect(vectorGetAt(v, 100) == window.data, "Slices should share the buffer.");
+    cr_expect(120 == *(const cds_size*) vectorSliceGetAt(&window, 20));
+    cr_expect(!vectorSliceGetAt(&window, 50));
+    cds_size i = 100;
+    for (Iter* iter=iterCreate(&window, VECTOR_SLICE); iter; iter=iterNext(iter), i++){
+        cr_assert(i == *(const cds_size*) iterGetData(iter));
+    }
+    cr_expect(150 == i);
+    VectorSlice empty = vectorSlice(v, INIT_CAPACITY, 10);
+    cr_expect(0 == empty.length && !empty.data);
+    cr_expect(!iterCreate(&empty, VECTOR_SLICE), "Empty slices have nothing to iterate.");
+}
+
+Test(vector_int, vector_unchecked_access){
+    for (cds_size i=0; i<INIT_CAPACITY; i++){
+        cr_expect(vectorPrepend(v, &(cds_size){i}), "Expected pushing operation to succeed.");
+    }
+    cds_size* data = vectorData(v);
+    for (cds_size i=0; i<vectorLengthUnchecked(v); i++){
+        cr_expect(vectorGetAt(v, i) == vectorAtUnchecked(v, i));
+        cr_expect(data[i] == VECTOR_AT(v, cds_size, i));
+        VECTOR_AT(v, cds_size, i) *= 2;
+    }
+    cr_expect(2*(INIT_CAPACITY - 1) == *(cds_size*) vectorGetAt(v, INIT_CAPACITY - 1));
+}
+
+Test(vector_int, vector_large_growth){
+    Vector* vec = vectorCreateLarge(MIN_CAPACITY, DATA_SIZE, true);
+    cr_assert(vec);
+    cr_expect(INIT_CAPACITY == vectorCapacity(vec));
+    for (cds_size i=0; i<64*INIT_CAPACITY; i++){
+        cr_assert(vectorPrepend(vec, &(cds_size){i}), "Expected pushing operation to succeed.");
+    }
+    cr_expect(128*INIT_CAPACITY == vectorCapacity(vec));
+    cr_assert(vectorReserve(vec, 1000*INIT_CAPACITY));
+    cr_expect(1024*INIT_CAPACITY == vectorCapacity(vec));
+    for (cds_size i=0; i<vectorLength(vec); i++){
+        cr_assert(i == *(const cds_size*) vectorGetAt(vec, i));
+    }
+    Vector* copy = vectorCopy(vec);
+    cr_assert(copy);
+    cr_expect(vectorLength(vec) == vectorLength(copy));
+    vectorDelete(copy);
+    vectorDelete(vec);
+}
+
+Test(vector_int, vector_file_mapped){
+    char path[] = "/tmp/cds_vector_XXXXXX";
+    cds_int fd = mkstemp(path);
+    cr_assert(fd >= 0);
+    Vector* vec = vectorOpenMapped(path, DATA_SIZE, MAPPED_TRUNCATE);
+    cr_assert(vec);
+    cr_expect(0 == vectorLength(vec));
+    for (cds_size i=0; i<INIT_CAPACITY; i++){
+        cr_assert(vectorPrepend(vec, &(cds_size){i}), "Expected pushing operation to succeed.");
+    }
+    cr_expect(vectorSync(vec));
+    vectorDelete(vec);
+    Vector* ro = vectorOpenMapped(path, DATA_SIZE, MAPPED_READ_ONLY);
+    cr_assert(ro);
+    cr_expect(INIT_CAPACITY == vectorLength(ro), "The file should be trimmed to the length.");
+    cds_size i = 0;
+    for (Iter* iter=iterCreate(ro, VECTOR); iter; iter=iterNext(iter), i++){
+        cr_assert(i == *(const cds_size*) iterGetData(iter));
+    }
+    cr_expect(!vectorPrepend(ro, &(cds_size){0}), "Read only vectors cannot grow.");
+    // writing in place would fault on the read only mapping.
+    cr_expect(!vectorUpdateAt(ro, &(cds_size){0}, 1));
+    cr_expect(!vectorSortNumeric(ro, NUM_UINT64));
+    cr_expect(!vectorPrefixSum(ro, NUM_UINT64));
+    cr_expect(CDS_NOT_FOUND == vectorFilterInto(ro, ro, CMP_GT, &(cds_size){0}, NUM_UINT64));
+    cr_expect(1 == *(const cds_size*) vectorGetAt(ro, 1));
+    vectorDelete(ro);
+    Tuple* t = tupleOpenMapped(path, DATA_SIZE);
+    cr_assert(t);
+    cr_expect(INIT_CAPACITY == tupleLength(t));
+    cr_expect(7 == *(const cds_size*) tupleGetAt(t, 7));
+    tupleDelete(t);
+    cr_expect(!vectorOpenMapped(path, 3, MAPPED_READ_ONLY), "Size is not a multiple of 3.");
+    (void) close(fd);
+    (void) unlink(path);
+}
+
+Test(vector_int, vector_file_sync){
+    char path[] = "/tmp/cds_vector_XXXXXX";
+    cds_int fd = mkstemp(path);
+    cr_assert(fd >= 0);
+    Vector* vec = vectorOpenMapped(path, DATA_SIZE, MAPPED_TRUNCATE);
+    cr_assert(vec);
+    cr_expect(vectorSync(vec), "An empty vector should sync to an empty file.");
+    for (cds_size round=1; round<=3; round++){
+        // the vector keeps growing after its file was trimmed.
+        for (cds_size i=0; i<INIT_CAPACITY + 3; i++){
+            cr_assert(vectorPrepend(vec, &(cds_size){i}), "Expected pushing operation to succeed.");
+        }
+        cr_assert(vectorSync(vec));
+        // reopened without deleting the vector, as after a crash.
+        Vector* ro = vectorOpenMapped(path, DATA_SIZE, MAPPED_READ_ONLY);
+        cr_assert(ro);
+        cr_expect(round*(INIT_CAPACITY + 3) == vectorLength(ro), "The file should be trimmed to the length.");
+        cr_expect(INIT_CAPACITY + 2 == *(const cds_size*) vectorGetAt(ro, vectorLength(ro) - 1));
+        vectorDelete(ro);
+    }
+    vectorDelete(vec);
+    (void) close(fd);
+    (void) unlink(path);
+}
+
+Test(vector_int, vector_aligned){
+    const AllocOptions options = {64, HUGE_PAGES_TRANSPARENT};
+    Vector* vec = vectorCreateWithOptions(MIN_CAPACITY, DATA_SIZE, &options);
+    cr_assert(vec);
+    cr_expect(0 == (uintptr_t) vectorData(vec) % 64);
+    for (cds_size i=0; i<16*INIT_CAPACITY; i++){
+        cr_assert(vectorPrepend(vec, &(cds_size){i}), "Expected pushing operation to succeed.");
+    }
+    cr_expect(0 == (uintptr_t) vectorData(vec) % 64, "Alignment should survive expansions.");
+    for (cds_size i=0; i<vectorLength(vec); i++){
+        cr_assert(i == *(const cds_size*) vectorGetAt(vec, i));
+    }
+    vectorDelete(vec);
+    cr_expect(!vectorCreateWithOptions(MIN_CAPACITY, DATA_SIZE, &(AllocOptions){48, HUGE_PAGES_NONE}),
+              "Alignments must be powers of 2.");
+}
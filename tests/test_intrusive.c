@@ -0,0 +1,138 @@
+/*!
+ * @file test_intrusive.c
+ * @author Paulo Arruda
+ * @copyright GPL v3 or later.
+ * @brief Testing the intrusive lists.
+*/
+
+#include <criterion/criterion.h>
+#include "../include/intrusive.h"
+
+#define NUM_CONNECTIONS 100
+#define NUM_BUCKETS 8
+
+/**
+ * A connection on three lists at once: the free list, the list of idle
+ * connections and the bucket of its port.
+*/
+typedef struct Connection{
+    cds_int port;
+    ISLink free;
+    IDLink idle;
+    IHLink by_port;
+}Connection;
+
+Test(intrusive, container_of){
+    Connection connection = {.port=80};
+    cr_expect(&connection == CDS_CONTAINER_OF(&connection.free, Connection, free));
+    cr_expect(&connection == CDS_CONTAINER_OF(&connection.idle, Connection, idle));
+    cr_expect(&connection == CDS_CONTAINER_OF(&connection.by_port, Connection, by_port));
+}
+
+Test(intrusive, singly_linked){
+    Connection connections[NUM_CONNECTIONS];
+    ISList list = ISLIST_INIT;
+    cr_expect(islistIsEmpty(&list));
+    cr_expect(!islistPop(&list));
+    for (cds_int i=0; i<NUM_CONNECTIONS; i++){
+        connections[i].port = i;
+        islistPush(&list, &connections[i].free);
+    }
+    ISLink* pos;
+    cds_int expected = NUM_CONNECTIONS - 1;
+    ISLIST_FOR_EACH(pos, &list){
+        cr_assert(expected-- == CDS_CONTAINER_OF(pos, Connection, free)->port);
+    }
+    cr_expect(islistRemove(&list, &connections[50].free));
+    cr_expect(!islistRemove(&list, &connections[50].free));
+    islistInsertAfter(&connections[51].free, &connections[50].free);
+    expected = NUM_CONNECTIONS - 1;
+    for (ISLink* link; (link = islistPop(&list)); ){
+        cr_assert(expected-- == CDS_CONTAINER_OF(link, Connection, free)->port);
+    }
+    cr_expect(-1 == expected);
+    cr_expect(islistIsEmpty(&list));
+}
+
+Test(intrusive, doubly_linked){
+    Connection connections[NUM_CONNECTIONS];
+    IDLink idle = IDLIST_INIT(idle);
+    cr_expect(idlistIsEmpty(&idle));
+    cr_expect(!idlistFront(&idle) && !idlistBack(&idle));
+    for (cds_int i=0; i<NUM_CONNECTIONS; i++){
+        connections[i].port = i;
+        idlistInit(&connections[i].idle);
+        cr_assert(!idlistIsLinked(&connections[i].idle));
+        idlistPushBack(&idle, &connections[i].idle);
+    }
+    // drop the even connections while iterating.
+    IDLink *pos, *tmp;
+    IDLIST_FOR_EACH_SAFE(pos, tmp, &idle){
+        if (!(CDS_CONTAINER_OF(pos, Connection, idle)->port % 2)){
+            idlistRemove(pos);
+        }
+    }
+    cr_expect(!idlistIsLinked(&connections[0].idle));
+    cr_expect(idlistIsLinked(&connections[1].idle));
+    cds_int expected = NUM_CONNECTIONS - 1;
+    IDLIST_FOR_EACH_REVERSE(pos, &idle){
+        cr_assert(expected == CDS_CONTAINER_OF(pos, Connection, idle)->port);
+        expected -= 2;
+    }
+    idlistPushFront(&idle, &connections[0].idle);
+    idlistInsertBefore(&connections[3].idle, &connections[2].idle);
+    cr_expect(&connections[0].idle == idlistPopFront(&idle));
+    cr_expect(&connections[99].idle == idlistPopBack(&idle));
+    // moving the list elsewhere keeps the order.
+    IDLink other = IDLIST_INIT(other);
+    idlistPushBack(&other, &connections[0].idle);
+    idlistSplice(&other, &idle);
+    cr_expect(idlistIsEmpty(&idle));
+    cds_int ports[] = {0, 1, 2, 3, 5, 7};
+    cds_size i = 0;
+    IDLIST_FOR_EACH(pos, &other){
+        if (i < sizeof(ports)/sizeof(ports[0])){
+            cr_assert(ports[i] == CDS_CONTAINER_OF(pos, Connection, idle)->port);
+        }
+        i++;
+    }
+    cr_expect(NUM_CONNECTIONS/2 + 1 == i);
+}
+
+Test(intrusive, hash_chains){
+    Connection connections[NUM_CONNECTIONS];
+    IHList buckets[NUM_BUCKETS];
+    for (cds_size i=0; i<NUM_BUCKETS; i++){
+        ihlistInit(&buckets[i]);
+    }
+    IDLink idle = IDLIST_INIT(idle);
+    for (cds_int i=0; i<NUM_CONNECTIONS; i++){
+        connections[i].port = i;
+        ihlinkInit(&connections[i].by_port);
+        ihlistAdd(&buckets[i % NUM_BUCKETS], &connections[i].by_port);
+        idlistPushBack(&idle, &connections[i].idle);
+    }
+    // removing from a bucket leaves the other lists untouched.
+    IHLink *pos, *tmp;
+    IHLIST_FOR_EACH_SAFE(pos, tmp, &buckets[3]){
+        ihlistRemove(pos);
+    }
+    cr_expect(ihlistIsEmpty(&buckets[3]));
+    cr_expect(!ihlistIsLinked(&connections[3].by_port));
+    ihlistRemove(&connections[50].by_port);   // in the middle of bucket 2
+    ihlistRemove(&connections[98].by_port);   // first of bucket 2
+    cds_size count = 0;
+    IHLIST_FOR_EACH(pos, &buckets[2]){
+        Connection* connection = CDS_CONTAINER_OF(pos, Connection, by_port);
+        cr_assert(2 == connection->port % NUM_BUCKETS);
+        cr_assert(50 != connection->port && 98 != connection->port);
+        count++;
+    }
+    cr_expect(11 == count);
+    IDLink* link;
+    count = 0;
+    IDLIST_FOR_EACH(link, &idle){
+        count++;
+    }
+    cr_expect(NUM_CONNECTIONS == count);
+}
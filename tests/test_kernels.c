@@ -0,0 +1,139 @@
+/*!
+ * @file test_kernels.c
+ * @author Paulo Arruda
+ * @copyright GPL v3 or later.
+ * @brief Testing the kernels API.
+*/
+
+#include <time.h>
+#include <string.h>
+#include <criterion/criterion.h>
+#include "../include/kernels.h"
+
+#define LENGTH 1000
+
+Vector* v = (Vector*) NULL;
+
+void kernelsSetup(void){
+    v = vectorCreate(LENGTH, sizeof(cds_int32));
+    for (cds_int32 i=0; i<LENGTH; i++){
+        (void) vectorPrepend(v, &(cds_int32){i % 100 - 50});
+    }
+}
+
+void kernelsTeardown(void){
+    vectorDelete(v);
+    v = (Vector*) NULL;
+}
+
+TestSuite(kernels, .init=kernelsSetup, .fini=kernelsTeardown);
+
+Test(kernels, find_and_count){
+    cr_expect(60 == vectorFind(v, &(cds_int32){10}));
+    cr_expect(CDS_NOT_FOUND == vectorFind(v, &(cds_int32){1000}));
+    cr_expect(10 == vectorCount(v, &(cds_int32){-50}));
+    cr_expect(0 == vectorCount(v, &(cds_int32){1000}));
+    for (cds_size size=1; size<=8; size<<=1){
+        // the element sits after the vectorized blocks, then inside them.
+        cds_uint8 arr[8*67] = {0};
+        arr[66*size] = 1;
+        cr_expect(66 == arrFind(arr, 67, size, &(cds_uint64){1}), "Size %zu", size);
+        arr[3*size] = 1;
+        cr_expect(3 == arrFind(arr, 67, size, &(cds_uint64){1}), "Size %zu", size);
+        cr_expect(2 == arrCount(arr, 67, size, &(cds_uint64){1}), "Size %zu", size);
+        cr_expect(65 == arrCount(arr, 67, size, &(cds_uint64){0}), "Size %zu", size);
+    }
+}
+
+Test(kernels, filter_into){
+    Vector* dst = vectorCreate(1, sizeof(cds_int32));
+    cds_size count = vectorFilterInto(v, dst, CMP_GE, &(cds_int32){45}, NUM_INT32);
+    cr_assert(50 == count);
+    cr_expect(50 == vectorLength(dst));
+    for (cds_size i=0; i<vectorLength(dst); i++){
+        cr_expect(*(const cds_int32*) vectorGetAt(dst, i) >= 45);
+    }
+    cr_expect(CDS_NOT_FOUND == vectorFilterInto(v, dst, CMP_EQ, &(cds_int32){0}, NUM_INT64));
+    vectorDelete(dst);
+}
+
+Test(kernels, filter_into_itself){
+    // aligned buffers are never resized in place, so the reserve has to move it.
+    Vector* vec = vectorCreateWithOptions(100, sizeof(cds_int32), &(AllocOptions){64, HUGE_PAGES_NONE});
+    for (cds_int32 i=0; i<100; i++){
+        cr_assert(vectorPrepend(vec, &i));
+    }
+    const void* buffer = vectorToArr(vec);
+    cr_assert(100 == vectorFilterInto(vec, vec, CMP_GE, &(cds_int32){0}, NUM_INT32));
+    cr_assert(buffer != vectorToArr(vec), "The reserve should move the buffer the elements are read from.");
+    cr_assert(200 == vectorLength(vec));
+    for (cds_int32 i=0; i<100; i++){
+        cr_assert(i == *(const cds_int32*) vectorGetAt(vec, 100 + (cds_size) i));
+    }
+    Tuple* view = vectorToTupleView(vec);
+    cr_assert(view);
+    cr_assert(100 == tupleFilterInto(view, vec, CMP_LT, &(cds_int32){50}, NUM_INT32));
+    tupleDelete(view);
+    cr_expect(300 == vectorLength(vec));
+    cr_expect(49 == *(const cds_int32*) vectorGetAt(vec, 299));
+    vectorDelete(vec);
+}
+
+Test(kernels, reductions){
+    cds_int32 min, max;
+    int64_t sum;
+    cr_assert(vectorMin(v, NUM_INT32, &min));
+    cr_assert(vectorMax(v, NUM_INT32, &max));
+    cr_assert(vectorSum(v, NUM_INT32, &sum));
+    cr_expect(-50 == min);
+    cr_expect(49 == max);
+    cr_expect(-500 == sum);
+    cds_double arr[] = {0.0/0.0, 2.0, -1.5, 0.0/0.0, 8.25};
+    cds_double dmin, dmax, dsum;
+    cr_assert(arrMin(arr, 5, NUM_DOUBLE, &dmin));
+    cr_assert(arrMax(arr, 5, NUM_DOUBLE, &dmax));
+    arrSum(arr + 1, 2, NUM_DOUBLE, &dsum);
+    cr_expect(-1.5 == dmin);
+    cr_expect(8.25 == dmax);
+    cr_expect(0.5 == dsum);
+}
+
+Test(kernels, prefix_sum){
+    cr_assert(vectorPrefixSum(v, NUM_INT32));
+    cds_int32 expected = 0;
+    for (cds_int32 i=0; i<LENGTH; i++){
+        expected += i % 100 - 50;
+        cr_assert(expected == *(const cds_int32*) vectorGetAt(v, i), "Wrong sum at %d", i);
+    }
+    cds_uint8 bytes[37];
+    for (cds_size i=0; i<37; i++){
+        bytes[i] = 7;
+    }
+    arrPrefixSum(bytes, 37, NUM_UINT8);
+    for (cds_size i=0; i<37; i++){
+        cr_expect((cds_uint8) (7*(i+1)) == bytes[i]);
+    }
+}
+
+Test(kernels, tuples){
+    Tuple* t = vectorToTuple(v);
+    cds_int32 max;
+    cr_expect(50 == tupleFind(t, &(cds_int32){0}));
+    cr_expect(10 == tupleCount(t, &(cds_int32){0}));
+    cr_expect(tupleMax(t, NUM_INT32, &max) && 49 == max);
+    tupleDelete(t);
+}
+
+Test(kernels, slices){
+    VectorSlice window = vectorSlice(v, 100, 100);
+    cr_expect(50 == vectorSliceFind(&window, &(cds_int32){0}), "Indices are relative to the slice.");
+    cr_expect(1 == vectorSliceCount(&window, &(cds_int32){0}));
+    VectorSlice half = vectorSliceSub(&window, 60, 100);
+    cr_expect(40 == half.length);
+    cr_expect(CDS_NOT_FOUND == vectorSliceFind(&half, &(cds_int32){0}));
+    Tuple* t = vectorToTupleView(v);
+    TupleSlice tail = tupleSlice(t, LENGTH - 10, 10);
+    cr_expect(9 == tupleSliceFind(&tail, &(cds_int32){49}));
+    cr_expect(0 == tupleSliceCount(&tail, &(cds_int32){0}));
+    tupleDelete(t);
+}
@@ -0,0 +1,139 @@
+/*!
+ * @file test_mpmc_queue.c
+ * @author Paulo Arruda
+ * @copyright GPL v3 or later.
+ * @brief Testing the bounded MPMC queue.
+*/
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <criterion/criterion.h>
+#include "../include/mpmc_queue.h"
+
+#define NUM_PRODUCERS 4
+#define NUM_CONSUMERS 4
+#define PER_PRODUCER 50000
+#define BATCH 16
+
+Test(mpmc_queue, single_thread){
+    cr_expect(!mpmcqCreate(0, sizeof(cds_int)));
+    cr_expect(!mpmcqCreate(8, 0));
+    MPMCQueue* queue = mpmcqCreate(5, sizeof(cds_int));
+    cr_assert(queue);
+    cr_expect(8 == mpmcqCapacity(queue), "The capacity should be rounded to a power of 2.");
+    cds_int value;
+    cr_expect(!mpmcqTryPop(queue, &value));
+    // several laps around the ring.
+    for (cds_int lap=0; lap<5; lap++){
+        for (cds_int i=0; i<8; i++){
+            cr_assert(mpmcqTryPush(queue, &(cds_int){8*lap + i}));
+        }
+        cr_expect(!mpmcqTryPush(queue, &(cds_int){-1}), "The queue should be full.");
+        cr_expect(8 == mpmcqLength(queue));
+        for (cds_int i=0; i<8; i++){
+            cr_assert(mpmcqTryPop(queue, &value));
+            cr_assert(8*lap + i == value);
+        }
+    }
+    cr_expect(0 == mpmcqLength(queue));
+    mpmcqDelete(queue);
+}
+
+Test(mpmc_queue, batches){
+    MPMCQueue* queue = mpmcqCreate(16, sizeof(cds_double));
+    cr_assert(queue);
+    cds_double in[20], out[20];
+    for (cds_size i=0; i<20; i++){
+        in[i] = 0.5 * (cds_double) i;
+    }
+    cr_expect(3 == mpmcqTryPushN(queue, in, 3));
+    cr_expect(13 == mpmcqTryPushN(queue, in + 3, 17), "Only the free slots should be filled.");
+    cr_expect(10 == mpmcqTryPopN(queue, out, 10));
+    cr_expect(4 == mpmcqPushN(queue, in + 16, 4));
+    cr_expect(10 == mpmcqPopN(queue, out + 10, 20));
+    for (cds_size i=0; i<20; i++){
+        cr_assert(in[i] == out[i]);
+    }
+    cr_expect(0 == mpmcqTryPopN(queue, out, 20));
+    mpmcqDelete(queue);
+}
+
+typedef struct {
+    MPMCQueue* queue;
+    cds_size id;
+    atomic_size_t* sum;
+    atomic_size_t* count;
+} Worker;
+
+static void* producer(void* arg){
+    Worker* worker = (Worker*) arg;
+    cds_size batch[BATCH];
+    for (cds_size i=0; i<PER_PRODUCER; i+=BATCH){
+        for (cds_size j=0; j<BATCH; j++){
+            batch[j] = worker->id*PER_PRODUCER + i + j + 1;
+        }
+        // alternates single and batched pushes.
+        if ((i / BATCH) % 2){
+            (void) mpmcqPushN(worker->queue, batch, BATCH);
+        }
+        else{
+            for (cds_size j=0; j<BATCH; j++){
+                (void) mpmcqPush(worker->queue, &batch[j]);
+            }
+        }
+    }
+    return NULL;
+}
+
+static void* consumer(void* arg){
+    Worker* worker = (Worker*) arg;
+    cds_size batch[BATCH];
+    while (true){
+        cds_size popped = mpmcqPopN(worker->queue, batch, BATCH);
+        cds_size stops = 0;
+        for (cds_size j=0; j<popped; j++){
+            // zero is the stop signal of the consumers.
+            if (!batch[j]){
+                stops++;
+                continue;
+            }
+            (void) atomic_fetch_add(worker->sum, batch[j]);
+            (void) atomic_fetch_add(worker->count, 1);
+        }
+        if (stops){
+            // the signals of the other consumers go back to the queue.
+            while (--stops){
+                (void) mpmcqPush(worker->queue, &(cds_size){0});
+            }
+            return NULL;
+        }
+    }
+}
+
+Test(mpmc_queue, threads){
+    MPMCQueue* queue = mpmcqCreate(64, sizeof(cds_size));
+    cr_assert(queue);
+    atomic_size_t sum, count;
+    atomic_init(&sum, 0);
+    atomic_init(&count, 0);
+    pthread_t threads[NUM_PRODUCERS + NUM_CONSUMERS];
+    Worker workers[NUM_PRODUCERS + NUM_CONSUMERS];
+    for (cds_size i=0; i<NUM_PRODUCERS + NUM_CONSUMERS; i++){
+        workers[i] = (Worker){queue, i, &sum, &count};
+        cr_assert(0 == pthread_create(&threads[i], NULL, i < NUM_PRODUCERS ? producer : consumer, &workers[i]));
+    }
+    for (cds_size i=0; i<NUM_PRODUCERS; i++){
+        (void) pthread_join(threads[i], NULL);
+    }
+    // one zero per consumer, pushed after all the values, stops the consumers.
+    for (cds_size i=0; i<NUM_CONSUMERS; i++){
+        cr_assert(mpmcqPush(queue, &(cds_size){0}));
+    }
+    for (cds_size i=NUM_PRODUCERS; i<NUM_PRODUCERS + NUM_CONSUMERS; i++){
+        (void) pthread_join(threads[i], NULL);
+    }
+    const cds_size n = NUM_PRODUCERS*PER_PRODUCER;
+    cr_expect(n == atomic_load(&count));
+    cr_expect(n*(n + 1)/2 == atomic_load(&sum));
+    mpmcqDelete(queue);
+}
@@ -0,0 +1,132 @@
+/*!
+ * @file test_packed_vector.c
+ * @author Paulo Arruda
+ * @copyright GPL v3 or later.
+ * @brief Testing the packed vector API.
+*/
+
+#include <time.h>
+#include <criterion/criterion.h>
+#include "../include/packed_vector.h"
+
+#define LENGTH 100001
+
+static const enum PackedEncoding encodings[] = {PACKED_FOR, PACKED_DELTA, PACKED_AUTO};
+
+TestSuite(packed_vector);
+
+/*
+ * Sorted 64 bits identifiers fitting 20 bits.
+*/
+Test(packed_vector, sorted_ids){
+    Vector* ids = vectorCreate(LENGTH, sizeof(cds_uint64));
+    srand(time(0));
+    cds_uint64 id = 1ULL << 40;
+    for (cds_size i=0; i<LENGTH; i++){
+        id += (cds_uint64) (rand() % 16);
+        cr_assert(vectorPrepend(ids, &id));
+    }
+    for (cds_size e=0; e<3; e++){
+        PackedVector* pv = packvecFromVector(ids, NUM_UINT64, encodings[e]);
+        cr_assert(pv);
+        cr_expect(LENGTH == packvecLength(pv) && sizeof(cds_uint64) == packvecDataSize(pv));
+        if (PACKED_FOR != encodings[e]){
+            cr_expect(3*packvecMemoryUsage(pv) < LENGTH*sizeof(cds_uint64),
+                      "Delta encoding should take less than a third of the memory.");
+        }
+        for (cds_size i=0; i<LENGTH; i+=7){
+            cds_uint64 value = 0;
+            cr_assert(packvecGet(pv, i, &value));
+            cr_assert(*(const cds_uint64*) vectorGetAt(ids, i) == value);
+        }
+        Vector* decoded = packvecToVector(pv);
+        cr_assert(decoded && LENGTH == vectorLength(decoded));
+        cr_assert(0 == memcmp(vectorToArr(ids), vectorToArr(decoded), LENGTH*sizeof(cds_uint64)));
+        vectorDelete(decoded);
+        packvecDelete(pv);
+    }
+    vectorDelete(ids);
+}
+
+/*
+ * Random values of every integer type, including the extreme ones, through
+ * every encoding.
+*/
+#define TEST_TYPE(ctype, num_type, min, max)                                                \
+    do{                                                                                     \
+        ctype* arr = (ctype*) malloc(LENGTH*sizeof(ctype));                                 \
+        for (cds_size i=0; i<LENGTH; i++){                                                  \
+            cds_uint64 bits = ((cds_uint64) rand() << 32) ^ (cds_uint64) rand();            \
+            arr[i] = (ctype) bits;                                                          \
+        }                                                                                   \
+        arr[5] = min;                                                                       \
+        arr[6] = max;                                                                       \
+        for (cds_size e=0; e<3; e++){                                                       \
+            PackedVector* pv = packvecFromArray(arr, LENGTH, num_type, encodings[e]);       \
+            cr_assert(pv);                                                                  \
+            ctype* out = (ctype*) malloc(LENGTH*sizeof(ctype));                             \
+            cr_assert(LENGTH - 3 == packvecDecode(pv, 3, LENGTH, out));                     \
+            cr_assert(0 == memcmp(arr + 3, out, (LENGTH - 3)*sizeof(ctype)));               \
+            for (cds_size i=0; i<LENGTH; i+=13){                                            \
+                ctype value;                                                                \
+                cr_assert(packvecGet(pv, i, &value) && arr[i] == value);                    \
+            }                                                                               \
+            free(out);                                                                      \
+            packvecDelete(pv);                                                              \
+        }                                                                                   \
+        free(arr);                                                                          \
+    }while(0)
+
+Test(packed_vector, every_type){
+    srand(time(0));
+    TEST_TYPE(cds_int8, NUM_INT8, INT8_MIN, INT8_MAX);
+    TEST_TYPE(cds_uint8, NUM_UINT8, 0, UINT8_MAX);
+    TEST_TYPE(cds_int16, NUM_INT16, INT16_MIN, INT16_MAX);
+    TEST_TYPE(cds_uint16, NUM_UINT16, 0, UINT16_MAX);
+    TEST_TYPE(cds_int32, NUM_INT32, INT32_MIN, INT32_MAX);
+    TEST_TYPE(cds_uint32, NUM_UINT32, 0, UINT32_MAX);
+    TEST_TYPE(cds_int64, NUM_INT64, INT64_MIN, INT64_MAX);
+    TEST_TYPE(cds_uint64, NUM_UINT64, 0, UINT64_MAX);
+}
+
+Test(packed_vector, constant_and_small_blocks){
+    cds_int32 arr[300];
+    for (cds_size i=0; i<300; i++){
+        arr[i] = i < 200 ? -7 : (cds_int32) i - 250;
+    }
+    PackedVector* pv = packvecFromArray(arr, 300, NUM_INT32, PACKED_AUTO);
+    cr_assert(pv);
+    cds_int32 out[300];
+    cr_assert(300 == packvecDecode(pv, 0, 300, out));
+    cr_expect(0 == memcmp(arr, out, sizeof(arr)));
+    cds_int32 value;
+    cr_expect(!packvecGet(pv, 300, &value));
+    cr_expect(0 == packvecDecode(pv, 300, 1, out));
+    packvecDelete(pv);
+    pv = packvecFromArray(arr, 1, NUM_INT32, PACKED_DELTA);
+    cr_assert(pv && packvecGet(pv, 0, &value) && -7 == value);
+    packvecDelete(pv);
+    pv = packvecFromArray(NULL, 0, NUM_INT32, PACKED_FOR);
+    cr_assert(pv && 0 == packvecLength(pv));
+    cr_expect(!iterCreate(pv, PACKED_VECTOR), "Empty packed vectors should not be iterated.");
+    packvecDelete(pv);
+    cr_expect(!packvecFromArray(arr, 300, NUM_FLOAT, PACKED_FOR));
+}
+
+Test(packed_vector, iterator){
+    Vector* vec = vectorCreate(1000, sizeof(cds_int16));
+    for (cds_int16 i=0; i<1000; i++){
+        cds_int16 value = (cds_int16) (3*i - 1500);
+        cr_assert(vectorPrepend(vec, &value));
+    }
+    PackedVector* pv = packvecFromVector(vec, NUM_INT16, PACKED_DELTA);
+    cr_assert(pv);
+    cds_size index = 0;
+    for (Iter* it=iterCreate(pv, PACKED_VECTOR); it; it=iterNext(it)){
+        cr_assert(*(const cds_int16*) vectorGetAt(vec, index) == *(const cds_int16*) iterGetData(it));
+        index++;
+    }
+    cr_expect(1000 == index);
+    packvecDelete(pv);
+    vectorDelete(vec);
+}
@@ -0,0 +1,200 @@
+/*!
+ * @file test_parallel.c
+ * @author Paulo Arruda
+ * @copyright GPL v3 or later.
+ * @brief Testing the thread pool and the data-parallel operations.
+*/
+
+#include <stdatomic.h>
+#include <string.h>
+#include <criterion/criterion.h>
+#include "../include/parallel.h"
+
+#define LENGTH 1000000
+#define NUM_THREADS 4
+
+ThreadPool* pool = (ThreadPool*) NULL;
+Vector* v = (Vector*) NULL;
+
+void parallelSetup(void){
+    pool = tpoolCreate(NUM_THREADS);
+    cr_assert(pool, "tpoolCreate should return a not NULL pool");
+    v = vectorCreateWithOptions(LENGTH, sizeof(cds_uint32), &(AllocOptions){CDS_CACHE_LINE, HUGE_PAGES_NONE});
+    for (cds_uint32 i=0; i<LENGTH; i++){
+        (void) vectorPrepend(v, &i);
+    }
+}
+
+void parallelTeardown(void){
+    vectorDelete(v);
+    v = (Vector*) NULL;
+    tpoolDelete(pool);
+    pool = (ThreadPool*) NULL;
+}
+
+TestSuite(parallel, .init=parallelSetup, .fini=parallelTeardown);
+
+static void countTask(void* arg, const cds_size task){
+    atomic_fetch_add((atomic_size_t*) arg, task);
+}
+
+static void nestedTask(void* arg, const cds_size task){
+    (void) task;
+    tpoolRun(pool, countTask, arg, 10);
+}
+
+Test(parallel, pool_run){
+    cr_expect(NUM_THREADS == tpoolNumThreads(pool));
+    atomic_size_t sum;
+    for (cds_size round=0; round<100; round++){
+        atomic_init(&sum, 0);
+        tpoolRun(pool, countTask, &sum, 1000);
+        cr_assert(999*1000/2 == atomic_load(&sum), "Every task should run once per job.");
+    }
+    atomic_init(&sum, 0);
+    tpoolRun(pool, nestedTask, &sum, 8);
+    cr_expect(8*45 == atomic_load(&sum), "Nested jobs should run on the calling thread.");
+    atomic_init(&sum, 0);
+    tpoolRun((ThreadPool*) NULL, countTask, &sum, 100);
+    cr_expect(99*100/2 == atomic_load(&sum));
+}
+
+typedef struct Fib{
+    cds_uint32 n;
+    cds_uint64 result;
+}Fib;
+
+/**
+ * Naive recursion, forking one branch: the work of the tasks varies widely.
+*/
+static void fibTask(void* arg){
+    Fib* fib = (Fib*) arg;
+    if (fib->n < 2){
+        fib->result = fib->n;
+        return;
+    }
+    Fib a = {fib->n - 1, 0}, b = {fib->n - 2, 0};
+    ForkJoinTask* task = tpoolFork(fibTask, &a);
+    fibTask(&b);
+    tpoolJoin(task);
+    fib->result = a.result + b.result;
+}
+
+static void nestedForkJoin(void* arg){
+    tpoolForkJoin(pool, fibTask, arg);
+}
+
+Test(parallel, fork_join){
+    for (cds_size round=0; round<10; round++){
+        Fib fib = {25, 0};
+        tpoolForkJoin(pool, fibTask, &fib);
+        cr_assert(75025 == fib.result);
+    }
+    Fib fib = {20, 0};
+    tpoolForkJoin(pool, nestedForkJoin, &fib);
+    cr_expect(6765 == fib.result, "Nested computations should join the current one.");
+    fib.n = 15;
+    fibTask(&fib);
+    cr_expect(610 == fib.result, "Outside of a computation the tasks should run inline.");
+    tpoolForkJoin(pool, (ForkJoinFun) NULL, NULL);
+}
+
+static void doubleElement(void* data, const cds_size index, void* arg){
+    (void) arg;
+    *(cds_uint32*) data = 2 * (cds_uint32) index;
+}
+
+static void widen(const void* in, void* out, void* arg){
+    *(cds_uint64*) out = *(const cds_uint32*) in + *(const cds_uint64*) arg;
+}
+
+Test(parallel, for_each_and_map){
+    cr_assert(vectorParallelForEach(v, doubleElement, NULL, pool));
+    for (cds_uint32 i=0; i<LENGTH; i++){
+        cr_assert(2*i == *(const cds_uint32*) vectorGetAt(v, i));
+    }
+    Vector* wide = vectorCreate(1, sizeof(cds_uint64));
+    cds_uint64 offset = 1ULL << 40;
+    cr_assert(vectorParallelMap(v, wide, widen, &offset, pool));
+    cr_expect(LENGTH == vectorLength(wide));
+    for (cds_uint32 i=0; i<LENGTH; i++){
+        cr_assert(offset + 2*i == *(const cds_uint64*) vectorGetAt(wide, i));
+    }
+    vectorDelete(wide);
+}
+
+typedef struct Range{
+    cds_uint64 sum;
+    cds_uint32 first;
+    cds_uint32 last;
+    cds_bool empty;
+}Range;
+
+static void foldRange(void* acc, const void* data, void* arg){
+    (void) arg;
+    Range* r = (Range*) acc;
+    cds_uint32 x = *(const cds_uint32*) data;
+    r->sum += x;
+    if (r->empty){
+        r->first = x;
+    }
+    r->last = x;
+    r->empty = false;
+}
+
+static void combineRange(void* acc, const void* other, void* arg){
+    (void) arg;
+    Range* r = (Range*) acc;
+    const Range* o = (const Range*) other;
+    if (o->empty){
+        return;
+    }
+    if (r->empty){
+        *r = *o;
+        return;
+    }
+    r->sum += o->sum;
+    r->last = o->last;
+}
+
+static atomic_int next_thread_id;
+static _Thread_local cds_int thread_id = -1;
+
+static void markThread(void* data, const cds_size index, void* arg){
+    (void) index;
+    (void) arg;
+    if (thread_id < 0){
+        thread_id = atomic_fetch_add(&next_thread_id, 1);
+    }
+    *(cds_uint32*) data = (cds_uint32) thread_id;
+}
+
+Test(parallel, cache_lines){
+    // a large `malloc` buffer starts past the header of its mapping, off a cache line.
+    Vector* marks = vectorCreate(LENGTH, sizeof(cds_uint32));
+    for (cds_uint32 i=0; i<LENGTH; i++){
+        (void) vectorPrepend(marks, &i);
+    }
+    atomic_init(&next_thread_id, 0);
+    cr_assert(vectorParallelForEach(marks, markThread, NULL, pool));
+    const cds_uint32* data = (const cds_uint32*) vectorGetAt(marks, 0);
+    const uintptr_t mask = ~((uintptr_t) CDS_CACHE_LINE - 1);
+    for (cds_size i=1; i<LENGTH; i++){
+        if (((uintptr_t) &data[i] & mask) == ((uintptr_t) &data[i - 1] & mask)){
+            cr_assert(data[i] == data[i - 1], "A cache line should be written by a single thread.");
+        }
+    }
+    vectorDelete(marks);
+}
+
+Test(parallel, reduce){
+    Range range = {0, 0, 0, true};
+    cr_assert(vectorParallelReduce(v, &range, sizeof(Range), foldRange, combineRange, NULL, pool));
+    cr_expect((cds_uint64) LENGTH*(LENGTH - 1)/2 == range.sum);
+    cr_expect(0 == range.first && LENGTH - 1 == range.last, "Chunks should be combined in order.");
+    Vector* empty = vectorCreate(1, sizeof(cds_uint32));
+    Range identity = {0, 0, 0, true};
+    cr_assert(vectorParallelReduce(empty, &identity, sizeof(Range), foldRange, combineRange, NULL, NULL));
+    cr_expect(identity.empty);
+    vectorDelete(empty);
+}
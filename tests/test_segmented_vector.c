@@ -0,0 +1,85 @@
+/*!
+ * @file test_segmented_vector.c
+ * @author Paulo Arruda
+ * @copyright GPL v3 or later.
+ * @brief Testing the segmented vector API.
+*/
+
+#include <stdatomic.h>
+#include <string.h>
+#include <criterion/criterion.h>
+#include "../include/segmented_vector.h"
+#include "../include/linear.h"
+
+#define CHUNK_CAPACITY 100
+#define LENGTH 10000
+
+SegVector* sv = (SegVector*) NULL;
+
+void segvecSetup(void){
+    sv = segvecCreate(CHUNK_CAPACITY, sizeof(cds_size));
+    cr_assert(sv, "segvecCreate should return a not NULL segmented vector");
+}
+
+void segvecTeardown(void){
+    segvecDelete(sv);
+    sv = (SegVector*) NULL;
+}
+
+TestSuite(segvec, .init=segvecSetup, .fini=segvecTeardown);
+
+Test(segvec, segvec_basics){
+    cr_expect(128 == segvecChunkCapacity(sv), "Chunk capacity should be rounded to 128");
+    cr_expect(0 == segvecLength(sv));
+    cr_expect(0 == segvecNumChunks(sv));
+    cr_expect(!segvecGetAt(sv, 0), "Segmented vector is empty. Expected a NULL pointer.");
+    cr_expect(!segvecPopBack(sv));
+    cr_expect(!segvecCreate((cds_size) 1 << 62, sizeof(cds_size)), "The chunk bytes overflow.");
+}
+
+Test(segvec, stable_addresses){
+    cr_assert(segvecAppend(sv, &(cds_size){0}));
+    const cds_size* first = segvecGetAt(sv, 0);
+    for (cds_size i=1; i<LENGTH; i++){
+        cr_assert(segvecAppend(sv, &i));
+    }
+    cr_expect(first == segvecGetAt(sv, 0), "Appending should not move the elements.");
+    cr_expect(LENGTH == segvecLength(sv));
+    cr_expect((LENGTH + 127) / 128 == segvecNumChunks(sv));
+    for (cds_size i=0; i<LENGTH; i++){
+        cr_assert(i == *(const cds_size*) segvecGetAt(sv, i));
+    }
+    cr_expect(!segvecGetAt(sv, LENGTH));
+    cr_assert(segvecPopBack(sv));
+    cr_expect(LENGTH - 1 == segvecLength(sv));
+}
+
+Test(segvec, segvec_iterator){
+    for (cds_size i=0; i<LENGTH; i++){
+        cr_assert(segvecAppend(sv, &i));
+    }
+    cds_size i = 0;
+    for (Iter* iter=iterCreate(sv, SEG_VECTOR); iter; iter=iterNext(iter), i++){
+        cr_assert(i == *(const cds_size*) iterGetData(iter));
+    }
+    cr_expect(LENGTH == i);
+}
+
+static void sumChunk(void* chunk, const cds_size length, const cds_size first_index, void* arg){
+    cds_size sum = 0;
+    for (cds_size i=0; i<length; i++){
+        cr_assert(first_index + i == ((cds_size*) chunk)[i]);
+        sum += ((cds_size*) chunk)[i];
+    }
+    atomic_fetch_add((atomic_size_t*) arg, sum);
+}
+
+Test(segvec, parallel_for_each_chunk){
+    for (cds_size i=0; i<LENGTH; i++){
+        cr_assert(segvecAppend(sv, &i));
+    }
+    atomic_size_t sum;
+    atomic_init(&sum, 0);
+    segvecParallelForEachChunk(sv, sumChunk, &sum);
+    cr_expect(LENGTH*(LENGTH - 1)/2 == atomic_load(&sum));
+}
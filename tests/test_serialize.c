@@ -0,0 +1,269 @@
+/*!
+ * @file test_serialize.c
+ * @author Paulo Arruda
+ * @copyright GPL v3 or later.
+ * @brief Testing the serialization API.
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <criterion/criterion.h>
+#include "../include/serialize.h"
+
+#define LENGTH 100000
+#define BUFFER_SIZE 4096
+
+static cds_int openTemporary(void){
+    char path[] = "/tmp/cds_serialize_XXXXXX";
+    cds_int fd = mkstemp(path);
+    (void) unlink(path);
+    return fd;
+}
+
+TestSuite(serialize);
+
+Test(serialize, vector_fd){
+    Vector* vec = vectorCreate(LENGTH, sizeof(cds_size));
+    for (cds_size i=0; i<LENGTH; i++){
+        cr_assert(vectorPrepend(vec, &(cds_size){i}));
+    }
+    cds_int fd = openTemporary();
+    cr_assert(fd >= 0);
+    Stream* out = streamFromFd(fd);
+    cr_assert(out);
+    cr_assert(vectorWrite(vec, out));
+    Tuple* view = vectorToTupleView(vec);
+    cr_assert(tupleWrite(view, out));
+    tupleDelete(view);
+    cr_assert(streamDelete(out));
+    cr_assert(0 == lseek(fd, 0, SEEK_SET));
+    Stream* in = streamFromFd(fd);
+    Vector* read = vectorRead(in);
+    cr_assert(read);
+    cr_expect(LENGTH == vectorLength(read));
+    cr_expect(0 == memcmp(vectorToArr(vec), vectorToArr(read), LENGTH*sizeof(cds_size)));
+    Tuple* t = tupleRead(in);
+    cr_assert(t);
+    cr_expect(LENGTH == tupleLength(t));
+    cr_expect(LENGTH - 1 == *(const cds_size*) tupleGetAt(t, LENGTH - 1));
+    cr_expect(!vectorRead(in), "The stream should be at its end.");
+    tupleDelete(t);
+    vectorDelete(read);
+    (void) streamDelete(in);
+    (void) close(fd);
+    vectorDelete(vec);
+}
+
+Test(serialize, buffer_and_versions){
+    cds_uchar buffer[BUFFER_SIZE];
+    Tuple* t = tupleCreate(sizeof(cds_int), 3, &(cds_int){1}, &(cds_int){2}, &(cds_int){3});
+    Stream* out = streamFromBuffer(buffer, BUFFER_SIZE);
+    cr_assert(tupleWrite(t, out));
+    const cds_size size = streamPosition(out);
+    cr_expect(8 + 16 + 3*sizeof(cds_int) == size);
+    (void) streamDelete(out);
+    Stream* small = streamFromBuffer(buffer, 10);
+    cr_expect(!tupleWrite(t, small), "Writes should not overflow the buffer.");
+    (void) streamDelete(small);
+    (void) streamDelete(streamFromBuffer(buffer, BUFFER_SIZE));
+    Stream* in = streamFromBuffer(buffer, size);
+    Tuple* read = tupleRead(in);
+    cr_assert(read);
+    cr_expect(3 == *(const cds_int*) tupleGetAt(read, 2));
+    tupleDelete(read);
+    (void) streamDelete(in);
+    buffer[4] = CDS_SERIAL_VERSION + 1;
+    in = streamFromBuffer(buffer, size);
+    cr_expect(!tupleRead(in), "Later versions should be rejected.");
+    (void) streamDelete(in);
+    tupleDelete(t);
+}
+
+/**
+ * Overwrites the sizes of the array written at the beginning of the buffer,
+ * in the little-endian order of the headers.
+*/
+static void setSizes(cds_uchar* const buffer, const cds_uint64 data_size, const cds_uint64 length){
+    for (cds_size i=0; i<8; i++){
+        buffer[8 + i] = (cds_uchar) (data_size >> (8*i));
+        buffer[16 + i] = (cds_uchar) (length >> (8*i));
+    }
+}
+
+Test(serialize, malformed_header){
+    cds_uchar buffer[BUFFER_SIZE];
+    Vector* vec = vectorCreate(10, sizeof(cds_int));
+    for (cds_int i=0; i<10; i++){
+        cr_assert(vectorPrepend(vec, &i));
+    }
+    Stream* out = streamFromBuffer(buffer, BUFFER_SIZE);
+    cr_assert(vectorWrite(vec, out));
+    const cds_size size = streamPosition(out);
+    (void) streamDelete(out);
+    const cds_uint64 sizes[][2] = {
+        {sizeof(cds_int), 1000},                    // truncated elements
+        {sizeof(cds_int), (cds_uint64) 1 << 62},    // the bytes overflow
+        {(cds_uint64) 1 << 20, (cds_uint64) 1 << 43},   // the rounded capacity overflows
+        {0, 10},                                    // elements without bytes
+    };
+    for (cds_size i=0; i<sizeof(sizes)/sizeof(sizes[0]); i++){
+        setSizes(buffer, sizes[i][0], sizes[i][1]);
+        Stream* in = streamFromBuffer(buffer, size);
+        cr_expect(!vectorRead(in), "Corrupt sizes should be rejected.");
+        (void) streamDelete(in);
+    }
+    setSizes(buffer, sizeof(cds_int), 10);
+    Stream* in = streamFromBuffer(buffer, size);
+    Vector* read = vectorRead(in);
+    cr_assert(read);
+    cr_expect(9 == *(cds_int*) vectorGetAt(read, 9));
+    vectorDelete(read);
+    (void) streamDelete(in);
+    vectorDelete(vec);
+}
+
+Test(serialize, malformed_containers){
+    cds_uchar buffer[BUFFER_SIZE];
+    cds_int value = 1;
+    cds_intkey key = 1;
+    SLList* list = sllCreate(sizeof(cds_int));
+    cr_assert(sllAppend(list, &value));
+    HashTable* ht = htCreate(fnv1aHash, 8, STR_KEY);
+    cr_assert(htSet(ht, "foo", 3, &value, sizeof(cds_int)));
+    Set* set = setCreate(8, fnv1aHash, INT_KEY);
+    cr_assert(setInsert(set, &key, sizeof(cds_intkey)));
+    Arena* arena = arenaCreate(BUFFER_SIZE);
+    for (cds_size i=0; i<3; i++){
+        Stream* out = streamFromBuffer(buffer, BUFFER_SIZE);
+        cr_assert(0 == i ? sllWrite(list, out) : 1 == i ? htWrite(ht, out) : setWrite(set, out));
+        const cds_size size = streamPosition(out);
+        (void) streamDelete(out);
+        // the data size (or key type) is kept, the length is far beyond the stream.
+        cds_uint64 first = 0;
+        for (cds_size j=0; j<8; j++){
+            first |= (cds_uint64) buffer[8 + j] << (8*j);
+        }
+        setSizes(buffer, 0 == i ? 0 : first, (cds_uint64) 1 << 40);
+        Stream* in = streamFromBuffer(buffer, size);
+        switch (i){
+            case 0:
+                cr_expect(!sllRead(in), "Elements without bytes should be rejected.");
+                break;
+            case 1:
+                cr_expect(!htRead(in, fnv1aHash, arena), "A truncated table should be rejected.");
+                break;
+            default:
+                cr_expect(!setRead(in, fnv1aHash, arena), "A truncated set should be rejected.");
+                break;
+        }
+        (void) streamDelete(in);
+    }
+    arenaDelete(arena);
+    sllDelete(list);
+    htDelete(ht);
+    setDelete(set);
+}
+
+Test(serialize, append_from_stream){
+    cds_int fd = openTemporary();
+    cr_assert(fd >= 0);
+    for (cds_int i=0; i<LENGTH; i++){
+        cr_assert(sizeof(cds_int) == write(fd, &i, sizeof(cds_int)));
+    }
+    cr_assert(0 == lseek(fd, 0, SEEK_SET));
+    Vector* vec = vectorCreate(1, sizeof(cds_int));
+    cr_assert(vectorPrepend(vec, &(cds_int){-1}));
+    Stream* in = streamFromFd(fd);
+    cr_expect(LENGTH == vectorAppendFromStream(vec, in));
+    cr_expect(LENGTH + 1 == vectorLength(vec));
+    for (cds_int i=0; i<LENGTH; i++){
+        cr_assert(i == *(const cds_int*) vectorGetAt(vec, (cds_size) i + 1));
+    }
+    (void) streamDelete(in);
+    cr_assert(sizeof(cds_int) - 1 == write(fd, "abc", sizeof(cds_int) - 1));
+    cr_assert(lseek(fd, -(off_t) (2*sizeof(cds_int) - 1), SEEK_END) >= 0);
+    in = streamFromFd(fd);
+    cr_expect(CDS_NOT_FOUND == vectorAppendFromStream(vec, in), "Partial elements are errors.");
+    cr_expect(LENGTH + 2 == vectorLength(vec), "Whole elements should be kept.");
+    (void) streamDelete(in);
+    (void) close(fd);
+    vectorDelete(vec);
+}
+
+Test(serialize, lists_tables_and_sets){
+    cds_uchar buffer[BUFFER_SIZE];
+    cds_int values[4] = {10, 20, 30, 40};
+    cds_intkey set_keys[4] = {10, 20, 30, 40};
+    SLList* list = sllCreate(sizeof(cds_int));
+    for (cds_size i=0; i<4; i++){
+        cr_assert(sllAppend(list, &values[i]));
+    }
+    const cds_char* keys[4] = {"foo", "bar", "boo", "baa"};
+    HashTable* ht = htCreate(fnv1aHash, 8, STR_KEY);
+    Set* set = setCreate(8, fnv1aHash, INT_KEY);
+    for (cds_size i=0; i<4; i++){
+        cr_assert(htSet(ht, keys[i], 3, &values[i], sizeof(cds_int)));
+        cr_assert(setInsert(set, &set_keys[i], sizeof(cds_intkey)));
+    }
+    Stream* out = streamFromBuffer(buffer, BUFFER_SIZE);
+    cr_assert(sllWrite(list, out));
+    cr_assert(htWrite(ht, out));
+    cr_assert(setWrite(set, out));
+    const cds_size size = streamPosition(out);
+    (void) streamDelete(out);
+    sllDelete(list);
+    htDelete(ht);
+    setDelete(set);
+
+    Arena* arena = arenaCreate(BUFFER_SIZE);
+    Stream* in = streamFromBuffer(buffer, size);
+    list = sllRead(in);
+    cr_assert(list);
+    cds_int expected = 10;
+    for (Iter* iter=iterCreate(list, SLLIST); iter; iter=iterNext(iter), expected+=10){
+        cr_assert(expected == *(const cds_int*) iterGetData(iter));
+    }
+    cr_expect(50 == expected);
+    ht = htRead(in, fnv1aHash, arena);
+    cr_assert(ht);
+    cr_expect(4 == htLength(ht));
+    cr_expect(30 == *(const cds_int*) htGet(ht, "boo", (cds_size*) NULL));
+    set = setRead(in, fnv1aHash, arena);
+    cr_assert(set);
+    cr_expect(setSearch(set, &(cds_intkey){40}));
+    cr_expect(!setSearch(set, &(cds_intkey){50}));
+    cr_expect(size == streamPosition(in));
+    (void) streamDelete(in);
+    sllDelete(list);
+    htDelete(ht);
+    setDelete(set);
+    arenaDelete(arena);
+}
+
+Test(serialize, tuple_keys){
+    cds_uchar buffer[BUFFER_SIZE];
+    Tuple* keys[2] = {
+        tupleFromArray((cds_intkey[]){1, 2}, sizeof(cds_intkey), 2),
+        tupleFromArray((cds_intkey[]){3, 4}, sizeof(cds_intkey), 2),
+    };
+    cds_int values[2] = {0, 1};
+    HashTable* ht = htCreate(fnv1aHash, 8, INT_TUPLE_KEY);
+    for (cds_size i=0; i<2; i++){
+        cr_assert(htSet(ht, keys[i], sizeof(Tuple*), &values[i], sizeof(cds_int)));
+    }
+    Stream* out = streamFromBuffer(buffer, BUFFER_SIZE);
+    cr_assert(htWrite(ht, out));
+    (void) streamDelete(out);
+    htDelete(ht);
+    Arena* arena = arenaCreate(BUFFER_SIZE);
+    Stream* in = streamFromBuffer(buffer, BUFFER_SIZE);
+    ht = htRead(in, fnv1aHash, arena);
+    cr_assert(ht);
+    cr_expect(1 == *(const cds_int*) htGet(ht, keys[1], (cds_size*) NULL));
+    (void) streamDelete(in);
+    htDelete(ht);
+    arenaDelete(arena);
+    tupleDelete(keys[0]);
+    tupleDelete(keys[1]);
+}
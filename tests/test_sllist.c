@@ -0,0 +1,102 @@
+/*!
+ * @file test_sllist.c
+ * @author Paulo Arruda
+ * @copyright GPL v3 or later.
+ * @brief Testing the pool allocator and the singly linked list and queue
+ * APIs.
+*/
+
+#include <stddef.h>
+#include <criterion/criterion.h>
+#include "../include/linear.h"
+#include "../include/pool.h"
+
+#define LENGTH 10000
+
+Test(pool, reuse){
+    Pool* pool = poolCreate(3, 4);
+    cr_assert(pool);
+    cr_expect(0 == poolObjectSize(pool) % _Alignof(max_align_t), "Objects should be aligned.");
+    void* objects[10];
+    for (cds_size i=0; i<10; i++){
+        objects[i] = poolAlloc(pool);
+        cr_assert(objects[i]);
+        memset(objects[i], (int) i, 3);
+    }
+    poolFree(pool, objects[7]);
+    cr_expect(objects[7] == poolAlloc(pool), "Freed objects should be reused first.");
+    cr_expect(!poolCreate(0, 4));
+    cr_expect(!poolCreate(4, 0));
+    poolDelete(pool);
+}
+
+Test(sllist, append_prepend_pop){
+    SLList* list = sllCreate(sizeof(cds_int));
+    cr_assert(list);
+    for (cds_int i=0; i<LENGTH; i++){
+        cr_assert(i % 2 ? sllAppend(list, &i) : sllPrepend(list, &i));
+    }
+    cr_expect(LENGTH == sllLength(list));
+    cr_expect(!sllAppend(list, NULL));
+    // even values were prepended (in reverse), odd values appended (in order).
+    cds_size count = 0;
+    for (Iter* iter=iterCreate(list, SLLIST); iter; iter=iterNext(iter), count++){
+        cds_int expected = count < LENGTH/2 ? (cds_int) (LENGTH - 2 - 2*count)
+                                            : (cds_int) (2*(count - LENGTH/2) + 1);
+        cr_assert(expected == *(const cds_int*) iterGetData(iter));
+    }
+    cr_expect(LENGTH == count);
+    cds_int value;
+    cr_assert(sllPopFront(list, &value));
+    cr_expect(LENGTH - 2 == value);
+    cr_expect(LENGTH - 1 == sllLength(list));
+    while (sllPopFront(list, (void*) NULL));
+    cr_expect(0 == sllLength(list));
+    cr_expect(!sllPopFront(list, &value));
+    cr_assert(sllAppend(list, &(cds_int){42}));
+    cr_assert(sllPopFront(list, &value));
+    cr_expect(42 == value);
+    sllDelete(list);
+}
+
+Test(sllist, shared_pool){
+    Pool* pool = poolCreate(sllNodeSize(sizeof(cds_double)), 64);
+    cr_assert(pool);
+    cr_expect(!sllCreateWithPool(8*sizeof(cds_double), pool), "Small nodes should be rejected.");
+    SLList* first = sllCreateWithPool(sizeof(cds_double), pool);
+    SLList* second = sllCreateWithPool(sizeof(cds_double), pool);
+    cr_assert(first && second);
+    for (cds_size i=0; i<LENGTH; i++){
+        cr_assert(sllAppend(first, &(cds_double){(cds_double) i}));
+    }
+    sllDelete(first);
+    // the nodes of the deleted list are reused by the other one.
+    for (cds_size i=0; i<LENGTH; i++){
+        cr_assert(sllPrepend(second, &(cds_double){0.5 * (cds_double) i}));
+    }
+    cds_double value;
+    cr_assert(sllPopFront(second, &value));
+    cr_expect(0.5 * (LENGTH - 1) == value);
+    sllDelete(second);
+    poolDelete(pool);
+}
+
+Test(queue, fifo){
+    Queue* queue = queueCreate(sizeof(cds_int));
+    cr_assert(queue);
+    cds_int value;
+    for (cds_int i=0; i<LENGTH; i++){
+        cr_assert(queuePush(queue, &i));
+        // keeps the queue short so that the freed nodes are reused.
+        if (i % 3 == 2){
+            cr_assert(queuePop(queue, &value));
+        }
+    }
+    cr_expect(LENGTH - LENGTH/3 == queueLength(queue));
+    cds_int expected = LENGTH/3;
+    while (queuePop(queue, &value)){
+        cr_assert(expected++ == value);
+    }
+    cr_expect(LENGTH == expected);
+    queueDelete(queue);
+}
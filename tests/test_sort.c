@@ -0,0 +1,121 @@
+/*!
+ * @file test_sort.c
+ * @author Paulo Arruda
+ * @copyright GPL v3 or later.
+ * @brief Testing the sort API.
+*/
+
+#include <time.h>
+#include <string.h>
+#include <criterion/criterion.h>
+#include "../include/sort.h"
+
+#define LENGTH 300000
+
+static cds_int8 longOrderComp(const void* const x, const void* const y){
+    cds_long _x = *(const cds_long*) x;
+    cds_long _y = *(const cds_long*) y;
+    return (_x > _y) - (_x < _y);
+}
+
+typedef struct Pair{
+    cds_int key;
+    cds_int position;
+}Pair;
+
+static cds_int8 pairOrderComp(const void* const x, const void* const y){
+    return intOrderComp(&((const Pair*) x)->key, &((const Pair*) y)->key);
+}
+
+TestSuite(sort);
+
+Test(sort, merge_sort_is_stable){
+    Vector* vec = vectorCreate(LENGTH, sizeof(Pair));
+    cr_assert(vec);
+    srand(time(0));
+    for (cds_int i=0; i<LENGTH; i++){
+        cr_assert(vectorPrepend(vec, &(Pair){rand() % 1000, i}));
+    }
+    cr_assert(vectorSort(vec, pairOrderComp));
+    cr_expect(LENGTH == vectorLength(vec));
+    for (cds_size i=1; i<vectorLength(vec); i++){
+        const Pair* prev = vectorGetAt(vec, i-1);
+        const Pair* curr = vectorGetAt(vec, i);
+        cr_assert(prev->key < curr->key ||
+                  (prev->key == curr->key && prev->position < curr->position),
+                  "Order broken at %zu", i);
+    }
+    vectorDelete(vec);
+}
+
+Test(sort, merge_sort_small){
+    Vector* vec = vectorFromValues(sizeof(cds_long), 5, &(cds_long){3}, &(cds_long){-1},
+                                   &(cds_long){2}, &(cds_long){-7}, &(cds_long){0});
+    cr_assert(vectorSort(vec, longOrderComp));
+    cds_long expected[] = {-7, -1, 0, 2, 3};
+    for (cds_size i=0; i<5; i++){
+        cr_expect(expected[i] == *(const cds_long*) vectorGetAt(vec, i));
+    }
+    vectorDelete(vec);
+}
+
+Test(sort, radix_sort_signed){
+    Vector* vec = vectorCreate(LENGTH, sizeof(cds_int));
+    for (cds_size i=0; i<LENGTH; i++){
+        (void) vectorPrepend(vec, &(cds_int){rand() - RAND_MAX/2});
+    }
+    cr_assert(vectorSort(vec, intOrderComp));
+    for (cds_size i=1; i<LENGTH; i++){
+        cr_assert(*(const cds_int*) vectorGetAt(vec, i-1) <= *(const cds_int*) vectorGetAt(vec, i));
+    }
+    vectorDelete(vec);
+}
+
+Test(sort, radix_sort_double){
+    cds_double arr[] = {3.5, -0.25, 1e10, -1e10, 0.0, 2.0, -3.5, 7.75};
+    Vector* vec = vectorFromArray(arr, sizeof(cds_double), 8);
+    cr_assert(!vectorSortNumeric(vec, NUM_FLOAT), "The data size does not match.");
+    cr_assert(vectorSortNumeric(vec, NUM_DOUBLE));
+    cds_double expected[] = {-1e10, -3.5, -0.25, 0.0, 2.0, 3.5, 7.75, 1e10};
+    for (cds_size i=0; i<8; i++){
+        cr_expect(expected[i] == *(const cds_double*) vectorGetAt(vec, i));
+    }
+    vectorDelete(vec);
+}
+
+Test(sort, tuple_sorted){
+    cds_int8 arr[] = {5, -3, 127, -128, 0};
+    Tuple* t = tupleFromArray(arr, sizeof(cds_int8), 5);
+    Tuple* sorted = tupleSortedNumeric(t, NUM_INT8);
+    cr_assert(sorted);
+    cds_int8 expected[] = {-128, -3, 0, 5, 127};
+    for (cds_size i=0; i<5; i++){
+        cr_expect(expected[i] == *(const cds_int8*) tupleGetAt(sorted, i));
+        cr_expect(arr[i] == *(const cds_int8*) tupleGetAt(t, i), "Source should be untouched.");
+    }
+    tupleDelete(sorted);
+    tupleDelete(t);
+}
+
+Test(sort, slice_sort){
+    Vector* vec = vectorFromArray((cds_int32[]){9, 8, 7, 6, 5, 4, 3, 2, 1, 0}, sizeof(cds_int32), 10);
+    cr_assert(vec);
+    VectorSlice window = vectorSlice(vec, 2, 5);
+    cr_assert(vectorSliceSortNumeric(&window, NUM_INT32));
+    const cds_int32 expected[10] = {9, 8, 3, 4, 5, 6, 7, 2, 1, 0};
+    cr_expect(0 == memcmp(expected, vectorToArr(vec), sizeof(expected)),
+              "Only the elements of the slice should be sorted.");
+    window = vectorSlice(vec, 7, 5);
+    cr_expect(3 == window.length, "Slices should be truncated to the end of the vector.");
+    cr_assert(vectorSliceSort(&window, intOrderComp));
+    cr_expect(0 == *(const cds_int32*) vectorGetAt(vec, 7));
+    Tuple* t = vectorToTuple(vec);
+    TupleSlice head = tupleSlice(t, 0, 3);
+    Tuple* sorted = tupleSliceSorted(&head, intOrderComp);
+    cr_assert(sorted);
+    cr_expect(3 == tupleLength(sorted));
+    cr_expect(3 == *(const cds_int32*) tupleGetAt(sorted, 0));
+    tupleDelete(sorted);
+    tupleDelete(t);
+    vectorDelete(vec);
+}
@@ -0,0 +1,164 @@
+/*!
+ * @file test_spsc_ring.c
+ * @author Paulo Arruda
+ * @copyright GPL v3 or later.
+ * @brief Testing the SPSC ring buffer.
+*/
+
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <criterion/criterion.h>
+#include "../include/spsc_ring.h"
+
+#define MESSAGES 1000000
+#define BATCH 64
+
+Test(spsc_ring, single_thread){
+    cr_expect(!spscCreate(0, sizeof(cds_int)));
+    cr_expect(!spscCreate(8, 0));
+    SPSCRing* ring = spscCreate(6, sizeof(cds_int));
+    cr_assert(ring);
+    cr_expect(8 == spscCapacity(ring));
+    cds_int value;
+    cr_expect(!spscTryPop(ring, &value));
+    for (cds_int i=0; i<8; i++){
+        cr_assert(spscTryPush(ring, &i));
+    }
+    cr_expect(!spscTryPush(ring, &value), "The ring should be full.");
+    cr_expect(8 == spscLength(ring));
+    cds_int out[8];
+    cr_expect(5 == spscPopN(ring, out, 5));
+    // these elements wrap around the end of the buffer.
+    cds_int in[5] = {8, 9, 10, 11, 12};
+    cr_expect(5 == spscPushN(ring, in, 5));
+    cr_expect(0 == spscPushN(ring, in, 5));
+    cr_expect(8 == spscPopN(ring, out, 10));
+    for (cds_int i=0; i<8; i++){
+        cr_assert(i + 5 == out[i]);
+    }
+    spscDelete(ring);
+}
+
+Test(spsc_ring, reserve_and_peek){
+    SPSCRing* ring = spscCreate(16, sizeof(cds_int));
+    cr_assert(ring);
+    cds_size granted;
+    cds_int* slots = (cds_int*) spscReserve(ring, 10, &granted);
+    cr_assert(slots && 10 == granted);
+    for (cds_int i=0; i<10; i++){
+        slots[i] = i;
+    }
+    cr_expect(0 == spscLength(ring), "Reserved slots should not be visible.");
+    spscCommit(ring, 10);
+    cds_size available;
+    const cds_int* elements = (const cds_int*) spscPeek(ring, 100, &available);
+    cr_assert(elements && 10 == available);
+    cr_expect(9 == elements[9]);
+    spscRelease(ring, 10);
+    // the region stops at the end of the buffer.
+    slots = (cds_int*) spscReserve(ring, 10, &granted);
+    cr_assert(slots && 6 == granted);
+    spscCommit(ring, 6);
+    slots = (cds_int*) spscReserve(ring, 20, &granted);
+    cr_expect(slots && 10 == granted, "The rest of the free slots start the buffer.");
+    spscCommit(ring, granted);
+    cr_expect(!spscReserve(ring, 1, &granted) && 0 == granted);
+    cr_expect(spscPeek(ring, 16, &available) && 6 == available);
+    spscRelease(ring, available);
+    cr_expect(spscPeek(ring, 16, &available) && 10 == available);
+    spscRelease(ring, available);
+    cr_expect(0 == spscLength(ring));
+    cr_expect(!spscPeek(ring, 1, &available));
+    spscDelete(ring);
+}
+
+static void* produce(void* arg){
+    SPSCRing* ring = (SPSCRing*) arg;
+    cds_size batch[BATCH];
+    // alternates writing in place and copying batches in.
+    for (cds_size i=0, round=0; i<MESSAGES; round++){
+        cds_size n = MESSAGES - i < BATCH ? MESSAGES - i : BATCH;
+        if (round % 2){
+            cds_size granted;
+            cds_size* slots = (cds_size*) spscReserve(ring, n, &granted);
+            for (cds_size j=0; j<granted; j++){
+                slots[j] = ++i;
+            }
+            spscCommit(ring, granted);
+        }
+        else{
+            for (cds_size j=0; j<n; j++){
+                batch[j] = i + j + 1;
+            }
+            i += spscPushN(ring, batch, n);
+        }
+    }
+    return NULL;
+}
+
+static cds_bool consume(SPSCRing* ring, const cds_size messages){
+    cds_size expected = 1;
+    cds_size batch[BATCH];
+    while (expected <= messages){
+        cds_size popped = spscPopN(ring, batch, BATCH);
+        for (cds_size j=0; j<popped; j++){
+            if (expected++ != batch[j]){
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+Test(spsc_ring, threads){
+    SPSCRing* ring = spscCreate(1024, sizeof(cds_size));
+    cr_assert(ring);
+    pthread_t producer;
+    cr_assert(0 == pthread_create(&producer, NULL, produce, ring));
+    cr_expect(consume(ring, MESSAGES), "Messages should arrive in order.");
+    (void) pthread_join(producer, NULL);
+    spscDelete(ring);
+}
+
+Test(spsc_ring, processes){
+    SPSCRing* ring = spscCreateShared(256, sizeof(cds_size));
+    cr_assert(ring);
+    pid_t child = fork();
+    cr_assert(child >= 0);
+    if (!child){
+        for (cds_size i=1; i<=MESSAGES/10;){
+            i += spscTryPush(ring, &i);
+        }
+        _exit(0);
+    }
+    cr_expect(consume(ring, MESSAGES/10));
+    cr_assert(child == waitpid(child, NULL, 0));
+    spscDelete(ring);
+}
+
+Test(spsc_ring, file){
+    char path[] = "/tmp/cds_spsc_XXXXXX";
+    int fd = mkstemp(path);
+    cr_assert(fd >= 0);
+    cr_expect(!spscOpenFd(fd), "Empty files hold no ring.");
+    SPSCRing* ring = spscCreateFromFd(fd, 64, sizeof(cds_int));
+    cr_assert(ring);
+    cr_assert(spscPushN(ring, (cds_int[3]){1, 2, 3}, 3));
+    // another process attaches to the file and consumes the elements.
+    pid_t child = fork();
+    cr_assert(child >= 0);
+    if (!child){
+        SPSCRing* attached = spscOpenFd(fd);
+        cds_int out[3];
+        _exit(attached && 64 == spscCapacity(attached) && 3 == spscPopN(attached, out, 3) && 3 == out[2] ? 0 : 1);
+    }
+    int status;
+    cr_assert(child == waitpid(child, &status, 0));
+    cr_expect(WIFEXITED(status) && 0 == WEXITSTATUS(status));
+    cr_expect(0 == spscLength(ring), "The consumption should be visible through the file.");
+    spscDelete(ring);
+    (void) close(fd);
+    (void) unlink(path);
+}
@@ -0,0 +1,66 @@
+/*!
+ * @file test_stack.c
+ * @author Paulo Arruda
+ * @copyright GPL v3 or later.
+ * @brief Testing the stack API.
+*/
+
+#include <criterion/criterion.h>
+#include "../include/linear.h"
+
+#define LENGTH 100000
+
+Stack* stack = (Stack*) NULL;
+
+void stackSetup(void){
+    stack = stackCreate(sizeof(cds_int));
+    cr_assert(stack, "stackCreate should return a not NULL stack");
+}
+
+void stackTeardown(void){
+    stackDelete(stack);
+}
+
+TestSuite(stack, .init=stackSetup, .fini=stackTeardown);
+
+Test(stack, lifo){
+    cr_expect(!stackCreate(0));
+    cr_expect(!stackPeek(stack));
+    for (cds_int i=0; i<LENGTH; i++){
+        cr_assert(stackPush(stack, &i));
+        cr_assert(i == *(cds_int*) stackPeek(stack));
+    }
+    cr_expect(LENGTH == stackLength(stack));
+    cds_int value;
+    for (cds_int i=LENGTH-1; i>=0; i--){
+        cr_assert(stackPop(stack, &value));
+        cr_assert(i == value);
+    }
+    cr_expect(!stackPop(stack, &value));
+    cr_expect(0 == stackLength(stack));
+}
+
+Test(stack, bulk){
+    cds_int block[100], out[100];
+    for (cds_int i=0; i<100; i++){
+        block[i] = i;
+    }
+    cr_assert(stackReserve(stack, 1000));
+    for (cds_size i=0; i<10; i++){
+        cr_assert(stackPushN(stack, block, 100));
+    }
+    cr_expect(1000 == stackLength(stack));
+    cr_expect(99 == *(cds_int*) stackPeek(stack));
+    // the elements come out in push order, undoing the push.
+    cr_expect(100 == stackPopN(stack, out, 100));
+    for (cds_int i=0; i<100; i++){
+        cr_assert(i == out[i]);
+    }
+    cr_expect(30 == stackPopN(stack, (void*) NULL, 30));
+    cr_expect(69 == *(cds_int*) stackPeek(stack));
+    cr_expect(870 == stackPopN(stack, (void*) NULL, 1000), "Only the elements left should be popped.");
+    cr_expect(0 == stackPopN(stack, out, 1));
+    cr_expect(!stackPushN(stack, NULL, 1));
+    cr_expect(stackPushN(stack, block, 0));
+    cr_expect(0 == stackLength(stack));
+}
@@ -0,0 +1,106 @@
+/*!
+ * @file test_unrolled_list.c
+ * @author Paulo Arruda
+ * @copyright GPL v3 or later.
+ * @brief Testing the unrolled list API.
+*/
+
+#include <time.h>
+#include <string.h>
+#include <criterion/criterion.h>
+#include "../include/linear.h"
+#include "../include/unrolled_list.h"
+
+#define LENGTH 20000
+
+UnrolledList* list = (UnrolledList*) NULL;
+cds_int* reference = (cds_int*) NULL;
+cds_size reference_length = 0;
+
+void ullSetup(void){
+    list = ullCreate(sizeof(cds_int));
+    cr_assert(list, "ullCreate should return a not NULL list");
+    reference = (cds_int*) malloc(2*LENGTH * sizeof(cds_int));
+    cr_assert(reference);
+    reference_length = 0;
+    srand(time(0));
+}
+
+void ullTeardown(void){
+    ullDelete(list);
+    free(reference);
+}
+
+static void checkList(void){
+    cr_assert(reference_length == ullLength(list));
+    cds_size i = 0;
+    for (Iter* iter=iterCreate(list, UNROLLED_LIST); iter; iter=iterNext(iter), i++){
+        cr_assert(reference[i] == *(const cds_int*) iterGetData(iter), "Index %zu.", i);
+    }
+    cr_assert(reference_length == i);
+}
+
+TestSuite(unrolled_list, .init=ullSetup, .fini=ullTeardown);
+
+Test(unrolled_list, append_prepend){
+    cr_expect(!ullCreate(0));
+    cr_expect(!iterCreate(list, UNROLLED_LIST), "Empty lists have no iterator.");
+    // prepended values end up reversed before the appended ones.
+    for (cds_int i=0; i<LENGTH; i++){
+        cr_assert(ullPrepend(list, &i));
+        reference[LENGTH - 1 - i] = i;
+        cr_assert(ullAppend(list, &(cds_int){LENGTH + i}));
+        reference[LENGTH + i] = LENGTH + i;
+    }
+    reference_length = 2*LENGTH;
+    checkList();
+    for (cds_size i=0; i<reference_length; i+=97){
+        cr_assert(reference[i] == *(cds_int*) ullGetAt(list, i));
+    }
+    cr_expect(!ullGetAt(list, reference_length));
+    cr_expect(!ullAppend(list, NULL));
+}
+
+Test(unrolled_list, insert_remove){
+    for (cds_int i=0; i<LENGTH; i++){
+        cds_size index = (cds_size) rand() % (reference_length + 1);
+        cr_assert(ullInsert(list, index, &i));
+        memmove(reference + index + 1, reference + index, (reference_length - index) * sizeof(cds_int));
+        reference[index] = i;
+        reference_length++;
+    }
+    cr_expect(!ullInsert(list, reference_length + 1, &(cds_int){0}));
+    checkList();
+    // removes most elements, which merges and balances nodes.
+    cds_int value;
+    while (reference_length > 10){
+        cds_size index = (cds_size) rand() % reference_length;
+        cr_assert(ullRemove(list, index, &value));
+        cr_assert(reference[index] == value);
+        memmove(reference + index, reference + index + 1, (reference_length - index - 1) * sizeof(cds_int));
+        reference_length--;
+    }
+    checkList();
+    cr_expect(!ullRemove(list, reference_length, &value));
+    while (reference_length){
+        cr_assert(ullRemove(list, --reference_length, (void*) NULL));
+    }
+    cr_expect(0 == ullLength(list));
+    cr_assert(ullAppend(list, &(cds_int){7}));
+    cr_expect(7 == *(cds_int*) ullGetAt(list, 0));
+}
+
+Test(unrolled_list, large_elements){
+    typedef struct {cds_double values[40];} Large;
+    UnrolledList* large = ullCreate(sizeof(Large));
+    cr_assert(large);
+    cr_expect(ULL_MIN_NODE_CAPACITY == ullNodeCapacity(large));
+    Large element;
+    for (cds_size i=0; i<100; i++){
+        element.values[0] = (cds_double) i;
+        cr_assert(ullInsert(large, i / 2, &element));
+    }
+    cr_assert(ullRemove(large, 99, &element));
+    cr_expect(0.0 == element.values[0], "The first element is always pushed to the end.");
+    ullDelete(large);
+}
@@ -0,0 +1,100 @@
+/*!
+ * @file test_ws_deque.c
+ * @author Paulo Arruda
+ * @copyright GPL v3 or later.
+ * @brief Testing the work-stealing deque.
+*/
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <criterion/criterion.h>
+#include "../include/ws_deque.h"
+
+#define NUM_THIEVES 3
+#define NUM_ITEMS 200000
+
+static cds_size items[NUM_ITEMS];
+
+Test(ws_deque, owner){
+    WSDeque* deque = wsdequeCreate(4);
+    cr_assert(deque);
+    cr_expect(!wsdequePop(deque));
+    cr_expect(!wsdequeSteal(deque));
+    cr_expect(!wsdequePush(deque, NULL));
+    // the buffer grows past its capacity.
+    for (cds_size i=0; i<100; i++){
+        items[i] = i;
+        cr_assert(wsdequePush(deque, &items[i]));
+    }
+    cr_expect(100 == wsdequeLength(deque));
+    cr_expect(&items[0] == wsdequeSteal(deque), "Thieves should take the oldest element.");
+    cr_expect(&items[99] == wsdequePop(deque), "The owner should take the newest element.");
+    for (cds_size i=98; i>=1; i--){
+        cr_assert(&items[i] == wsdequePop(deque));
+    }
+    cr_expect(!wsdequePop(deque));
+    cr_expect(0 == wsdequeLength(deque));
+    wsdequeDelete(deque);
+}
+
+typedef struct {
+    WSDeque* deque;
+    atomic_int* taken;
+    atomic_bool* finished;
+} Shared;
+
+static void take(Shared* shared, void* item){
+    (void) atomic_fetch_add(&shared->taken[*(cds_size*) item], 1);
+}
+
+static void* steal(void* arg){
+    Shared* shared = (Shared*) arg;
+    while (!atomic_load(shared->finished) || wsdequeLength(shared->deque)){
+        void* item = wsdequeSteal(shared->deque);
+        if (item){
+            take(shared, item);
+        }
+    }
+    return NULL;
+}
+
+/**
+ * The owner pushes every item and pops one in three, racing with the thieves
+ * for the last elements: every item must be taken exactly once.
+*/
+Test(ws_deque, stealing){
+    WSDeque* deque = wsdequeCreate(16);
+    cr_assert(deque);
+    static atomic_int taken[NUM_ITEMS];
+    atomic_bool finished;
+    atomic_init(&finished, false);
+    for (cds_size i=0; i<NUM_ITEMS; i++){
+        items[i] = i;
+        atomic_init(&taken[i], 0);
+    }
+    Shared shared = {deque, taken, &finished};
+    pthread_t thieves[NUM_THIEVES];
+    for (cds_size i=0; i<NUM_THIEVES; i++){
+        cr_assert(0 == pthread_create(&thieves[i], NULL, steal, &shared));
+    }
+    for (cds_size i=0; i<NUM_ITEMS; i++){
+        cr_assert(wsdequePush(deque, &items[i]));
+        void* item;
+        if (!(i % 3) && (item = wsdequePop(deque))){
+            take(&shared, item);
+        }
+    }
+    for (void* item; (item = wsdequePop(deque)); ){
+        take(&shared, item);
+    }
+    atomic_store(&finished, true);
+    for (cds_size i=0; i<NUM_THIEVES; i++){
+        (void) pthread_join(thieves[i], NULL);
+    }
+    cds_size errors = 0;
+    for (cds_size i=0; i<NUM_ITEMS; i++){
+        errors += 1 != atomic_load(&taken[i]);
+    }
+    cr_expect(0 == errors, "Every item should be taken exactly once.");
+    wsdequeDelete(deque);
+}